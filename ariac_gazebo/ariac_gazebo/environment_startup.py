@@ -838,8 +838,10 @@ class EnvironmentStartup(Node):
             else:
                 vis = False
 
+            # Optional plugin settings, such as the lidar output_type, are read from the same entry
             params = SensorSpawnParams(
-                sensor_name, sensor_type, visualize=vis, xyz=xyz, rpy=rpy)
+                sensor_name, sensor_type, visualize=vis, xyz=xyz, rpy=rpy,
+                options=user_sensors[sensor_name])
             self.spawn_entity(params)
 
         # Spawn agv tray sensors
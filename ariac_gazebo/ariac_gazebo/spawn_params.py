@@ -35,7 +35,16 @@ class RobotSpawnParams(SpawnParams):
 
 
 class SensorSpawnParams(SpawnParams):
-    def __init__(self, name, sensor_type, visualize, xyz=[0,0,0], rpy=[0,0,0]):
+    # Plugin settings that can be given in the sensor configuration, by sensor type
+    logical_camera_options = ['publish_on_change', 'heartbeat_rate',
+                              'position_resolution', 'orientation_resolution']
+    plugin_options = {
+        'lidar': ['output_type'],
+        'basic_logical_camera': logical_camera_options,
+        'advanced_logical_camera': logical_camera_options + ['publish_delta'],
+    }
+
+    def __init__(self, name, sensor_type, visualize, xyz=[0,0,0], rpy=[0,0,0], options=None):
         file_path = os.path.join(get_package_share_directory('ariac_sensors'), 
             'models', sensor_type, 'model.sdf')
         
@@ -43,6 +52,7 @@ class SensorSpawnParams(SpawnParams):
 
         self.visualize = visualize
         self.sensor_type = sensor_type
+        self.options = options if options else {}
 
         self.modify_sdf()
     
@@ -67,6 +77,10 @@ class SensorSpawnParams(SpawnParams):
             plugin.find('camera_name').text = self.name
             plugin.find('frame_name').text = self.name + "_frame"
 
+        if self.sensor_type in self.plugin_options:
+            plugin = xml.find('model').find('link').find('sensor').find('plugin')
+            self.set_plugin_options(plugin)
+
         # scoring_sensors = ['agv_tray_sensor', 'assembly_station_sensor']
         # if self.sensor_type in scoring_sensors:
         #     plugin = xml.find('model').find('link').find('sensor').find('plugin')
@@ -75,6 +89,20 @@ class SensorSpawnParams(SpawnParams):
 
         self.xml = ET.tostring(xml, encoding="unicode")
 
+    def set_plugin_options(self, plugin):
+        for option in self.plugin_options[self.sensor_type]:
+            if option not in self.options:
+                continue
+
+            value = self.options[option]
+            if isinstance(value, bool):
+                value = str(value).lower()
+
+            element = plugin.find(option)
+            if element is None:
+                element = ET.SubElement(plugin, option)
+            element.text = str(value)
+
 
 class PartSpawnParams(SpawnParams):
     part_types = ['battery', 'pump', 'sensor', 'regulator']
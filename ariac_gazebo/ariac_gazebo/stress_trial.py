@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+
+import random
+import string
+
+import yaml
+
+PART_TYPES = ['battery', 'pump', 'regulator', 'sensor']
+PART_COLORS = ['red', 'green', 'blue', 'orange', 'purple']
+ROTATIONS = [0, 'pi/6', 'pi/4', 'pi/3', 'pi/2', 'pi']
+
+BINS = ['bin1', 'bin2', 'bin3', 'bin4', 'bin5', 'bin6', 'bin7', 'bin8']
+SLOTS_PER_BIN = 9
+
+# Assembly station and the AGVs that can reach it
+STATIONS = {'as1': [1, 2], 'as2': [1, 2], 'as3': [3, 4], 'as4': [3, 4]}
+KITTING_DESTINATIONS = ['as1', 'as2', 'as3', 'as4', 'kitting', 'warehouse']
+
+# Pose of each part type in the insert, as used by the shipped trials
+ASSEMBLED_POSES = {
+    'regulator': {'xyz': [0.175, -0.223, 0.215], 'rpy': ['pi/2', 0, '-pi/2'], 'direction': [0, 0, -1]},
+    'battery': {'xyz': [-0.15, 0.035, 0.043], 'rpy': [0, 0, 'pi/2'], 'direction': [0, 1, 0]},
+    'pump': {'xyz': [0.14, 0.0, 0.02], 'rpy': [0, 0, '-pi/2'], 'direction': [0, 0, -1]},
+    'sensor': {'xyz': [-0.1, 0.395, 0.045], 'rpy': [0, 0, '-pi/2'], 'direction': [0, -1, 0]},
+}
+
+SENSOR_TYPES = ['break_beam', 'proximity', 'laser_profiler', 'lidar', 'camera', 'logical_camera']
+ROBOTS = ['floor_robot', 'ceiling_robot']
+HUMAN_BEHAVIORS = ['antagonistic', 'indifferent', 'helpful']
+
+
+def time_condition(index, count, window):
+    # A zero time condition is read as no condition by EnvironmentStartup
+    return max(0.1, round(window * index / max(1, count), 1))
+
+
+class StressTrialGenerator:
+    """Builds trial configurations with many orders, parts and challenges.
+
+    The configurations follow the format of the trials in config/trials and
+    only use values accepted by EnvironmentStartup. The same parameters and
+    seed always give the same trial.
+    """
+
+    def __init__(self, seed=0):
+        self.rng = random.Random(seed)
+
+    def generate(self, orders=100, bin_parts=72, conveyor_parts=1000, blackouts=20,
+                 malfunctions=20, humans=1, announcement_window=300.0):
+        """Generates a trial configuration.
+
+        Args:
+            orders (int): Number of orders, split evenly between kitting, assembly and combined.
+            bin_parts (int): Number of parts in the bins, at most 72 (8 bins of 9 slots).
+            conveyor_parts (int): Number of parts spawned on the conveyor belt.
+            blackouts (int): Number of sensor blackout challenges.
+            malfunctions (int): Number of robot malfunction challenges.
+            humans (int): Number of human challenges.
+            announcement_window (float): Time over which the orders and challenges are spread in seconds.
+
+        Returns:
+            dict: Trial configuration, ready to be written with write_trial().
+        """
+        order_list = self.generate_orders(orders, announcement_window)
+        order_ids = [order['id'] for order in order_list]
+
+        challenges = []
+        challenges += self.generate_blackouts(blackouts, announcement_window, order_ids)
+        challenges += self.generate_malfunctions(malfunctions, announcement_window, order_ids)
+        challenges += self.generate_humans(humans, announcement_window)
+        challenges += self.generate_faulty_parts(order_list)
+        challenges += self.generate_dropped_parts()
+
+        return {
+            'time_limit': -1,
+            'kitting_trays': {
+                'tray_ids': self.rng.sample(range(10), 6),
+                'slots': [1, 2, 3, 4, 5, 6],
+            },
+            'parts': {
+                'bins': self.generate_bins(bin_parts),
+                'conveyor_belt': self.generate_conveyor(conveyor_parts),
+            },
+            'challenges': challenges,
+            'orders': order_list,
+        }
+
+    def random_part(self):
+        return {'type': self.rng.choice(PART_TYPES), 'color': self.rng.choice(PART_COLORS)}
+
+    def generate_bins(self, count):
+        # The bins are the only part of the environment with a fixed capacity
+        count = min(count, len(BINS) * SLOTS_PER_BIN)
+
+        bins = {}
+        for index in range(count):
+            bin_name = BINS[index // SLOTS_PER_BIN]
+            slot = index % SLOTS_PER_BIN + 1
+
+            part = self.random_part()
+            part['slots'] = [slot]
+            part['rotation'] = self.rng.choice(ROTATIONS)
+            part['flipped'] = self.rng.random() < 0.1
+            bins.setdefault(bin_name, []).append(part)
+
+        return bins
+
+    def generate_conveyor(self, count):
+        parts = []
+        remaining = count
+        while remaining > 0:
+            number = min(remaining, self.rng.randint(1, 20))
+            remaining -= number
+
+            part = self.random_part()
+            part['number'] = number
+            part['offset'] = round(self.rng.uniform(-1, 1), 2)
+            part['flipped'] = self.rng.random() < 0.1
+            part['rotation'] = self.rng.choice(ROTATIONS)
+            parts.append(part)
+
+        return {
+            'active': count > 0,
+            'spawn_rate': 1.0,
+            'order': 'random',
+            'parts_to_spawn': parts,
+        }
+
+    def generate_order_id(self, used_ids):
+        while True:
+            order_id = ''.join(self.rng.choice(string.ascii_uppercase + string.digits) for _ in range(8))
+            if order_id not in used_ids:
+                used_ids.add(order_id)
+                return order_id
+
+    def generate_announcement(self, index, count, window, previous_ids):
+        # Mostly timed announcements, with some chained on earlier submissions and part placements
+        draw = self.rng.random()
+        if previous_ids and draw < 0.15:
+            return {'submission_condition': {'order_id': self.rng.choice(previous_ids)}}
+        if draw < 0.25:
+            part = self.random_part()
+            part['agv'] = self.rng.randint(1, 4)
+            return {'part_place_condition': part}
+        return {'time_condition': time_condition(index, count, window)}
+
+    def generate_assembly_products(self):
+        products = []
+        for part_type in self.rng.sample(PART_TYPES, self.rng.randint(1, len(PART_TYPES))):
+            pose = ASSEMBLED_POSES[part_type]
+            products.append({
+                'type': part_type,
+                'color': self.rng.choice(PART_COLORS),
+                'assembled_pose': {'xyz': list(pose['xyz']), 'rpy': list(pose['rpy'])},
+                'assembly_direction': list(pose['direction']),
+            })
+        return products
+
+    def generate_orders(self, count, window):
+        used_ids = set()
+        orders = []
+
+        for index in range(count):
+            order_type = ['kitting', 'assembly', 'combined'][index % 3]
+            order = {
+                'id': self.generate_order_id(used_ids),
+                'type': order_type,
+                'announcement': self.generate_announcement(index, count, window, [o['id'] for o in orders]),
+                'priority': self.rng.random() < 0.1,
+            }
+
+            if order_type == 'kitting':
+                products = []
+                for quadrant in self.rng.sample([1, 2, 3, 4], self.rng.randint(1, 4)):
+                    part = self.random_part()
+                    part['quadrant'] = quadrant
+                    products.append(part)
+                order['kitting_task'] = {
+                    'agv_number': self.rng.randint(1, 4),
+                    'tray_id': self.rng.randint(0, 9),
+                    'destination': self.rng.choice(KITTING_DESTINATIONS),
+                    'products': products,
+                }
+            elif order_type == 'assembly':
+                station = self.rng.choice(list(STATIONS))
+                order['assembly_task'] = {
+                    'agv_number': list(STATIONS[station]),
+                    'station': station,
+                    'products': self.generate_assembly_products(),
+                }
+            else:
+                order['combined_task'] = {
+                    'station': self.rng.choice(list(STATIONS)),
+                    'products': self.generate_assembly_products(),
+                }
+
+            orders.append(order)
+
+        return orders
+
+    def generate_condition(self, index, count, window, order_ids):
+        # Challenges start close to each other so their durations overlap
+        draw = self.rng.random()
+        if order_ids and draw < 0.2:
+            return {'submission_condition': {'order_id': self.rng.choice(order_ids)}}
+        if draw < 0.3:
+            part = self.random_part()
+            part['agv'] = self.rng.randint(1, 4)
+            return {'part_place_condition': part}
+        return {'time_condition': time_condition(index, count, window)}
+
+    def generate_blackouts(self, count, window, order_ids):
+        challenges = []
+        for index in range(count):
+            challenge = {
+                'duration': round(self.rng.uniform(5.0, 30.0), 1),
+                'sensors_to_disable': self.rng.sample(SENSOR_TYPES, self.rng.randint(1, len(SENSOR_TYPES))),
+            }
+            challenge.update(self.generate_condition(index, count, window, order_ids))
+            challenges.append({'sensor_blackout': challenge})
+        return challenges
+
+    def generate_malfunctions(self, count, window, order_ids):
+        challenges = []
+        for index in range(count):
+            challenge = {
+                'duration': round(self.rng.uniform(5.0, 30.0), 1),
+                'robots_to_disable': self.rng.sample(ROBOTS, self.rng.randint(1, len(ROBOTS))),
+            }
+            challenge.update(self.generate_condition(index, count, window, order_ids))
+            challenges.append({'robot_malfunction': challenge})
+        return challenges
+
+    def generate_humans(self, count, window):
+        challenges = []
+        for index in range(count):
+            challenges.append({'human': {
+                'behavior': self.rng.choice(HUMAN_BEHAVIORS),
+                'time_condition': time_condition(index, count, window),
+            }})
+        return challenges
+
+    def generate_faulty_parts(self, orders):
+        challenges = []
+        for order in orders:
+            if order['type'] != 'kitting' or self.rng.random() >= 0.3:
+                continue
+
+            challenge = {'order_id': order['id']}
+            for product in order['kitting_task']['products']:
+                challenge['quadrant' + str(product['quadrant'])] = True
+            challenges.append({'faulty_part': challenge})
+        return challenges
+
+    def generate_dropped_parts(self):
+        challenges = []
+        for robot in ROBOTS:
+            part = self.random_part()
+            part['robot'] = robot
+            part['drop_after'] = self.rng.randint(0, 3)
+            part['delay'] = round(self.rng.uniform(0.5, 3.0), 1)
+            challenges.append({'dropped_part': part})
+        return challenges
+
+
+def count_trial_content(trial):
+    """Counts what a trial configuration holds.
+
+    Args:
+        trial (dict): Trial configuration as read from a trial file.
+
+    Returns:
+        dict: Number of orders, bin parts, conveyor parts and challenges.
+    """
+    parts = trial.get('parts') or {}
+    bins = parts.get('bins') or {}
+    conveyor = parts.get('conveyor_belt') or {}
+
+    return {
+        'orders': len(trial.get('orders') or []),
+        'bin_parts': sum(len(part.get('slots', [])) for bin_parts in bins.values() for part in bin_parts),
+        'conveyor_parts': sum(part.get('number', 0) for part in conveyor.get('parts_to_spawn') or []),
+        'challenges': len(trial.get('challenges') or []),
+    }
+
+
+def write_trial(path, trial, description=''):
+    """Writes a trial configuration in the format of the files in config/trials.
+
+    Args:
+        path (str): Path of the trial file.
+        trial (dict): Trial configuration.
+        description (str): Comment written at the top of the file.
+    """
+    with open(path, 'w') as stream:
+        stream.write('# Trial Name: ' + path.split('/')[-1] + '\n')
+        stream.write('# ARIAC2023\n')
+        if description:
+            stream.write('# ' + description + '\n')
+        stream.write('\n')
+        yaml.safe_dump(trial, stream, sort_keys=False, default_flow_style=None)
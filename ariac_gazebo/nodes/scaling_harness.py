@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+
+import argparse
+import csv
+import os
+import signal
+import subprocess
+import time
+
+import rclpy
+from rclpy.node import Node
+from rclpy.qos import qos_profile_sensor_data
+
+from ament_index_python.packages import get_package_share_directory
+from ariac_msgs.msg import CompetitionState
+from diagnostic_msgs.msg import DiagnosticArray
+from rosgraph_msgs.msg import Clock
+from std_srvs.srv import Trigger
+
+from ariac_gazebo.stress_trial import (
+    StressTrialGenerator,
+    count_trial_content,
+    write_trial)
+
+TICK_TIMING_NAME = 'ariac_timing: TaskManagerPlugin/OnUpdate'
+
+# Scale factors applied to the base counts of each generated trial
+DEFAULT_SCALES = [0.1, 0.25, 0.5, 1.0]
+
+
+class ScalingMonitor(Node):
+    """Follows a running trial and records startup time, real time factor and tick cost."""
+
+    def __init__(self):
+        super().__init__('scaling_harness')
+
+        self.competition_state = None
+        self.clock_samples = []
+        self.tick_windows = []
+        self.recording = False
+
+        self.create_subscription(CompetitionState, '/ariac/competition_state',
+                                 self.competition_state_cb, 10)
+        self.create_subscription(Clock, '/clock', self.clock_cb, qos_profile_sensor_data)
+        self.create_subscription(DiagnosticArray, '/diagnostics', self.diagnostics_cb, 10)
+
+        self.start_client = self.create_client(Trigger, '/ariac/start_competition')
+
+    def reset(self):
+        self.competition_state = None
+        self.clock_samples = []
+        self.tick_windows = []
+        self.recording = False
+
+    def competition_state_cb(self, msg: CompetitionState):
+        self.competition_state = msg.competition_state
+
+    def clock_cb(self, msg: Clock):
+        if self.recording:
+            sim_time = msg.clock.sec + msg.clock.nanosec * 1e-9
+            self.clock_samples.append((time.monotonic(), sim_time))
+
+    def diagnostics_cb(self, msg: DiagnosticArray):
+        if not self.recording:
+            return
+
+        for status in msg.status:
+            if status.name != TICK_TIMING_NAME:
+                continue
+            values = {kv.key: kv.value for kv in status.values}
+            if int(values.get('count', 0)) > 0:
+                self.tick_windows.append((int(values['count']), float(values['p50_us']),
+                                          float(values['p99_us']), float(values['max_us'])))
+
+    def spin_for(self, duration):
+        end = time.monotonic() + duration
+        while rclpy.ok() and time.monotonic() < end:
+            rclpy.spin_once(self, timeout_sec=0.1)
+
+    def wait_for_ready(self, timeout):
+        """Waits for the competition to be ready.
+
+        Args:
+            timeout (float): Maximum wait in seconds.
+
+        Returns:
+            bool: True if the competition became ready before the timeout.
+        """
+        end = time.monotonic() + timeout
+        while rclpy.ok() and time.monotonic() < end:
+            rclpy.spin_once(self, timeout_sec=0.1)
+            if self.competition_state is not None and self.competition_state >= CompetitionState.READY:
+                return True
+        return False
+
+    def start_competition(self, timeout):
+        if not self.start_client.wait_for_service(timeout_sec=timeout):
+            return False
+
+        future = self.start_client.call_async(Trigger.Request())
+        rclpy.spin_until_future_complete(self, future, timeout_sec=timeout)
+        return future.done() and future.result().success
+
+    def real_time_factor(self):
+        if len(self.clock_samples) < 2:
+            return float('nan')
+
+        wall_start, sim_start = self.clock_samples[0]
+        wall_end, sim_end = self.clock_samples[-1]
+        if wall_end <= wall_start:
+            return float('nan')
+        return (sim_end - sim_start) / (wall_end - wall_start)
+
+    def tick_cost(self):
+        """Combines the one second timing windows published on /diagnostics.
+
+        Returns:
+            tuple: Count weighted p50, worst p99 and worst max tick cost in microseconds.
+        """
+        if not self.tick_windows:
+            return float('nan'), float('nan'), float('nan')
+
+        total = sum(window[0] for window in self.tick_windows)
+        p50 = sum(window[0] * window[1] for window in self.tick_windows) / total
+        p99 = max(window[2] for window in self.tick_windows)
+        worst = max(window[3] for window in self.tick_windows)
+        return p50, p99, worst
+
+
+def run_trial(monitor, trial_name, args):
+    """Launches a trial and measures it.
+
+    Args:
+        monitor (ScalingMonitor): Node used to follow the trial.
+        trial_name (str): Name of a trial in the installed config/trials.
+        args (argparse.Namespace): Harness options.
+
+    Returns:
+        dict: Measurements of the trial, with NaN for the ones that could not be taken.
+    """
+    monitor.reset()
+
+    command = ['ros2', 'launch', 'ariac_gazebo', 'ariac.launch.py', f'trial_name:={trial_name}']
+
+    log = open(os.path.join(args.output_dir, trial_name + '.log'), 'w')
+    launch_time = time.monotonic()
+    # A new session lets the whole launch process group be stopped at once
+    process = subprocess.Popen(command, stdout=log, stderr=subprocess.STDOUT, start_new_session=True)
+
+    result = {'startup_s': float('nan'), 'rtf': float('nan'),
+              'tick_p50_us': float('nan'), 'tick_p99_us': float('nan'), 'tick_max_us': float('nan')}
+
+    try:
+        if not monitor.wait_for_ready(args.startup_timeout):
+            monitor.get_logger().error(f'{trial_name} did not become ready in {args.startup_timeout} s')
+            return result
+        result['startup_s'] = time.monotonic() - launch_time
+
+        if not monitor.start_competition(args.startup_timeout):
+            monitor.get_logger().error(f'Unable to start the competition for {trial_name}')
+            return result
+
+        # Skip the burst of announcements and spawns that follows the start
+        monitor.spin_for(args.warmup)
+        monitor.recording = True
+        monitor.spin_for(args.duration)
+        monitor.recording = False
+
+        result['rtf'] = monitor.real_time_factor()
+        result['tick_p50_us'], result['tick_p99_us'], result['tick_max_us'] = monitor.tick_cost()
+        return result
+    finally:
+        try:
+            os.killpg(process.pid, signal.SIGINT)
+            process.wait(timeout=30)
+        except subprocess.TimeoutExpired:
+            os.killpg(process.pid, signal.SIGKILL)
+            process.wait()
+        except ProcessLookupError:
+            pass
+        log.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Run generated stress trials of growing size and record how the simulation scales')
+    parser.add_argument('--orders', type=int, default=300)
+    parser.add_argument('--bin-parts', type=int, default=72)
+    parser.add_argument('--conveyor-parts', type=int, default=2000)
+    parser.add_argument('--blackouts', type=int, default=50)
+    parser.add_argument('--malfunctions', type=int, default=50)
+    parser.add_argument('--humans', type=int, default=3)
+    parser.add_argument('--window', type=float, default=300.0)
+    parser.add_argument('--scales', type=float, nargs='+', default=DEFAULT_SCALES,
+                        help='factors applied to the counts above, one trial per factor')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--duration', type=float, default=60.0, help='measurement window in seconds')
+    parser.add_argument('--warmup', type=float, default=10.0)
+    parser.add_argument('--startup-timeout', type=float, default=300.0)
+    parser.add_argument('--output-dir', default='scaling_results')
+    args = parser.parse_args()
+
+    os.makedirs(args.output_dir, exist_ok=True)
+    trials_dir = os.path.join(get_package_share_directory('ariac_gazebo'), 'config', 'trials')
+
+    rclpy.init()
+    monitor = ScalingMonitor()
+
+    csv_path = os.path.join(args.output_dir, 'scaling.csv')
+    fields = ['trial', 'orders', 'bin_parts', 'conveyor_parts', 'challenges',
+              'startup_s', 'rtf', 'tick_p50_us', 'tick_p99_us', 'tick_max_us']
+
+    with open(csv_path, 'w', newline='') as stream:
+        writer = csv.DictWriter(stream, fieldnames=fields)
+        writer.writeheader()
+
+        for scale in args.scales:
+            trial_name = f'stress_{int(scale * 100):03d}'
+            trial = StressTrialGenerator(args.seed).generate(
+                orders=max(1, int(args.orders * scale)),
+                bin_parts=int(args.bin_parts * scale),
+                conveyor_parts=int(args.conveyor_parts * scale),
+                blackouts=int(args.blackouts * scale),
+                malfunctions=int(args.malfunctions * scale),
+                humans=int(args.humans * scale),
+                announcement_window=args.window)
+            write_trial(os.path.join(trials_dir, trial_name + '.yaml'), trial,
+                        f'Generated by scaling_harness.py at scale {scale}')
+
+            monitor.get_logger().info(f'Running {trial_name}')
+            row = {'trial': trial_name}
+            row.update(count_trial_content(trial))
+            row.update(run_trial(monitor, trial_name, args))
+            writer.writerow(row)
+            stream.flush()
+
+            monitor.get_logger().info(
+                f'{trial_name}: startup {row["startup_s"]:.1f} s, rtf {row["rtf"]:.2f}, '
+                f'tick p50 {row["tick_p50_us"]:.1f} us, p99 {row["tick_p99_us"]:.1f} us')
+
+    monitor.destroy_node()
+    rclpy.shutdown()
+
+
+if __name__ == '__main__':
+    main()
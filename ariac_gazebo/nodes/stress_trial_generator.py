@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+
+import argparse
+import os
+
+from ament_index_python.packages import get_package_share_directory
+
+from ariac_gazebo.stress_trial import (
+    StressTrialGenerator,
+    count_trial_content,
+    write_trial)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Generate a trial configuration with many orders, parts and challenges')
+    parser.add_argument('--name', default='stress', help='trial name, used as file name')
+    parser.add_argument('--orders', type=int, default=300)
+    parser.add_argument('--bin-parts', type=int, default=72)
+    parser.add_argument('--conveyor-parts', type=int, default=2000)
+    parser.add_argument('--blackouts', type=int, default=50)
+    parser.add_argument('--malfunctions', type=int, default=50)
+    parser.add_argument('--humans', type=int, default=3)
+    parser.add_argument('--window', type=float, default=300.0,
+                        help='time over which orders and challenges are announced in seconds')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--output-dir', default=None,
+                        help='directory of the trial file, defaults to the installed config/trials')
+    args = parser.parse_args()
+
+    output_dir = args.output_dir
+    if output_dir is None:
+        # ariac.launch.py only looks for trials in the share directory
+        output_dir = os.path.join(get_package_share_directory('ariac_gazebo'), 'config', 'trials')
+
+    trial = StressTrialGenerator(args.seed).generate(
+        orders=args.orders,
+        bin_parts=args.bin_parts,
+        conveyor_parts=args.conveyor_parts,
+        blackouts=args.blackouts,
+        malfunctions=args.malfunctions,
+        humans=args.humans,
+        announcement_window=args.window)
+
+    path = os.path.join(output_dir, args.name + '.yaml')
+    write_trial(path, trial, f'Generated by stress_trial_generator.py with seed {args.seed}')
+
+    counts = count_trial_content(trial)
+    if counts['bin_parts'] < args.bin_parts:
+        print(f'Bins hold at most {counts["bin_parts"]} parts, the remaining bin parts were dropped')
+    print(f'Wrote {path}: ' + ', '.join(f'{key} {value}' for key, value in counts.items()))
+
+
+if __name__ == '__main__':
+    main()
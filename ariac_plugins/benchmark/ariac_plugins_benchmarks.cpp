@@ -0,0 +1,346 @@
+// Benchmarks of the task manager hot paths as the trial grows: parsing the
+// AGV tray and assembly station images, scoring submitted orders and
+// processing the timed, part placement and submission triggers.
+//
+// Images hold 0 to 200 models and trials 1 to 256 orders, all generated
+// from a fixed seed so runs are comparable.
+//
+// Usage: ariac_plugins_benchmarks --benchmark_format=json --benchmark_out=<file>.json
+
+#include <ariac_plugins/ariac_common.hpp>
+#include <ariac_plugins/ariac_scoring.hpp>
+#include <ariac_plugins/model_name_classifier.hpp>
+#include <ariac_plugins/sensed_models.hpp>
+#include <ariac_plugins/task_manager_plugin.hpp>
+
+#include <ariac_msgs/msg/agv_status.hpp>
+#include <ariac_msgs/msg/faulty_part_challenge.hpp>
+#include <ariac_msgs/msg/kitting_task.hpp>
+#include <ariac_msgs/msg/order.hpp>
+#include <ariac_msgs/msg/part.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char *kTypes[] = {"battery", "pump", "regulator", "sensor"};
+    const char *kColors[] = {"red", "green", "blue", "orange", "purple"};
+
+    //==============================================================================
+    // Logical camera image of a kit tray or an assembly insert with _parts parts around it
+    gazebo::msgs::LogicalCameraImage MakeImage(int _parts, const std::string &_container)
+    {
+        std::mt19937 rng(_parts);
+        std::uniform_real_distribution<double> offset(-0.15, 0.15);
+
+        gazebo::msgs::LogicalCameraImage image;
+        gazebo::msgs::Set(image.mutable_pose(), ignition::math::Pose3d(0, 0, 1, 0, 0, 0));
+
+        auto container = image.add_model();
+        container->set_name(_container);
+        gazebo::msgs::Set(container->mutable_pose(), ignition::math::Pose3d(0, 0, 0.5, 0, 0, 0));
+
+        for (int i = 0; i < _parts; i++)
+        {
+            auto model = image.add_model();
+            model->set_name(std::string(kTypes[i % 4]) + "_" + kColors[i % 5] + "_" + std::to_string(100 + i));
+            gazebo::msgs::Set(model->mutable_pose(),
+                              ignition::math::Pose3d(offset(rng), offset(rng), 0.52, 0, 0, offset(rng)));
+        }
+        return image;
+    }
+
+    //==============================================================================
+    ariac_common::Part MakePart(int _index)
+    {
+        return ariac_common::Part(_index % 5, 10 + _index % 4);
+    }
+
+    //==============================================================================
+    ariac_common::KittingTask MakeKittingTask()
+    {
+        std::vector<ariac_common::KittingPart> products;
+        for (unsigned int quadrant = 1; quadrant <= 4; quadrant++)
+            products.emplace_back(quadrant, MakePart(quadrant));
+        return ariac_common::KittingTask(1, 3, ariac_msgs::msg::KittingTask::WAREHOUSE, products);
+    }
+
+    //==============================================================================
+    std::vector<ariac_common::AssemblyPart> MakeAssemblyProducts()
+    {
+        std::vector<ariac_common::AssemblyPart> products;
+        for (int i = 0; i < 4; i++)
+            products.emplace_back(MakePart(i), ignition::math::Pose3d(0.05 * i, 0, 0.01, 0, 0, 0),
+                                  ignition::math::Vector3d(0, 0, -1));
+        return products;
+    }
+
+    //==============================================================================
+    // Trial with _orders kitting orders, each holding the score of a full tray
+    std::vector<std::shared_ptr<ariac_common::Order>> MakeScoredOrders(int _orders)
+    {
+        auto task = MakeKittingTask();
+        auto shipment = ariac_scoring::ParseKittingShipment(
+            ariac_plugins::ToSensedModels(MakeImage(4, "kit_tray_03_0")));
+
+        std::vector<std::shared_ptr<ariac_common::Order>> orders;
+        for (int i = 0; i < _orders; i++)
+        {
+            auto id = "ORDER" + std::to_string(i);
+            auto order = std::make_shared<ariac_common::Order>(id, ariac_msgs::msg::Order::KITTING, false, -1);
+            order->SetKittingTask(std::make_shared<ariac_common::KittingTask>(task));
+            order->SetKittingScore(ariac_scoring::ScoreKittingTask(
+                id, task, shipment, ariac_msgs::msg::AGVStatus::WAREHOUSE, {false, false, false, false}));
+            orders.push_back(order);
+        }
+        return orders;
+    }
+
+    //==============================================================================
+    void ToSensedModels(benchmark::State &_state)
+    {
+        auto image = MakeImage(_state.range(0), "kit_tray_03_0");
+        for (auto _ : _state)
+            benchmark::DoNotOptimize(ariac_plugins::ToSensedModels(image));
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ToSensedModels)->DenseRange(0, 200, 50)->Complexity();
+
+    //==============================================================================
+    // Same steps as TaskManagerPluginPrivate::ParseAGVTraySensorImage
+    void ParseAGVTraySensorImage(benchmark::State &_state)
+    {
+        auto image = MakeImage(_state.range(0), "kit_tray_03_0");
+        for (auto _ : _state)
+            benchmark::DoNotOptimize(ariac_scoring::ParseKittingShipment(ariac_plugins::ToSensedModels(image)));
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ParseAGVTraySensorImage)->DenseRange(0, 200, 50)->Complexity();
+
+    //==============================================================================
+    // Same steps as TaskManagerPluginPrivate::ParseAssemblyStationImage
+    void ParseAssemblyStationImage(benchmark::State &_state)
+    {
+        auto image = MakeImage(_state.range(0), "assembly_insert_1");
+        for (auto _ : _state)
+            benchmark::DoNotOptimize(ariac_scoring::ParseAssemblyShipment(ariac_plugins::ToSensedModels(image)));
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ParseAssemblyStationImage)->DenseRange(0, 200, 50)->Complexity();
+
+    //==============================================================================
+    // Name classification done for every model by TaskManagerPluginPrivate::StoreAGVParts
+    void ClassifyTrayModels(benchmark::State &_state)
+    {
+        auto image = MakeImage(_state.range(0), "kit_tray_03_0");
+        for (auto _ : _state)
+        {
+            for (int i = 0; i < image.model_size(); i++)
+                benchmark::DoNotOptimize(ariac_common::ClassifyModelName(image.model(i).name()));
+        }
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ClassifyTrayModels)->DenseRange(0, 200, 50)->Complexity();
+
+    //==============================================================================
+    void ScoreKittingTask(benchmark::State &_state)
+    {
+        auto task = MakeKittingTask();
+        auto shipment = ariac_scoring::ParseKittingShipment(
+            ariac_plugins::ToSensedModels(MakeImage(_state.range(0), "kit_tray_03_0")));
+        for (auto _ : _state)
+            benchmark::DoNotOptimize(ariac_scoring::ScoreKittingTask(
+                "ORDER", task, shipment, ariac_msgs::msg::AGVStatus::WAREHOUSE, {false, true, false, false}));
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ScoreKittingTask)->DenseRange(0, 200, 50)->Complexity();
+
+    //==============================================================================
+    void FindFaultyParts(benchmark::State &_state)
+    {
+        ariac_msgs::msg::FaultyPartChallenge msg;
+        msg.order_id = "ORDER";
+        msg.quadrant2 = true;
+        msg.quadrant4 = true;
+
+        auto task = MakeKittingTask();
+        auto shipment = ariac_scoring::ParseKittingShipment(
+            ariac_plugins::ToSensedModels(MakeImage(_state.range(0), "kit_tray_03_0")));
+        std::vector<std::pair<int, std::string>> newly_faulty;
+        for (auto _ : _state)
+        {
+            // A new challenge each time, so the quadrants are checked for the first time as on a submission
+            ariac_common::FaultyPartChallenge challenge(msg);
+            newly_faulty.clear();
+            benchmark::DoNotOptimize(ariac_scoring::FindFaultyParts(challenge, task, shipment, newly_faulty));
+        }
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(FindFaultyParts)->DenseRange(0, 200, 50)->Complexity();
+
+    //==============================================================================
+    void ScoreAssemblyTask(benchmark::State &_state)
+    {
+        ariac_common::AssemblyTask task({1, 2}, 1, MakeAssemblyProducts());
+        auto shipment = ariac_scoring::ParseAssemblyShipment(
+            ariac_plugins::ToSensedModels(MakeImage(_state.range(0), "assembly_insert_1")));
+        for (auto _ : _state)
+            benchmark::DoNotOptimize(ariac_scoring::ScoreAssemblyTask("ORDER", task, shipment));
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ScoreAssemblyTask)->DenseRange(0, 200, 50)->Complexity();
+
+    //==============================================================================
+    void ScoreCombinedTask(benchmark::State &_state)
+    {
+        ariac_common::CombinedTask task(1, MakeAssemblyProducts());
+        auto shipment = ariac_scoring::ParseAssemblyShipment(
+            ariac_plugins::ToSensedModels(MakeImage(_state.range(0), "assembly_insert_1")));
+        for (auto _ : _state)
+            benchmark::DoNotOptimize(ariac_scoring::ScoreCombinedTask("ORDER", task, shipment));
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ScoreCombinedTask)->DenseRange(0, 200, 50)->Complexity();
+
+    //==============================================================================
+    void ComputeTrialScore(benchmark::State &_state)
+    {
+        auto orders = MakeScoredOrders(_state.range(0));
+        for (auto _ : _state)
+            benchmark::DoNotOptimize(ariac_scoring::ComputeTrialScore(orders));
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ComputeTrialScore)->RangeMultiplier(4)->Range(1, 256)->Complexity();
+
+    //==============================================================================
+    // Snapshot written at the end of a trial, then read back by ariac_batch_scorer
+    void WriteReadSubmissions(benchmark::State &_state)
+    {
+        auto task = std::make_shared<ariac_common::KittingTask>(MakeKittingTask());
+        auto shipment = std::make_shared<ariac_common::KittingShipment>(ariac_scoring::ParseKittingShipment(
+            ariac_plugins::ToSensedModels(MakeImage(4, "kit_tray_03_0"))));
+
+        std::vector<ariac_scoring::Submission> submissions(_state.range(0));
+        for (std::size_t i = 0; i < submissions.size(); i++)
+        {
+            submissions[i].order_id = "ORDER" + std::to_string(i);
+            submissions[i].type = ariac_msgs::msg::Order::KITTING;
+            submissions[i].kitting_task = task;
+            submissions[i].agv_location = ariac_msgs::msg::AGVStatus::WAREHOUSE;
+            submissions[i].kitting_shipment = shipment;
+        }
+
+        for (auto _ : _state)
+        {
+            std::stringstream snapshot;
+            ariac_scoring::WriteSubmissions(snapshot, submissions);
+            std::vector<ariac_scoring::Submission> read;
+            std::string error;
+            benchmark::DoNotOptimize(ariac_scoring::ReadSubmissions(snapshot, read, error));
+        }
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(WriteReadSubmissions)->RangeMultiplier(4)->Range(1, 256)->Complexity();
+
+    //==============================================================================
+    // One due event per update while range(0) events are waiting for a later time
+    void ProcessTimedEvents(benchmark::State &_state)
+    {
+        ariac_plugins::TaskManagerPlugin task_manager;
+        for (int i = 0; i < _state.range(0); i++)
+            task_manager.ScheduleTimedEvent(1000.0 + i, []() {});
+
+        int fired = 0;
+        for (auto _ : _state)
+        {
+            task_manager.ScheduleTimedEvent(0.0, [&fired]() { fired++; });
+            task_manager.ProcessTimedEvents();
+        }
+        benchmark::DoNotOptimize(fired);
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ProcessTimedEvents)->RangeMultiplier(4)->Range(1, 256)->Complexity();
+
+    //==============================================================================
+    // Trigger i waits for part i on AGV TriggerAGV(i), which gives 80 distinct AGV, type and color
+    // combinations. Triggers i and j wait for the same placement when i % 80 == j % 80.
+    unsigned int TriggerAGV(int _index)
+    {
+        return 1 + (_index / 20) % 4;
+    }
+
+    //==============================================================================
+    // One part placed on an AGV per update while range(0) triggers are waiting.
+    // The triggers fired by the placement are added back, so the number waiting stays the same.
+    void ProcessPartPlacementTriggers(benchmark::State &_state)
+    {
+        const int triggers = _state.range(0);
+        ariac_plugins::TaskManagerPlugin task_manager;
+
+        int fired = 0;
+        auto add_trigger = [&task_manager, &fired](int _index)
+        {
+            task_manager.AddPartPlacementTrigger(TriggerAGV(_index), std::make_shared<ariac_common::Part>(MakePart(_index)),
+                                                 [&fired]() { fired++; });
+        };
+        for (int i = 0; i < triggers; i++)
+            add_trigger(i);
+
+        const std::vector<ariac_common::Part> previous_parts;
+        std::vector<std::vector<ariac_common::Part>> placed_parts;
+        for (int i = 0; i < triggers && i < 80; i++)
+            placed_parts.push_back({MakePart(i)});
+
+        int next = 0;
+        for (auto _ : _state)
+        {
+            int index = next++ % static_cast<int>(placed_parts.size());
+            task_manager.QueueAddedAGVParts(TriggerAGV(index), previous_parts, placed_parts[index]);
+            task_manager.ProcessPartPlacementTriggers();
+
+            for (int i = index; i < triggers; i += 80)
+                add_trigger(i);
+        }
+        benchmark::DoNotOptimize(fired);
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ProcessPartPlacementTriggers)->RangeMultiplier(4)->Range(1, 256)->Complexity();
+
+    //==============================================================================
+    // One order submitted per update while range(0) submission triggers are waiting.
+    // The fired trigger is added back, so the number waiting stays the same.
+    void ProcessSubmissionTriggers(benchmark::State &_state)
+    {
+        const int triggers = _state.range(0);
+        ariac_plugins::TaskManagerPlugin task_manager;
+
+        std::vector<std::string> order_ids;
+        for (int i = 0; i < triggers; i++)
+            order_ids.push_back("ORDER" + std::to_string(i));
+
+        int fired = 0;
+        for (const auto &order_id : order_ids)
+            task_manager.AddSubmissionTrigger(order_id, [&fired]() { fired++; });
+
+        int next = 0;
+        for (auto _ : _state)
+        {
+            const auto &order_id = order_ids[next++ % triggers];
+            task_manager.QueueSubmissionTriggers(order_id);
+            task_manager.ProcessSubmissionTriggers();
+            task_manager.AddSubmissionTrigger(order_id, [&fired]() { fired++; });
+        }
+        benchmark::DoNotOptimize(fired);
+        _state.SetComplexityN(_state.range(0));
+    }
+    BENCHMARK(ProcessSubmissionTriggers)->RangeMultiplier(4)->Range(1, 256)->Complexity();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -10,6 +10,7 @@ Distributions of NIST software should also include copyright and licensing state
 #define ARIAC_PLUGINS__ARIAC_COMMON_HPP_
 
 // C++
+#include <iostream>
 #include <ostream>
 #include <map>
 #include <string>
@@ -17,8 +18,7 @@ Distributions of NIST software should also include copyright and licensing state
 #include <memory>
 // ROS
 #include <geometry_msgs/msg/pose.hpp>
-// Gazebo
-#include <gazebo/gazebo.hh>
+// Ignition
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
 // KDL and TF2
@@ -2319,7 +2319,7 @@ namespace ariac_common
          * @return true  If the part is of the correct type
          * @return false  If the part is not of the correct type
          */
-        bool isCorrectType(unsigned int type) { return type == part_.GetType(); }
+        bool isCorrectType(unsigned int type) const { return type == part_.GetType(); }
         /**
          * @brief Whether the part is of the correct color
          *
@@ -2327,7 +2327,7 @@ namespace ariac_common
          * @return true  If the part is of the correct color
          * @return false  If the part is not of the correct color
          */
-        bool isCorrectColor(unsigned int color) { return color == part_.GetColor(); }
+        bool isCorrectColor(unsigned int color) const { return color == part_.GetColor(); }
 
     private:
         //! The part object
@@ -2379,6 +2379,12 @@ namespace ariac_common
          * @return std::string Model name
          */
         std::string GetModelName() const { return model_name_; }
+        /**
+         * @brief Get the Pose On Tray
+         *
+         * @return geometry_msgs::msg::Pose Pose on the tray
+         */
+        geometry_msgs::msg::Pose GetPoseOnTray() const { return pose_on_tray_; }
 
         /**
          * @brief Whether the part is of the correct type
@@ -2387,7 +2393,7 @@ namespace ariac_common
          * @return true  If the part is of the correct type
          * @return false  If the part is not of the correct type
          */
-        bool isCorrectType(unsigned int type) { return type == part_.GetType(); }
+        bool isCorrectType(unsigned int type) const { return type == part_.GetType(); }
         /**
          * @brief Whether the part is of the correct color
          *
@@ -2395,21 +2401,21 @@ namespace ariac_common
          * @return true  If the part is of the correct color
          * @return false  If the part is not of the correct color
          */
-        bool isCorrectColor(unsigned int color) { return color == part_.GetColor(); }
+        bool isCorrectColor(unsigned int color) const { return color == part_.GetColor(); }
         /**
          * @brief Whether the part is faulty
          *
          * @return true  If the part is faulty
          * @return false  If the part is not faulty
          */
-        bool isFaulty() { return model_name_.find("faulty") != std::string::npos; }
+        bool isFaulty() const { return model_name_.find("faulty") != std::string::npos; }
         /**
          * @brief Whether the part is flipped
          *
          * @return true  If the part is flipped
          * @return false  If the part is not flipped
          */
-        bool isFlipped()
+        bool isFlipped() const
         {
             KDL::Frame part_on_tray;
             tf2::fromMsg(pose_on_tray_, part_on_tray);
@@ -0,0 +1,197 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__ARIAC_SCORING_HPP_
+#define ARIAC_PLUGINS__ARIAC_SCORING_HPP_
+
+// C++
+#include <array>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+// ARIAC
+#include <ariac_plugins/ariac_common.hpp>
+
+/**
+ * @brief Scoring rules of the competition, free of any Gazebo or ROS node dependency
+ *
+ * The task manager scores orders with these functions when they are submitted
+ * and records a Submission for each of them. Recorded submissions can be
+ * rescored offline with ariac_batch_scorer.
+ */
+namespace ariac_scoring
+{
+    //==============================================================================
+    /**
+     * @brief Everything needed to score one submitted order
+     *
+     * Only the task matching the order type and the shipment it is scored
+     * against are set.
+     */
+    struct Submission
+    {
+        //! Id of the submitted order
+        std::string order_id;
+        //! ariac_msgs::msg::Order type of the order
+        unsigned int type = 0;
+        //! Competition time at which the order was submitted
+        double submitted_time = 0.0;
+
+        std::shared_ptr<ariac_common::KittingTask> kitting_task;
+        std::shared_ptr<ariac_common::AssemblyTask> assembly_task;
+        std::shared_ptr<ariac_common::CombinedTask> combined_task;
+
+        //! ariac_msgs::msg::AGVStatus location of the kitting AGV
+        int agv_location = -1;
+        //! Parts on the kitting AGV
+        std::shared_ptr<ariac_common::KittingShipment> kitting_shipment;
+        //! Quadrants holding a faulty part, as resolved when the order was submitted
+        std::array<bool, 4> faulty_parts = {false, false, false, false};
+
+        //! Parts in the insert of the assembly station
+        std::shared_ptr<ariac_common::AssemblyShipment> assembly_shipment;
+    };
+
+    //==============================================================================
+    /**
+     * @brief Model reported by an AGV tray or assembly station logical camera
+     */
+    struct SensedModel
+    {
+        //! Name of the model in the simulation
+        std::string name;
+        //! Pose of the model in the sensor frame
+        geometry_msgs::msg::Pose pose;
+    };
+
+    /**
+     * @brief Build the kitting shipment seen by an AGV tray sensor
+     *
+     * @param _models  Models reported by the sensor
+     * @return ariac_common::KittingShipment  Parts with their pose on the kit tray, tray id -1 if no tray is seen
+     */
+    ariac_common::KittingShipment ParseKittingShipment(const std::vector<SensedModel> &_models);
+
+    /**
+     * @brief Build the assembly shipment seen by an assembly station sensor
+     *
+     * @param _models  Models reported by the sensor
+     * @return ariac_common::AssemblyShipment  Parts with their pose in the insert, station -1 if no insert is seen
+     */
+    ariac_common::AssemblyShipment ParseAssemblyShipment(const std::vector<SensedModel> &_models);
+
+    //==============================================================================
+    /**
+     * @brief Score a quadrant of a kitting tray
+     *
+     * @param is_correct_part_type  Part in the quadrant has the type of the order
+     * @param is_correct_part_color  Part in the quadrant has the color of the order
+     * @param is_flipped_part  Part in the quadrant is upside down
+     * @param is_faulty_part  Part in the quadrant is faulty
+     * @return int  Score of the quadrant
+     */
+    int ScoreQuadrant(bool is_correct_part_type, bool is_correct_part_color, bool is_flipped_part, bool is_faulty_part);
+
+    /**
+     * @brief Find the quadrants holding a faulty part
+     *
+     * Quadrants of the challenge checked for the first time are marked as
+     * checked and the matching parts are reported in _newly_faulty so the
+     * caller can rename their models.
+     *
+     * @param _challenge  Faulty part challenge of the order
+     * @param _task  Kitting task of the order
+     * @param _shipment  Parts on the kitting AGV
+     * @param _newly_faulty  Quadrant and model name of the parts found faulty by this call
+     * @return std::array<bool, 4>  True for each quadrant holding a faulty part
+     */
+    std::array<bool, 4> FindFaultyParts(ariac_common::FaultyPartChallenge &_challenge,
+                                        const ariac_common::KittingTask &_task,
+                                        const ariac_common::KittingShipment &_shipment,
+                                        std::vector<std::pair<int, std::string>> &_newly_faulty);
+
+    /**
+     * @brief Score a kitting order
+     *
+     * @param _order_id  Id of the order
+     * @param _task  Kitting task of the order
+     * @param _shipment  Parts on the kitting AGV
+     * @param _agv_location  Location of the kitting AGV
+     * @param _faulty_parts  Quadrants holding a faulty part
+     * @return std::shared_ptr<ariac_common::KittingScore>  Score of the order
+     */
+    std::shared_ptr<ariac_common::KittingScore> ScoreKittingTask(const std::string &_order_id,
+                                                                 const ariac_common::KittingTask &_task,
+                                                                 const ariac_common::KittingShipment &_shipment,
+                                                                 int _agv_location,
+                                                                 const std::array<bool, 4> &_faulty_parts);
+
+    /**
+     * @brief Score an assembly order
+     *
+     * @param _order_id  Id of the order
+     * @param _task  Assembly task of the order
+     * @param _shipment  Parts in the insert of the assembly station
+     * @return std::shared_ptr<ariac_common::AssemblyScore>  Score of the order
+     */
+    std::shared_ptr<ariac_common::AssemblyScore> ScoreAssemblyTask(const std::string &_order_id,
+                                                                   const ariac_common::AssemblyTask &_task,
+                                                                   const ariac_common::AssemblyShipment &_shipment);
+
+    /**
+     * @brief Score a combined order
+     *
+     * @param _order_id  Id of the order
+     * @param _task  Combined task of the order
+     * @param _shipment  Parts in the insert of the assembly station
+     * @return std::shared_ptr<ariac_common::CombinedScore>  Score of the order
+     */
+    std::shared_ptr<ariac_common::CombinedScore> ScoreCombinedTask(const std::string &_order_id,
+                                                                   const ariac_common::CombinedTask &_task,
+                                                                   const ariac_common::AssemblyShipment &_shipment);
+
+    /**
+     * @brief Score a recorded submission
+     *
+     * @param _submission  Submitted order and the shipment it is scored against
+     * @return int  Score of the order, 0 if the submission is incomplete
+     */
+    int ScoreSubmission(const Submission &_submission);
+
+    /**
+     * @brief Sum the scores of the orders of a trial
+     *
+     * @param _orders  Orders of the trial, orders without a score count for 0
+     * @return double  Score of the trial
+     */
+    double ComputeTrialScore(const std::vector<std::shared_ptr<ariac_common::Order>> &_orders);
+
+    /**
+     * @brief Write submissions in the snapshot text format read by ReadSubmissions()
+     *
+     * @param _out  Output stream
+     * @param _submissions  Submissions to write
+     */
+    void WriteSubmissions(std::ostream &_out, const std::vector<Submission> &_submissions);
+
+    /**
+     * @brief Read submissions written by WriteSubmissions()
+     *
+     * @param _in  Input stream
+     * @param _submissions  Submissions read from the stream
+     * @param _error  Description of the first malformed line
+     * @return true  If the whole stream was read
+     */
+    bool ReadSubmissions(std::istream &_in, std::vector<Submission> &_submissions, std::string &_error);
+
+} // namespace ariac_scoring
+
+#endif // ARIAC_PLUGINS__ARIAC_SCORING_HPP_
@@ -0,0 +1,153 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__MODEL_NAME_CLASSIFIER_HPP_
+#define ARIAC_PLUGINS__MODEL_NAME_CLASSIFIER_HPP_
+
+// C++
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+// Messages
+#include <ariac_msgs/msg/part.hpp>
+
+namespace ariac_common
+{
+    //==============================================================================
+    /**
+     * @brief Information decoded from the name of a model in the simulation
+     *
+     * Parts are named "<type>_<color>_XXX", kit trays "kit_tray_XX_YY" and
+     * inserts "assembly_insert_X". Parts flagged by the faulty part challenge
+     * get "_faulty" appended to their name.
+     */
+    struct ModelNameInfo
+    {
+        int type = -1;       //!< ariac_msgs::msg::Part type, -1 if not found
+        int color = -1;      //!< ariac_msgs::msg::Part color, -1 if not found
+        int tray_id = -1;    //!< Marker id of a kit tray, -1 if not a kit tray
+        int insert_id = -1;  //!< Id of an assembly insert, -1 if not an insert
+        bool faulty = false; //!< True if the model was renamed as faulty
+
+        bool IsPart() const { return type != -1 && color != -1; }
+        bool IsKitTray() const { return tray_id != -1; }
+        bool IsInsert() const { return insert_id != -1; }
+    };
+
+    //==============================================================================
+    /**
+     * @brief Parse the integer made of the digits found at pos in name
+     *
+     * @param name  Model name
+     * @param pos  Position of the first digit
+     * @param max_digits  Maximum number of digits to read
+     * @return int  Parsed value or -1 if there is no digit at pos
+     */
+    inline int ParseModelNameId(const std::string &name, std::size_t pos, std::size_t max_digits)
+    {
+        int value = -1;
+        for (std::size_t i = pos; i < name.size() && i < pos + max_digits; i++)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(name[i])))
+                break;
+            value = (value == -1 ? 0 : value * 10) + (name[i] - '0');
+        }
+        return value;
+    }
+
+    //==============================================================================
+    /**
+     * @brief Decode type, color, tray id, insert id and faulty flag from a model name
+     *
+     * Prefer ClassifyModelName() on hot paths, which caches the result.
+     *
+     * @param name  Model, link or collision name
+     * @return ModelNameInfo  Decoded information
+     */
+    inline ModelNameInfo ParseModelName(const std::string &name)
+    {
+        static const std::pair<const char *, int> types[] = {
+            {"battery", ariac_msgs::msg::Part::BATTERY},
+            {"pump", ariac_msgs::msg::Part::PUMP},
+            {"regulator", ariac_msgs::msg::Part::REGULATOR},
+            {"sensor", ariac_msgs::msg::Part::SENSOR}};
+
+        static const std::pair<const char *, int> colors[] = {
+            {"red", ariac_msgs::msg::Part::RED},
+            {"green", ariac_msgs::msg::Part::GREEN},
+            {"blue", ariac_msgs::msg::Part::BLUE},
+            {"orange", ariac_msgs::msg::Part::ORANGE},
+            {"purple", ariac_msgs::msg::Part::PURPLE}};
+
+        ModelNameInfo info;
+
+        std::size_t pos = name.find("kit_tray_");
+        if (pos != std::string::npos)
+            info.tray_id = ParseModelNameId(name, pos + 9, 2);
+
+        pos = name.find("assembly_insert_");
+        if (pos != std::string::npos)
+            info.insert_id = ParseModelNameId(name, pos + 16, 1);
+
+        for (const auto &type : types)
+        {
+            if (name.find(type.first) != std::string::npos)
+            {
+                info.type = type.second;
+                break;
+            }
+        }
+
+        for (const auto &color : colors)
+        {
+            if (name.find(color.first) != std::string::npos)
+            {
+                info.color = color.second;
+                break;
+            }
+        }
+
+        info.faulty = name.find("faulty") != std::string::npos;
+
+        return info;
+    }
+
+    /*!< Maximum number of names kept by the cache of ClassifyModelName() on each thread. */
+    constexpr std::size_t kModelNameCacheSize = 4096;
+
+    //==============================================================================
+    /**
+     * @brief Cached version of ParseModelName()
+     *
+     * Each distinct name is parsed once and then served from a hash map, so
+     * callers pay a single lookup per model instead of a substring scan for
+     * every type and color. The cache belongs to the calling thread, so sensor,
+     * transport and physics threads never contend on it. It is emptied once it
+     * holds kModelNameCacheSize names, since every conveyor part gets a new name.
+     *
+     * @param name  Model, link or collision name
+     * @return ModelNameInfo  Decoded information
+     */
+    inline ModelNameInfo ClassifyModelName(const std::string &name)
+    {
+        thread_local std::unordered_map<std::string, ModelNameInfo> cache;
+
+        auto it = cache.find(name);
+        if (it != cache.end())
+            return it->second;
+
+        if (cache.size() >= kModelNameCacheSize)
+            cache.clear();
+
+        return cache.emplace(name, ParseModelName(name)).first->second;
+    }
+
+} // namespace ariac_common
+
+#endif // ARIAC_PLUGINS__MODEL_NAME_CLASSIFIER_HPP_
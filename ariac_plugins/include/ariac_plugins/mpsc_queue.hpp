@@ -0,0 +1,92 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__MPSC_QUEUE_HPP_
+#define ARIAC_PLUGINS__MPSC_QUEUE_HPP_
+
+// C++
+#include <atomic>
+#include <utility>
+
+namespace ariac_common
+{
+    //==============================================================================
+    /**
+     * @brief Unbounded multi-producer single-consumer queue
+     *
+     * Push is wait-free and can be called from any thread, TryPop must only be
+     * called from one thread at a time. A value pushed while TryPop runs may
+     * only be seen by the next call.
+     */
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+        ~MpscQueue()
+        {
+            while (tail_ != nullptr)
+            {
+                Node *next = tail_->next.load(std::memory_order_relaxed);
+                delete tail_;
+                tail_ = next;
+            }
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        /**
+         * @brief Add a value at the end of the queue
+         */
+        void Push(T _value)
+        {
+            Node *node = new Node(std::move(_value));
+            Node *previous = head_.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        /**
+         * @brief Take the value at the front of the queue
+         *
+         * @param _value Set to the value taken
+         * @return true if the queue was not empty
+         */
+        bool TryPop(T &_value)
+        {
+            Node *next = tail_->next.load(std::memory_order_acquire);
+            if (next == nullptr)
+                return false;
+
+            // The node of the value taken becomes the new empty front node
+            _value = std::move(next->value);
+            delete tail_;
+            tail_ = next;
+            return true;
+        }
+
+    private:
+        struct Node
+        {
+            Node() = default;
+            explicit Node(T _value) : value(std::move(_value)) {}
+
+            T value{};
+            std::atomic<Node *> next{nullptr};
+        };
+
+        //! Last node pushed, shared by the producers
+        std::atomic<Node *> head_;
+        //! Empty node before the front of the queue, only used by the consumer
+        Node *tail_;
+    };
+
+} // namespace ariac_common
+
+#endif // ARIAC_PLUGINS__MPSC_QUEUE_HPP_
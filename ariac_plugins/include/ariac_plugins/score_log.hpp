@@ -0,0 +1,166 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__SCORE_LOG_HPP_
+#define ARIAC_PLUGINS__SCORE_LOG_HPP_
+
+// C++
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+// Messages
+#include <geometry_msgs/msg/vector3.hpp>
+// ARIAC
+#include <ariac_plugins/ariac_common.hpp>
+
+namespace ariac_scoring
+{
+    //==============================================================================
+    /**
+     * @brief Structured entry of the score log
+     *
+     * Fields are kept in insertion order and rendered either as one line of
+     * JSON for the log file or as the human readable report printed in the
+     * terminal. Fields without a label only appear in the JSON rendering.
+     */
+    class ScoreRecord
+    {
+    public:
+        /**
+         * @brief Construct a new Score Record object
+         *
+         * @param _event  Value of the "event" JSON field, empty for nested records
+         * @param _title  Heading of the text report, empty for none
+         */
+        explicit ScoreRecord(const std::string &_event = "", const std::string &_title = "")
+            : event_(_event), title_(_title) {}
+
+        ScoreRecord &Add(const std::string &_key, const std::string &_label, const std::string &_value);
+        ScoreRecord &Add(const std::string &_key, const std::string &_label, const char *_value);
+        ScoreRecord &Add(const std::string &_key, const std::string &_label, int _value);
+        ScoreRecord &Add(const std::string &_key, const std::string &_label, double _value);
+        ScoreRecord &Add(const std::string &_key, const std::string &_label, const geometry_msgs::msg::Vector3 &_value);
+        /**
+         * @brief Add a boolean field
+         *
+         * @param _true_text  Text rendering of true
+         * @param _false_text  Text rendering of false
+         */
+        ScoreRecord &AddFlag(const std::string &_key, const std::string &_label, bool _value,
+                             const std::string &_true_text = "Yes", const std::string &_false_text = "No");
+        /**
+         * @brief Append a nested record to the list named _key
+         *
+         * @param _label  Heading printed once before the list in the text report, empty for none
+         */
+        ScoreRecord &AddChild(const std::string &_key, const std::string &_label, ScoreRecord _child);
+
+        /**
+         * @brief Render the record as one line of JSON, without the trailing newline
+         */
+        std::string ToJson() const;
+        /**
+         * @brief Render the record as a human readable report
+         */
+        std::string ToText() const;
+
+    private:
+        struct Field
+        {
+            std::string key;
+            std::string label;
+            std::string json;
+            std::string text;
+        };
+
+        struct ChildList
+        {
+            std::string key;
+            std::string label;
+            std::vector<ScoreRecord> records;
+        };
+
+        void AppendJson(std::string &_out) const;
+        void AppendText(std::string &_out) const;
+
+        std::string event_;
+        std::string title_;
+        std::vector<Field> fields_;
+        std::vector<ChildList> children_;
+    };
+
+    //==============================================================================
+    /**
+     * @brief Build the score log entry of a kitting order
+     */
+    ScoreRecord KittingScoreRecord(const ariac_common::KittingScore &_score);
+
+    /**
+     * @brief Build the score log entry of an assembly order
+     */
+    ScoreRecord AssemblyScoreRecord(const ariac_common::AssemblyScore &_score);
+
+    /**
+     * @brief Build the score log entry of a combined order
+     */
+    ScoreRecord CombinedScoreRecord(const ariac_common::CombinedScore &_score);
+
+    //==============================================================================
+    /**
+     * @brief Append-only score log written by a background thread
+     *
+     * Each record is written as one JSON line to the log and as text to an
+     * optional report, and both files are flushed after each batch of records,
+     * so a crash only loses the records still queued.
+     */
+    class ScoreLogWriter
+    {
+    public:
+        ~ScoreLogWriter() { Close(); }
+
+        /**
+         * @brief Open the files in append mode and start the writer thread
+         *
+         * @param _json_path  Path of the newline-delimited JSON log
+         * @param _text_path  Path of the text report, empty for none
+         * @return true  If the files could be opened
+         */
+        bool Open(const std::string &_json_path, const std::string &_text_path = "");
+        /**
+         * @brief Queue a record, ignored if the log is not open
+         */
+        void Write(ScoreRecord _record);
+        /**
+         * @brief Write the queued records and stop the writer thread
+         */
+        void Close();
+        /**
+         * @brief Whether the log is open
+         */
+        bool IsOpen();
+
+    private:
+        void Run();
+
+        std::mutex lock_;
+        std::condition_variable wake_;
+        std::deque<ScoreRecord> queue_;
+        bool open_ = false;
+        bool stop_ = false;
+        std::ofstream json_file_;
+        std::ofstream text_file_;
+        std::thread thread_;
+    };
+
+} // namespace ariac_scoring
+
+#endif // ARIAC_PLUGINS__SCORE_LOG_HPP_
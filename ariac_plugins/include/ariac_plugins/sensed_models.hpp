@@ -0,0 +1,43 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__SENSED_MODELS_HPP_
+#define ARIAC_PLUGINS__SENSED_MODELS_HPP_
+
+// C++
+#include <vector>
+// Gazebo
+#include <gazebo/msgs/msgs.hh>
+#include <gazebo_ros/conversions/geometry_msgs.hpp>
+// ARIAC
+#include <ariac_plugins/ariac_scoring.hpp>
+
+namespace ariac_plugins
+{
+    //==============================================================================
+    /**
+     * @brief Convert the models of a logical camera image to the input of the ariac_scoring parsers
+     *
+     * @param _msg  Image of an AGV tray or assembly station sensor
+     * @return std::vector<ariac_scoring::SensedModel>  Name and pose of each model in the sensor frame
+     */
+    inline std::vector<ariac_scoring::SensedModel> ToSensedModels(const gazebo::msgs::LogicalCameraImage &_msg)
+    {
+        std::vector<ariac_scoring::SensedModel> models;
+        models.reserve(_msg.model_size());
+        for (int i = 0; i < _msg.model_size(); i++)
+        {
+            const auto &lc_model = _msg.model(i);
+            models.push_back({lc_model.name(),
+                              gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()))});
+        }
+        return models;
+    }
+} // namespace ariac_plugins
+
+#endif // ARIAC_PLUGINS__SENSED_MODELS_HPP_
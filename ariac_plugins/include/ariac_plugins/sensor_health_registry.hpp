@@ -0,0 +1,88 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__SENSOR_HEALTH_REGISTRY_HPP_
+#define ARIAC_PLUGINS__SENSOR_HEALTH_REGISTRY_HPP_
+
+// C++
+#include <atomic>
+#include <cstdint>
+// Messages
+#include <ariac_msgs/msg/sensors.hpp>
+
+namespace ariac_common
+{
+    //==============================================================================
+    /**
+     * @brief Health of each sensor type, shared by all plugins in the simulation process
+     *
+     * The task manager writes the health once per update and the sensor plugins
+     * read it from their sensor threads without locking. /ariac/sensor_health
+     * is only published for nodes outside the simulation.
+     */
+    class SensorHealthRegistry
+    {
+    public:
+        //! Bit of each sensor type in the health mask
+        enum Sensor : uint32_t
+        {
+            BREAK_BEAM = 1u << 0,
+            PROXIMITY = 1u << 1,
+            LASER_PROFILER = 1u << 2,
+            LIDAR = 1u << 3,
+            CAMERA = 1u << 4,
+            LOGICAL_CAMERA = 1u << 5,
+            ALL = (1u << 6) - 1
+        };
+
+        /**
+         * @brief Registry shared by all the plugins loaded in the process
+         */
+        static SensorHealthRegistry &Instance();
+
+        /**
+         * @brief Check whether a sensor type is healthy
+         *
+         * @param _sensor Bit of the sensor type
+         * @return true if the sensor type is healthy
+         */
+        bool IsHealthy(Sensor _sensor) const
+        {
+            return (mask_.load(std::memory_order_acquire) & _sensor) != 0;
+        }
+
+        /**
+         * @brief Get the health of all the sensor types
+         */
+        uint32_t GetMask() const { return mask_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Set the health of all the sensor types
+         *
+         * @param _mask Bits of the healthy sensor types
+         * @return true if the health changed
+         */
+        bool SetMask(uint32_t _mask) { return mask_.exchange(_mask, std::memory_order_acq_rel) != _mask; }
+
+        /**
+         * @brief Build the /ariac/sensor_health message for a health mask
+         */
+        static ariac_msgs::msg::Sensors ToMsg(uint32_t _mask);
+
+    private:
+        SensorHealthRegistry() = default;
+        SensorHealthRegistry(const SensorHealthRegistry &) = delete;
+        SensorHealthRegistry &operator=(const SensorHealthRegistry &) = delete;
+
+        //! All sensors are healthy until the task manager says otherwise
+        std::atomic<uint32_t> mask_{ALL};
+    };
+
+} // namespace ariac_common
+
+#endif // ARIAC_PLUGINS__SENSOR_HEALTH_REGISTRY_HPP_
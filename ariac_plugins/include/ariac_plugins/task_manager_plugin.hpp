@@ -12,6 +12,7 @@ Distributions of NIST software should also include copyright and licensing state
 // Gazebo
 #include <gazebo/common/Plugin.hh>
 // C++
+#include <functional>
 #include <memory>
 #include <vector>
 // Services
@@ -97,6 +98,9 @@ namespace ariac_plugins
 
         /**
          * @brief Callback for the start competition service
+         *
+         * The service callbacks are queued by the executor and run by OnUpdate
+         * with the state locked, so the executor never waits for a world update to finish.
          * @param request
          * @param response
          * @return true
@@ -175,68 +179,102 @@ namespace ariac_plugins
          */
         const ariac_msgs::msg::CombinedTask BuildCombinedTaskMsg(std::shared_ptr<ariac_common::CombinedTask> _task);
         /**
-         * @brief Manage orders to be announced
+         * @brief Schedule an action to run once the elapsed time reaches _time
          *
-         * @param _current_sim_time Current simulation time
+         * @param _time Elapsed competition time at which the action is due
+         * @param _action Action to run
+         */
+        void ScheduleTimedEvent(double _time, std::function<void()> _action);
+        /**
+         * @brief Set the elapsed competition time the timed events are compared with
+         *
+         * OnUpdate sets it on every world update, ariac_trial_replay sets it from the capture.
+         * @param _time Elapsed competition time
+         */
+        void SetElapsedTime(double _time);
+        /**
+         * @brief Run the timed events that are due, in time order
          */
-        void ProcessOrdersToAnnounce();
+        void ProcessTimedEvents();
         /**
-         * @brief Process the challenges to be announced
+         * @brief Announce an order whose condition was met
          *
-         * @param _elapsed_time Elapsed time since the start of the competition
+         * @param _order Order to announce
          */
-        void ProcessChallengesToAnnounce();
+        void AnnounceOrder(std::shared_ptr<ariac_common::Order> _order);
         /**
-         * @brief Manage time-based orders to be submitted
+         * @brief Run an action the first time a part is placed on an AGV
          *
-         * @param _current_sim_time Current simulation time
+         * @param _agv AGV the part has to be placed on
+         * @param _part Type and color of the part
+         * @param _action Action to run
+         */
+        void AddPartPlacementTrigger(unsigned int _agv,
+                                     std::shared_ptr<ariac_common::Part> _part,
+                                     std::function<void()> _action);
+        /**
+         * @brief Run the part placement triggers matching the parts added to the AGVs
          */
-        void ProcessTemporalOrders();
+        void ProcessPartPlacementTriggers();
         /**
-         * @brief Manage on part placement orders to be submitted
+         * @brief Record the parts placed on an AGV between two tray images, for ProcessPartPlacementTriggers
          *
-         * @param _current_sim_time Current simulation time
+         * @param _agv AGV the parts are on
+         * @param _old_parts Parts on the tray in the previous image
+         * @param _new_parts Parts on the tray in the latest image
          */
-        void ProcessOnPartPlacementOrders();
+        void QueueAddedAGVParts(unsigned int _agv,
+                                const std::vector<ariac_common::Part> &_old_parts,
+                                const std::vector<ariac_common::Part> &_new_parts);
         /**
-         * @brief Manage on submission orders to be submitted
+         * @brief Run an action once an order is submitted
          *
-         * @param _current_sim_time Current simulation time
+         * @param _order_id Id of the order whose submission triggers the action
+         * @param _action Action to run
          */
-        void ProcessOnSubmissionOrders();
-
-        void ProcessTemporalSensorBlackouts();
-        void ProcessOnSubmissionSensorBlackouts();
-        void ProcessOnSubmissionRobotMalfunctions();
+        void AddSubmissionTrigger(const std::string &_order_id, std::function<void()> _action);
+        /**
+         * @brief Run the submission triggers of the orders submitted since the last update
+         */
+        void ProcessSubmissionTriggers();
+        /**
+         * @brief Record the submission of an order, its triggers run on the next ProcessSubmissionTriggers
+         *
+         * @param _order_id Id of the submitted order
+         */
+        void QueueSubmissionTriggers(const std::string &_order_id);
 
         // process the human challenge
-        void ProcessTemporalHumanChallenge();
-        void ProcessOnPartPlacementHumanChallenge();
-        void ProcessOnOrderSubmissionHumanChallenge();
-        void ProcessEndSafeZonePenalty();
+        void StartHumanChallenge(std::shared_ptr<ariac_common::HumanChallenge> _challenge);
+        void EndSafeZonePenalty();
 
         void UpdateSensorsHealth();
         void UpdateRobotsHealth();
         void DisableAllSensors();
         void DisableAllRobots();
-        void ProcessInProgressSensorBlackouts();
-        void ProcessInProgressRobotMalfunctions();
-        void ProcessTemporalRobotMalfunctions();
-        void ProcessOnPartPlacementRobotMalfunctions();
-        void ProcessOnPartPlacementSensorBlackouts();
+        void StartSensorBlackout(std::shared_ptr<ariac_common::SensorBlackout> _blackout);
+        void EndSensorBlackout(std::shared_ptr<ariac_common::SensorBlackout> _blackout);
+        void StartRobotMalfunction(std::shared_ptr<ariac_common::RobotMalfunction> _malfunction);
+        void EndRobotMalfunction(std::shared_ptr<ariac_common::RobotMalfunction> _malfunction);
         void SetSensorsHealth(const std::vector<std::string> &_sensors_to_disable);
         void SetRobotsHealth(const std::vector<std::string> &_robots_to_disable);
         
         /**
          * @brief Callback function for the topic 'trial_config'
          *
+         * Queued by the subscription and run by OnUpdate with the state locked.
+         *
          * @param _msg Shared pointer to the message
          */
         void OnTrialCallback(const ariac_msgs::msg::Trial::SharedPtr _msg);
-        void OnAGV1StatusCallback(const ariac_msgs::msg::AGVStatus::SharedPtr _msg);
-        void OnAGV2StatusCallback(const ariac_msgs::msg::AGVStatus::SharedPtr _msg);
-        void OnAGV3StatusCallback(const ariac_msgs::msg::AGVStatus::SharedPtr _msg);
-        void OnAGV4StatusCallback(const ariac_msgs::msg::AGVStatus::SharedPtr _msg);
+
+        /**
+         * @brief Callback function for the topics '/ariac/agv{n}_status'
+         *
+         * @param _agv_id ID of the AGV the status is for
+         * @param _msg Shared pointer to the message
+         */
+        void OnAGVStatusCallback(int _agv_id, const ariac_msgs::msg::AGVStatus::SharedPtr _msg);
 
         /**
          * @brief Compute the final score for the trial
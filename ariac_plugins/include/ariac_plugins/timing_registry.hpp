@@ -0,0 +1,149 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__TIMING_REGISTRY_HPP_
+#define ARIAC_PLUGINS__TIMING_REGISTRY_HPP_
+
+// C++
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+// Messages
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+
+namespace ariac_common
+{
+    //==============================================================================
+    /**
+     * @brief Histogram of latencies in nanoseconds that can be recorded from any thread without locking
+     *
+     * Latencies are counted in log-linear buckets: 16 buckets per power of two,
+     * which keeps each reported value within 6.25% of the recorded one.
+     * Latencies above about 18 minutes are counted in the last bucket.
+     */
+    class LatencyHistogram
+    {
+    public:
+        //! Latency summary since the previous call to TakeSummary
+        struct Summary
+        {
+            uint64_t count{0};
+            uint64_t p50_ns{0};
+            uint64_t p99_ns{0};
+            uint64_t max_ns{0};
+        };
+
+        /**
+         * @brief Count one latency
+         *
+         * @param _ns Latency in nanoseconds
+         */
+        void Record(uint64_t _ns);
+
+        /**
+         * @brief Summarize the latencies recorded since the previous call and start a new window
+         *
+         * Latencies recorded while the summary is taken are counted in either window.
+         */
+        Summary TakeSummary();
+
+    private:
+        static constexpr int kSubBucketBits = 4;
+        static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+        static constexpr int kMaxBits = 40;
+        static constexpr std::size_t kBucketCount = (kMaxBits - kSubBucketBits + 1) * kSubBucketCount;
+
+        //! Bucket counting a latency
+        static std::size_t BucketIndex(uint64_t _ns);
+        //! Highest latency counted by a bucket
+        static uint64_t BucketValue(std::size_t _index);
+
+        std::array<std::atomic<uint64_t>, kBucketCount> counts_{};
+        std::atomic<uint64_t> max_ns_{0};
+    };
+
+    //==============================================================================
+    /**
+     * @brief Record the time spent in a scope into a histogram
+     *
+     * Nothing is recorded when the histogram is null.
+     */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(LatencyHistogram *_histogram)
+            : histogram_(_histogram), start_(std::chrono::steady_clock::now()) {}
+
+        ~ScopedTimer()
+        {
+            if (histogram_)
+                histogram_->Record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - start_)
+                                       .count());
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        LatencyHistogram *histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    //==============================================================================
+    /**
+     * @brief Latency histograms of the plugin update steps, shared by all plugins in the simulation process
+     *
+     * Plugins look up their histograms once when they are loaded and record into
+     * them from their update threads without locking. The task manager publishes
+     * a summary of every histogram on /diagnostics.
+     */
+    class TimingRegistry
+    {
+    public:
+        /**
+         * @brief Registry shared by all the plugins loaded in the process
+         */
+        static TimingRegistry &Instance();
+
+        /**
+         * @brief Get the histogram of a plugin step, creating it if needed
+         *
+         * Instances of the same plugin share the histograms of their steps.
+         *
+         * @param _plugin Name of the plugin
+         * @param _step Name of the step in the plugin
+         * @return Histogram that stays valid for the lifetime of the process
+         */
+        LatencyHistogram *Histogram(const std::string &_plugin, const std::string &_step);
+
+        /**
+         * @brief Build the /diagnostics message with p50, p99 and max of every histogram
+         *
+         * Each histogram starts a new window, so every message covers the time since the previous one.
+         */
+        diagnostic_msgs::msg::DiagnosticArray ToMsg();
+
+    private:
+        TimingRegistry() = default;
+        TimingRegistry(const TimingRegistry &) = delete;
+        TimingRegistry &operator=(const TimingRegistry &) = delete;
+
+        std::mutex mutex_;
+        //! Histograms by "plugin/step"
+        std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms_;
+    };
+
+} // namespace ariac_common
+
+#endif // ARIAC_PLUGINS__TIMING_REGISTRY_HPP_
@@ -0,0 +1,255 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__TRIAL_CAPTURE_HPP_
+#define ARIAC_PLUGINS__TRIAL_CAPTURE_HPP_
+
+// C++
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+// Messages
+#include <ariac_msgs/msg/faulty_part_challenge.hpp>
+#include <ariac_msgs/msg/trial.hpp>
+// ARIAC
+#include <ariac_plugins/ariac_common.hpp>
+#include <ariac_plugins/ariac_scoring.hpp>
+
+/**
+ * @brief Binary event log of a trial, recorded by the task manager and replayed offline
+ *
+ * A capture file starts with an 8 byte magic ("ARIACCAP") and a 32 bit format
+ * version followed by 4 reserved bytes. Each record is a 16 byte header
+ * (32 bit type, 32 bit payload size, 64 bit simulation time) followed by the
+ * payload, padded to 8 bytes so the file can be memory mapped and walked in place.
+ * Values are stored in the byte order of the host that recorded them.
+ */
+namespace ariac_capture
+{
+    //! Version of the capture format written by CaptureWriter
+    constexpr uint32_t kCaptureVersion = 1;
+
+    //==============================================================================
+    /**
+     * @brief Kinds of records in a capture file
+     */
+    enum RecordType : uint32_t
+    {
+        //! Models seen by an AGV tray sensor: AGV, models
+        TRAY_IMAGE = 1,
+        //! Models seen by an assembly station sensor: station, models
+        STATION_IMAGE = 2,
+        //! Location of an AGV: AGV, location
+        AGV_STATUS = 3,
+        //! Order announced to the competitor: order with its task
+        ORDER_ANNOUNCED = 4,
+        //! Challenge started: ariac_msgs::msg::Challenge type, description
+        CHALLENGE_STARTED = 5,
+        //! Faulty part challenge of the trial: order id, faulty quadrants
+        FAULTY_PART_CHALLENGE = 6,
+        //! Call to /ariac/submit_order: order id
+        SUBMIT_ORDER = 7,
+        //! Call to /ariac/perform_quality_check: order id
+        QUALITY_CHECK = 8,
+        //! Score computed by the task manager for a submitted order: order id, score
+        ORDER_SCORED = 9,
+        //! End of the trial: trial score
+        TRIAL_END = 10,
+        //! Announcement conditions of the trial: order ids and conditions, challenge types and conditions
+        TRIAL_CONFIG = 11,
+    };
+
+    //==============================================================================
+    /**
+     * @brief Append-only encoder for the payload of a record
+     */
+    class PayloadWriter
+    {
+    public:
+        void U32(uint32_t _value) { Append(&_value, sizeof(_value)); }
+        void I32(int32_t _value) { Append(&_value, sizeof(_value)); }
+        void F64(double _value) { Append(&_value, sizeof(_value)); }
+        void String(const std::string &_value);
+        void Pose(const geometry_msgs::msg::Pose &_pose);
+        void Models(const std::vector<ariac_scoring::SensedModel> &_models);
+
+        const std::vector<uint8_t> &Bytes() const { return bytes_; }
+
+    private:
+        void Append(const void *_data, std::size_t _size);
+
+        std::vector<uint8_t> bytes_;
+    };
+
+    //==============================================================================
+    /**
+     * @brief Bounds checked decoder for the payload of a record
+     *
+     * Every read returns false once the payload is exhausted and leaves the
+     * value untouched.
+     */
+    class PayloadReader
+    {
+    public:
+        PayloadReader() = default;
+        PayloadReader(const uint8_t *_data, std::size_t _size) : data_(_data), size_(_size) {}
+
+        bool U32(uint32_t &_value) { return Take(&_value, sizeof(_value)); }
+        bool I32(int32_t &_value) { return Take(&_value, sizeof(_value)); }
+        bool F64(double &_value) { return Take(&_value, sizeof(_value)); }
+        bool String(std::string &_value);
+        bool Pose(geometry_msgs::msg::Pose &_pose);
+        bool Models(std::vector<ariac_scoring::SensedModel> &_models);
+
+    private:
+        bool Take(void *_data, std::size_t _size);
+
+        const uint8_t *data_ = nullptr;
+        std::size_t size_ = 0;
+        std::size_t offset_ = 0;
+    };
+
+    //==============================================================================
+    /**
+     * @brief Record read from a capture file, the payload points into the mapped file
+     */
+    struct Record
+    {
+        uint32_t type = 0;
+        double sim_time = 0.0;
+        PayloadReader payload;
+    };
+
+    //==============================================================================
+    /**
+     * @brief Thread safe writer of a capture file
+     *
+     * Images and AGV statuses identical to the previous record of the same
+     * sensor are skipped, they would not change the outcome of a replay.
+     */
+    class CaptureWriter
+    {
+    public:
+        ~CaptureWriter() { Close(); }
+
+        /**
+         * @brief Create the capture file and write its header
+         *
+         * @param _path  Path of the capture file
+         * @return true  If the file could be created
+         */
+        bool Open(const std::string &_path);
+        /**
+         * @brief Flush and close the capture file
+         */
+        void Close();
+
+        void WriteTrayImage(double _sim_time, unsigned int _agv, const std::vector<ariac_scoring::SensedModel> &_models);
+        void WriteStationImage(double _sim_time, unsigned int _station, const std::vector<ariac_scoring::SensedModel> &_models);
+        void WriteAGVStatus(double _sim_time, unsigned int _agv, int _location);
+        void WriteOrderAnnounced(double _sim_time, const ariac_common::Order &_order);
+        void WriteChallengeStarted(double _sim_time, unsigned int _type, const std::string &_description);
+        void WriteFaultyPartChallenge(double _sim_time, const ariac_msgs::msg::FaultyPartChallenge &_challenge);
+        void WriteSubmitOrder(double _sim_time, const std::string &_order_id);
+        void WriteQualityCheck(double _sim_time, const std::string &_order_id);
+        void WriteOrderScored(double _sim_time, const std::string &_order_id, int _score);
+        void WriteTrialEnd(double _sim_time, double _trial_score);
+        void WriteTrialConfig(double _sim_time, const ariac_msgs::msg::Trial &_trial);
+
+    private:
+        /**
+         * @brief Append a record to the file
+         *
+         * @param _source  Sensor the record comes from, 0 if the record is never deduplicated
+         */
+        void Write(uint32_t _type, double _sim_time, const PayloadWriter &_payload, uint32_t _source = 0);
+
+        std::mutex lock_;
+        std::ofstream file_;
+        //! Last payload written for each (record type, sensor)
+        std::map<std::pair<uint32_t, uint32_t>, std::vector<uint8_t>> last_payloads_;
+    };
+
+    //==============================================================================
+    /**
+     * @brief Reader of a memory mapped capture file
+     */
+    class CaptureReader
+    {
+    public:
+        CaptureReader() = default;
+        CaptureReader(const CaptureReader &) = delete;
+        CaptureReader &operator=(const CaptureReader &) = delete;
+        ~CaptureReader();
+
+        /**
+         * @brief Map a capture file and check its header
+         *
+         * @param _path  Path of the capture file
+         * @param _error  Reason the file could not be read
+         * @return true  If the file is a capture file of a supported version
+         */
+        bool Open(const std::string &_path, std::string &_error);
+        /**
+         * @brief Read the next record
+         *
+         * @param _record  Next record
+         * @return true  If a record was read, false at the end of the file or on a truncated record
+         */
+        bool Next(Record &_record);
+        /**
+         * @brief Whether the last call to Next() stopped on a truncated record
+         */
+        bool Truncated() const { return truncated_; }
+
+    private:
+        const uint8_t *data_ = nullptr;
+        std::size_t size_ = 0;
+        std::size_t offset_ = 0;
+        bool truncated_ = false;
+    };
+
+    //==============================================================================
+    /**
+     * @brief Decode the order of an ORDER_ANNOUNCED record
+     *
+     * @param _payload  Payload of the record
+     * @return std::shared_ptr<ariac_common::Order>  Order with its task, nullptr if the payload is malformed
+     */
+    std::shared_ptr<ariac_common::Order> ReadOrder(PayloadReader &_payload);
+
+    /**
+     * @brief Decode the challenge of a FAULTY_PART_CHALLENGE record
+     *
+     * @param _payload  Payload of the record
+     * @param _challenge  Decoded challenge
+     * @return true  If the payload is well formed
+     */
+    bool ReadFaultyPartChallenge(PayloadReader &_payload, ariac_msgs::msg::FaultyPartChallenge &_challenge);
+
+    /**
+     * @brief Decode the announcement conditions of a TRIAL_CONFIG record
+     *
+     * Only the id, type and condition of the orders and the type and condition
+     * of the sensor blackout, robot malfunction and human challenges are set.
+     *
+     * @param _payload  Payload of the record
+     * @param _trial  Trial holding the decoded conditions
+     * @return true  If the payload is well formed
+     */
+    bool ReadTrialConfig(PayloadReader &_payload, ariac_msgs::msg::Trial &_trial);
+
+} // namespace ariac_capture
+
+#endif // ARIAC_PLUGINS__TRIAL_CAPTURE_HPP_
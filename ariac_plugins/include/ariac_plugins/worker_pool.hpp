@@ -0,0 +1,69 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#ifndef ARIAC_PLUGINS__WORKER_POOL_HPP_
+#define ARIAC_PLUGINS__WORKER_POOL_HPP_
+
+// C++
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ariac_scoring
+{
+    //==============================================================================
+    /**
+     * @brief Fixed set of threads running posted tasks in order of posting
+     */
+    class WorkerPool
+    {
+    public:
+        /**
+         * @brief Start the worker threads
+         *
+         * @param _threads  Number of threads, at least one is started
+         */
+        explicit WorkerPool(unsigned int _threads);
+
+        /**
+         * @brief Run the tasks still queued and join the threads
+         */
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        /**
+         * @brief Queue a task to run on one of the threads
+         */
+        void Post(std::function<void()> _task);
+
+        /**
+         * @brief Block until all the tasks posted so far are done
+         */
+        void Wait();
+
+    private:
+        void Run();
+
+        std::mutex lock_;
+        std::condition_variable wake_;
+        std::condition_variable idle_;
+        std::deque<std::function<void()>> tasks_;
+        //! Number of tasks being run
+        unsigned int busy_ = 0;
+        bool stop_ = false;
+        std::vector<std::thread> threads_;
+    };
+
+} // namespace ariac_scoring
+
+#endif // ARIAC_PLUGINS__WORKER_POOL_HPP_
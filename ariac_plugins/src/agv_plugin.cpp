@@ -8,15 +8,21 @@ Distributions of NIST software should also include copyright and licensing state
 
 #include <gazebo/physics/Model.hh>
 #include <gazebo/physics/Joint.hh>
+#include <gazebo/physics/World.hh>
 #include <ariac_plugins/agv_plugin.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 #include <gazebo_ros/node.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <std_msgs/msg/float64_multi_array.hpp>
 #include <sensor_msgs/msg/joint_state.hpp>
 #include <ariac_msgs/srv/move_agv.hpp>
 #include <ariac_msgs/msg/agv_status.hpp>
+#include <ariac_msgs/msg/agv_move_status.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <mutex>
 
 namespace ariac_plugins
 {
@@ -30,6 +36,9 @@ public:
   /// Node for ROS communication.
   gazebo_ros::Node::SharedPtr ros_node_;
 
+  /// Latency of OnUpdate, shared by all the AGVs
+  ariac_common::LatencyHistogram *update_timing_{nullptr};
+
   gazebo::physics::ModelPtr model_;
   gazebo::physics::JointPtr agv_joint_;
 
@@ -39,16 +48,33 @@ public:
   double back_assembly_station_ = 10.6;
   double warehouse_location_ = 17;
   double max_velocity_ = 2.0;
+  double acceleration_ = 2.0;
+  double min_velocity_ = 0.05;
+  double goal_tolerance_ = 0.01;
+
+  // Motion profile state, shared between the move service and OnUpdate
+  std::mutex motion_lock_;
+  bool moving_ = false;
+  int goal_location_;
   double goal_position_;
+  double start_position_;
+  double move_direction_;
+  double commanded_velocity_ = 0.0;
+  gazebo::common::Time last_update_time_;
 
-  // Velocity publisher
+  // Velocity publisher, the controller keeps the last command so only changes are published
   rclcpp::Publisher<std_msgs::msg::Float64MultiArray>::SharedPtr velocity_pub_;
   std_msgs::msg::Float64MultiArray velocity_msg_;
+  bool velocity_published_ = false;
 
   // AGV Status publisher
   rclcpp::Publisher<ariac_msgs::msg::AGVStatus>::SharedPtr status_pub_;
   ariac_msgs::msg::AGVStatus status_msg_;
 
+  // AGV move status publisher
+  rclcpp::Publisher<ariac_msgs::msg::AGVMoveStatus>::SharedPtr move_status_pub_;
+  ariac_msgs::msg::AGVMoveStatus move_status_msg_;
+
   rclcpp::Time last_publish_time_;
   int update_ns_;
   bool first_publish_;
@@ -60,7 +86,9 @@ public:
   void MoveAGV( 
     ariac_msgs::srv::MoveAGV::Request::SharedPtr req,
     ariac_msgs::srv::MoveAGV::Response::SharedPtr res);
-  void MoveToGoal(double goal);
+  void MoveToGoal(int location, double goal);
+  void StepMotion(double dt);
+  void PublishMoveStatus(uint8_t state);
   void PublishStatus();
   void OnUpdate();
 
@@ -98,10 +126,18 @@ void AGVPlugin::Load(gazebo::physics::ModelPtr model, sdf::ElementPtr sdf)
   std::string status_topic = "/ariac/" + impl_->agv_number_ + "_status";
   impl_->status_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::AGVStatus>(status_topic, 10);
 
+  // Register move status publisher
+  std::string move_status_topic = "/ariac/" + impl_->agv_number_ + "_move_status";
+  impl_->move_status_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::AGVMoveStatus>(
+    move_status_topic, rclcpp::QoS(1).transient_local());
+
   double publish_rate = 10;
   impl_->update_ns_ = int((1/publish_rate) * 1e9);
   impl_->first_publish_ = true;
 
+  impl_->velocity_msg_.data.resize(1, 0.0);
+  impl_->last_update_time_ = model->GetWorld()->SimTime();
+
   // Register move service
   impl_->move_service_ = impl_->ros_node_->create_service<ariac_msgs::srv::MoveAGV>(
       "/ariac/move_"+impl_->agv_number_, 
@@ -110,12 +146,23 @@ void AGVPlugin::Load(gazebo::physics::ModelPtr model, sdf::ElementPtr sdf)
       std::placeholders::_1, std::placeholders::_2));
 
   // Create a connection so the OnUpdate function is called at every simulation iteration. 
+  impl_->update_timing_ = ariac_common::TimingRegistry::Instance().Histogram("AGVPlugin", "OnUpdate");
   impl_->update_connection_ = gazebo::event::Events::ConnectWorldUpdateBegin(
     std::bind(&AGVPluginPrivate::OnUpdate, impl_.get()));
 }
 
 void AGVPluginPrivate::OnUpdate()
 {
+  ariac_common::ScopedTimer timer(update_timing_);
+  gazebo::common::Time current_time = model_->GetWorld()->SimTime();
+  double dt = (current_time - last_update_time_).Double();
+  last_update_time_ = current_time;
+
+  // Advance the motion profile by one world step
+  if (dt > 0) {
+    StepMotion(dt);
+  }
+
   // Publish status at rate
   rclcpp::Time now = ros_node_->get_clock()->now();
   if (first_publish_) {
@@ -131,10 +178,15 @@ void AGVPluginPrivate::OnUpdate()
 
 void AGVPluginPrivate::PublishVelocity(double vel)
 {
+  // Cruising at constant velocity publishes nothing, only the ramps and the stop do
+  if (velocity_published_ && velocity_msg_.data[0] == vel) {
+    return;
+  }
+
   // RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Publishing velocity: " << vel);
-  velocity_msg_.data.clear();
-  velocity_msg_.data.push_back(vel);
+  velocity_msg_.data[0] = vel;
   velocity_pub_->publish(velocity_msg_);
+  velocity_published_ = true;
 }
 
 
@@ -147,7 +199,7 @@ void AGVPluginPrivate::MoveAGV(
   if (req->location == ariac_msgs::srv::MoveAGV::Request::KITTING){
     RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Moving " << agv_number_ << " to kitting station");
 
-    this->MoveToGoal(kitting_location_);    
+    this->MoveToGoal(req->location, kitting_location_);    
 
     res->success = true;
     return;
@@ -155,7 +207,7 @@ void AGVPluginPrivate::MoveAGV(
   else if (req->location == ariac_msgs::srv::MoveAGV::Request::ASSEMBLY_FRONT){
     RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Moving " << agv_number_ << " to front assembly station");
 
-    this->MoveToGoal(front_assembly_station_);   
+    this->MoveToGoal(req->location, front_assembly_station_);   
 
     res->success = true;
     return;
@@ -163,7 +215,7 @@ void AGVPluginPrivate::MoveAGV(
   else if (req->location == ariac_msgs::srv::MoveAGV::Request::ASSEMBLY_BACK){
     RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Moving " << agv_number_ << " to back assembly station");
 
-    this->MoveToGoal(back_assembly_station_);   
+    this->MoveToGoal(req->location, back_assembly_station_);   
 
     res->success = true;
     return;
@@ -171,7 +223,7 @@ void AGVPluginPrivate::MoveAGV(
   else if (req->location == ariac_msgs::srv::MoveAGV::Request::WAREHOUSE){
     RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Moving " << agv_number_ << " warehouse");
 
-    this->MoveToGoal(warehouse_location_);   
+    this->MoveToGoal(req->location, warehouse_location_);   
 
     res->success = true;
     return;
@@ -183,75 +235,81 @@ void AGVPluginPrivate::MoveAGV(
   
 }
 
-void AGVPluginPrivate::MoveToGoal(double goal){
-  int direction = 1;
-  if (agv_joint_->Position(0) > goal)
-  {
-    direction = -1;
+void AGVPluginPrivate::MoveToGoal(int location, double goal){
+  // Only record the goal here; the motion itself is advanced from OnUpdate so
+  // the service returns immediately and no executor thread is kept busy.
+  std::lock_guard<std::mutex> lock(motion_lock_);
+
+  if (moving_) {
+    PublishMoveStatus(ariac_msgs::msg::AGVMoveStatus::PREEMPTED);
   }
-  
-  double velocity = 0;
-  double acceleration = 2;
-  double stop_distance = 0.9;
-  rclcpp::Time start = ros_node_->get_clock()->now();
-  if (direction > 0){
-    while(agv_joint_->Position(0) < goal - stop_distance){
-      if (velocity >= max_velocity_){
-        velocity = max_velocity_;
-      } else {
-        rclcpp::Duration dur = ros_node_->get_clock()->now() - start;
-        double time = dur.nanoseconds() / 1e9;
-        velocity = time * acceleration;
-      }
-      this->PublishVelocity(velocity);
-    }
-
-    double maximum_velocity = velocity;
-
-    start = ros_node_->get_clock()->now();
-    while(agv_joint_->Position(0) < goal){
-      if (velocity <= 0){
-        break;
-      } else {
-        rclcpp::Duration dur = ros_node_->get_clock()->now() - start;
-        double time = dur.nanoseconds() / 1e9;
-        velocity = maximum_velocity - (time * acceleration);
-      }
-      this->PublishVelocity(velocity);
-    }
-
-    this->PublishVelocity(0.0);
+
+  goal_location_ = location;
+  goal_position_ = goal;
+  start_position_ = agv_joint_->Position(0);
+  move_direction_ = (goal_position_ >= start_position_) ? 1.0 : -1.0;
+  moving_ = true;
+
+  PublishMoveStatus(ariac_msgs::msg::AGVMoveStatus::MOVING);
+}
+
+void AGVPluginPrivate::StepMotion(double dt){
+  std::lock_guard<std::mutex> lock(motion_lock_);
+
+  if (!moving_)
+    return;
+
+  double error = goal_position_ - agv_joint_->Position(0);
+  double distance = std::abs(error);
+
+  // The goal is reached once the AGV is within tolerance or has passed it
+  if (distance <= goal_tolerance_ || error * move_direction_ < 0) {
+    commanded_velocity_ = 0.0;
+    PublishVelocity(commanded_velocity_);
+    moving_ = false;
+    PublishMoveStatus(ariac_msgs::msg::AGVMoveStatus::SUCCEEDED);
+    return;
   }
-  else {
-    while(agv_joint_->Position(0) > goal + stop_distance){
-      if (std::abs(velocity) >= max_velocity_){
-        velocity = -max_velocity_;
-      } else {
-        rclcpp::Duration dur = ros_node_->get_clock()->now() - start;
-        double time = dur.nanoseconds() / 1e9;
-        velocity = time * -acceleration;
-      }
-      this->PublishVelocity(velocity);
-    }
-
-    double maximum_velocity = velocity;
-
-    start = ros_node_->get_clock()->now();
-    while(agv_joint_->Position(0) > goal){
-      if (velocity >= 0){
-        break;
-      } else {
-        rclcpp::Duration dur = ros_node_->get_clock()->now() - start;
-        double time = dur.nanoseconds() / 1e9;
-        velocity = maximum_velocity + (time * acceleration);
-      }
-      this->PublishVelocity(velocity);
-    }
-
-    this->PublishVelocity(0.0);
+
+  // Trapezoidal profile: cruise at max velocity and ramp down so the AGV can
+  // stop at the goal with the allowed deceleration
+  double stopping_velocity = std::sqrt(2 * acceleration_ * distance);
+  double target_velocity = move_direction_ *
+    std::max(std::min(max_velocity_, stopping_velocity), min_velocity_);
+
+  // Limit the change in velocity to the allowed acceleration
+  double max_change = acceleration_ * dt;
+  commanded_velocity_ = std::max(commanded_velocity_ - max_change,
+    std::min(commanded_velocity_ + max_change, target_velocity));
+
+  PublishVelocity(commanded_velocity_);
+
+  // Report progress at the status rate
+  rclcpp::Time now = ros_node_->get_clock()->now();
+  if (now - last_publish_time_ >= rclcpp::Duration(0, update_ns_)) {
+    PublishMoveStatus(ariac_msgs::msg::AGVMoveStatus::MOVING);
   }
 }
 
+void AGVPluginPrivate::PublishMoveStatus(uint8_t state){
+  double position = agv_joint_->Position(0);
+  double total_distance = std::abs(goal_position_ - start_position_);
+
+  move_status_msg_.state = state;
+  move_status_msg_.goal_location = goal_location_;
+  move_status_msg_.goal_position = goal_position_;
+  move_status_msg_.position = position;
+  move_status_msg_.velocity = commanded_velocity_;
+
+  if (state == ariac_msgs::msg::AGVMoveStatus::SUCCEEDED || total_distance <= goal_tolerance_)
+    move_status_msg_.progress = 1.0;
+  else
+    move_status_msg_.progress = std::min(std::max(
+      1.0 - std::abs(goal_position_ - position) / total_distance, 0.0), 1.0);
+
+  move_status_pub_->publish(move_status_msg_);
+}
+
 void AGVPluginPrivate::PublishStatus(){
   double error_margin = 0.05; // m
 
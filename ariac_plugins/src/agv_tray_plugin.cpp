@@ -16,6 +16,7 @@ Distributions of NIST software should also include copyright and licensing state
 #include <gazebo/transport/Node.hh>
 
 #include <ariac_plugins/agv_tray_plugin.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 
 #include <gazebo_ros/node.hpp>
 #include <rclcpp/rclcpp.hpp>
@@ -58,6 +59,9 @@ public:
   gazebo::physics::CollisionPtr model_collision_;
   std::map<std::string, gazebo::physics::CollisionPtr> collisions_;
 
+  /// Latency of OnUpdate, shared by all the AGVs
+  ariac_common::LatencyHistogram * update_timing_{nullptr};
+
 
   bool CheckModelContact(ConstContactsPtr&);
   void AttachJoint();
@@ -132,12 +136,14 @@ void AGVTrayPlugin::Load(gazebo::physics::ModelPtr model, sdf::ElementPtr sdf)
 
   // Create a connection so the OnUpdate function is called at every simulation
   // iteration. Remove this call, the connection and the callback if not needed.
+  impl_->update_timing_ = ariac_common::TimingRegistry::Instance().Histogram("AGVTrayPlugin", "OnUpdate");
   impl_->update_connection_ = gazebo::event::Events::ConnectWorldUpdateBegin(
     std::bind(&AGVTrayPlugin::OnUpdate, this));
 }
 
 void AGVTrayPlugin::OnUpdate()
 {
+  ariac_common::ScopedTimer timer(impl_->update_timing_);
   // If gripper is enabled and in contact with gripable model attach joint
   if (impl_->locked_ && !impl_->tray_attached_ && impl_->in_contact_) {
     impl_->AttachJoint();
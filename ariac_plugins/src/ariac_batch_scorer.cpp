@@ -0,0 +1,145 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+// Rescore the submission snapshots written by the task manager at the end of a trial.
+//
+// Usage: ariac_batch_scorer [--jobs N] <snapshot>...
+//
+// Snapshots are scored concurrently and "<snapshot> <trial score>" is printed
+// for each of them, in the order they were given.
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+// ARIAC
+#include <ariac_plugins/ariac_scoring.hpp>
+
+namespace
+{
+    //==============================================================================
+    struct SnapshotResult
+    {
+        bool ok = false;
+        std::string error;
+        std::size_t submissions = 0;
+        double score = 0.0;
+    };
+
+    //==============================================================================
+    SnapshotResult ScoreSnapshot(const std::string &_path)
+    {
+        SnapshotResult result;
+
+        std::ifstream in(_path);
+        if (!in)
+        {
+            result.error = "cannot open file";
+            return result;
+        }
+
+        std::vector<ariac_scoring::Submission> submissions;
+        if (!ariac_scoring::ReadSubmissions(in, submissions, result.error))
+            return result;
+
+        for (const auto &submission : submissions)
+            result.score += ariac_scoring::ScoreSubmission(submission);
+
+        result.submissions = submissions.size();
+        result.ok = true;
+        return result;
+    }
+
+    //==============================================================================
+    void PrintUsage()
+    {
+        std::cerr << "Usage: ariac_batch_scorer [--jobs N] <snapshot>..." << std::endl;
+    }
+} // namespace
+
+//==============================================================================
+int main(int argc, char **argv)
+{
+    unsigned int jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--jobs" || arg == "-j")
+        {
+            if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0)
+            {
+                PrintUsage();
+                return 1;
+            }
+            jobs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--help" || arg == "-h")
+        {
+            PrintUsage();
+            return 0;
+        }
+        else
+        {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    jobs = std::min<unsigned int>(jobs, paths.size());
+
+    std::vector<SnapshotResult> results(paths.size());
+    std::atomic<std::size_t> next{0};
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Each worker claims the next unscored snapshot until none are left
+    std::vector<std::thread> workers;
+    for (unsigned int j = 0; j < jobs; j++)
+    {
+        workers.emplace_back([&]()
+                             {
+            for (std::size_t i = next++; i < paths.size(); i = next++)
+                results[i] = ScoreSnapshot(paths[i]); });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int status = 0;
+    std::size_t submissions = 0;
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        if (!results[i].ok)
+        {
+            std::cerr << paths[i] << ": " << results[i].error << std::endl;
+            status = 1;
+            continue;
+        }
+        submissions += results[i].submissions;
+        std::cout << paths[i] << " " << results[i].score << "\n";
+    }
+
+    std::cerr << "Scored " << submissions << " submissions from " << paths.size() << " snapshots with "
+              << jobs << " jobs in " << elapsed << " s" << std::endl;
+
+    return status;
+}
@@ -0,0 +1,761 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#include <ariac_plugins/ariac_scoring.hpp>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+// TF2
+#include <tf2/LinearMath/Matrix3x3.h>
+#include <tf2/LinearMath/Quaternion.h>
+// KDL
+#include <kdl/frames.hpp>
+#include <tf2_kdl/tf2_kdl.h>
+// Messages
+#include <ariac_msgs/msg/order.hpp>
+#include <ariac_msgs/msg/part.hpp>
+// ARIAC
+#include <ariac_plugins/model_name_classifier.hpp>
+
+namespace ariac_scoring
+{
+    namespace
+    {
+        //==============================================================================
+        /**
+         * @brief Parts of an insert scored against the products of an assembly or combined task
+         */
+        struct ScoredInsert
+        {
+            std::shared_ptr<ariac_common::ScoredAssemblyPart> battery;
+            std::shared_ptr<ariac_common::ScoredAssemblyPart> pump;
+            std::shared_ptr<ariac_common::ScoredAssemblyPart> regulator;
+            std::shared_ptr<ariac_common::ScoredAssemblyPart> sensor;
+            int parts_score = 0;
+        };
+
+        //==============================================================================
+        /**
+         * @brief Score the parts of an insert
+         *
+         * @param _products  Products of the task
+         * @param _shipment  Parts in the insert
+         * @param _full_score  Score of a part with the correct type, color and pose
+         * @param _partial_score  Score of a part with the correct type and either the correct color or pose
+         * @param _type_score  Score of a part with only the correct type
+         */
+        ScoredInsert ScoreInsertParts(const std::vector<ariac_common::AssemblyPart> &_products,
+                                      const ariac_common::AssemblyShipment &_shipment,
+                                      int _full_score, int _partial_score, int _type_score)
+        {
+            // 2 cm tolerance for the translation
+            const double translation_target{0.02};
+
+            ScoredInsert scored;
+
+            for (const auto &order_product : _products)
+            {
+                for (const auto &shipment_product : _shipment.GetInsertParts())
+                {
+                    auto shipment_part = shipment_product.GetPart();
+                    auto shipment_part_pose = shipment_product.GetPoseInInsert();
+                    auto order_part_pose = order_product.GetPartPose();
+
+                    bool is_correct_pose = true;
+                    bool is_correct_part_type = shipment_product.isCorrectType(order_product.GetPart().GetType());
+                    bool is_correct_part_color = shipment_product.isCorrectColor(order_product.GetPart().GetColor());
+
+                    if (!is_correct_part_type)
+                        continue;
+
+                    // Faulty parts are not used in assembly yet
+                    bool is_faulty = false;
+
+                    // compute translation distance
+                    ignition::math::Vector3d position_diff(
+                        order_part_pose.X() - shipment_part_pose.position.x,
+                        order_part_pose.Y() - shipment_part_pose.position.y,
+                        order_part_pose.Z() - shipment_part_pose.position.z);
+
+                    if (position_diff.Length() > translation_target)
+                        is_correct_pose = false;
+
+                    // compute orientation distance
+                    ignition::math::Quaterniond order_part_q(
+                        order_part_pose.Rot().W(),
+                        order_part_pose.Rot().X(),
+                        order_part_pose.Rot().Y(),
+                        order_part_pose.Rot().Z());
+
+                    ignition::math::Quaterniond shipment_part_q(
+                        shipment_part_pose.orientation.w,
+                        shipment_part_pose.orientation.x,
+                        shipment_part_pose.orientation.y,
+                        shipment_part_pose.orientation.z);
+
+                    // Filter products that aren't in the appropriate orientation (loosely).
+                    // If the quaternions represent the same orientation, q1 = +-q2 => q1.dot(q2) = +-1
+                    const double orientation_diff = shipment_part_q.Dot(order_part_q);
+                    const double orientation_threshold = 0.05;
+
+                    if (std::abs(orientation_diff) < (1.0 - orientation_threshold))
+                        is_correct_pose = false;
+
+                    // Compute the score for this part
+                    int part_score = 0;
+                    if (is_faulty)
+                        part_score = 0;
+                    else if (is_correct_part_color && is_correct_pose)
+                        part_score = _full_score;
+                    else if (is_correct_part_color || is_correct_pose)
+                        part_score = _partial_score;
+                    else
+                        part_score = _type_score;
+
+                    // Part orientation in RPY for display
+                    tf2::Quaternion q(
+                        shipment_part_pose.orientation.x,
+                        shipment_part_pose.orientation.y,
+                        shipment_part_pose.orientation.z,
+                        shipment_part_pose.orientation.w);
+
+                    tf2::Matrix3x3 m(q);
+                    double roll, pitch, yaw;
+                    m.getRPY(roll, pitch, yaw);
+
+                    geometry_msgs::msg::Vector3 part_position;
+                    part_position.x = shipment_part_pose.position.x;
+                    part_position.y = shipment_part_pose.position.y;
+                    part_position.z = shipment_part_pose.position.z;
+
+                    geometry_msgs::msg::Vector3 part_orientation;
+                    part_orientation.x = roll;
+                    part_orientation.y = pitch;
+                    part_orientation.z = yaw;
+
+                    auto scored_part = std::make_shared<ariac_common::ScoredAssemblyPart>(
+                        shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, is_faulty);
+
+                    auto type = order_product.GetPart().GetType();
+                    if (type == ariac_msgs::msg::Part::BATTERY)
+                        scored.battery = scored_part;
+                    else if (type == ariac_msgs::msg::Part::PUMP)
+                        scored.pump = scored_part;
+                    else if (type == ariac_msgs::msg::Part::REGULATOR)
+                        scored.regulator = scored_part;
+                    else if (type == ariac_msgs::msg::Part::SENSOR)
+                        scored.sensor = scored_part;
+
+                    scored.parts_score += part_score;
+                }
+            }
+
+            return scored;
+        }
+
+        //==============================================================================
+        /**
+         * @brief Products and shipment parts of a submission being read
+         */
+        struct PendingSubmission
+        {
+            Submission submission;
+            bool has_kitting_task = false;
+            unsigned int agv = 0, tray_id = 0, destination = 0;
+            std::vector<ariac_common::KittingPart> kitting_products;
+            bool has_assembly_task = false, has_combined_task = false;
+            unsigned int station = 0;
+            std::vector<unsigned int> agvs;
+            std::vector<ariac_common::AssemblyPart> assembly_products;
+            bool has_kit_tray = false;
+            unsigned int kit_tray_id = 0;
+            std::vector<ariac_common::KitTrayPart> tray_parts;
+            bool has_insert = false;
+            unsigned int insert_station = 0;
+            std::vector<ariac_common::InsertPart> insert_parts;
+
+            Submission Build()
+            {
+                if (has_kitting_task)
+                    submission.kitting_task = std::make_shared<ariac_common::KittingTask>(agv, tray_id, destination, kitting_products);
+                if (has_assembly_task)
+                    submission.assembly_task = std::make_shared<ariac_common::AssemblyTask>(agvs, station, assembly_products);
+                if (has_combined_task)
+                    submission.combined_task = std::make_shared<ariac_common::CombinedTask>(station, assembly_products);
+                if (has_kit_tray)
+                    submission.kitting_shipment = std::make_shared<ariac_common::KittingShipment>(kit_tray_id, tray_parts);
+                if (has_insert)
+                    submission.assembly_shipment = std::make_shared<ariac_common::AssemblyShipment>(insert_station, insert_parts);
+                return submission;
+            }
+        };
+
+        //==============================================================================
+        void WritePose(std::ostream &_out, const geometry_msgs::msg::Pose &_pose)
+        {
+            _out << _pose.position.x << " " << _pose.position.y << " " << _pose.position.z << " "
+                 << _pose.orientation.x << " " << _pose.orientation.y << " " << _pose.orientation.z << " "
+                 << _pose.orientation.w;
+        }
+
+        //==============================================================================
+        bool ReadPose(std::istream &_in, geometry_msgs::msg::Pose &_pose)
+        {
+            return static_cast<bool>(_in >> _pose.position.x >> _pose.position.y >> _pose.position.z >>
+                                     _pose.orientation.x >> _pose.orientation.y >> _pose.orientation.z >>
+                                     _pose.orientation.w);
+        }
+
+        //==============================================================================
+        void WriteAssemblyProducts(std::ostream &_out, const std::vector<ariac_common::AssemblyPart> &_products)
+        {
+            for (const auto &product : _products)
+            {
+                auto pose = product.GetPartPose();
+                auto direction = product.GetPartDirection();
+                _out << "assembly_product " << product.GetPart().GetType() << " " << product.GetPart().GetColor() << " "
+                     << pose.Pos().X() << " " << pose.Pos().Y() << " " << pose.Pos().Z() << " "
+                     << pose.Rot().X() << " " << pose.Rot().Y() << " " << pose.Rot().Z() << " " << pose.Rot().W() << " "
+                     << direction.X() << " " << direction.Y() << " " << direction.Z() << "\n";
+            }
+        }
+    } // namespace
+
+    //==============================================================================
+    ariac_common::KittingShipment ParseKittingShipment(const std::vector<SensedModel> &_models)
+    {
+        KDL::Frame sensor_to_tray;
+        int kit_tray_id = -1;
+        std::vector<ariac_common::KitTrayPart> tray_parts;
+
+        // Find Kit Tray
+        for (const auto &model : _models)
+        {
+            const auto info = ariac_common::ClassifyModelName(model.name);
+            if (info.IsKitTray())
+            {
+                kit_tray_id = info.tray_id;
+                tf2::fromMsg(model.pose, sensor_to_tray);
+            }
+        }
+
+        // If no kit tray is detected return an empty shipment
+        if (kit_tray_id == -1)
+            return ariac_common::KittingShipment(kit_tray_id, tray_parts);
+
+        // Fill vector of KitTrayParts
+        for (const auto &model : _models)
+        {
+            const auto info = ariac_common::ClassifyModelName(model.name);
+            if (!info.IsPart())
+                continue;
+
+            // Get pose on tray
+            KDL::Frame sensor_to_part;
+            tf2::fromMsg(model.pose, sensor_to_part);
+            KDL::Frame tray_to_part = sensor_to_tray.Inverse() * sensor_to_part;
+
+            tray_parts.emplace_back(ariac_common::Part(info.color, info.type), model.name, tf2::toMsg(tray_to_part));
+        }
+
+        return ariac_common::KittingShipment(kit_tray_id, tray_parts);
+    }
+
+    //==============================================================================
+    ariac_common::AssemblyShipment ParseAssemblyShipment(const std::vector<SensedModel> &_models)
+    {
+        KDL::Frame sensor_to_insert;
+        int insert_id = -1;
+        std::vector<ariac_common::InsertPart> insert_parts;
+
+        // Find insert
+        for (const auto &model : _models)
+        {
+            const auto info = ariac_common::ClassifyModelName(model.name);
+            if (info.IsInsert())
+            {
+                insert_id = info.insert_id;
+                tf2::fromMsg(model.pose, sensor_to_insert);
+            }
+        }
+
+        // If no insert is detected return an empty shipment
+        if (insert_id == -1)
+            return ariac_common::AssemblyShipment(insert_id, insert_parts);
+
+        // Fill vector of InsertParts
+        for (const auto &model : _models)
+        {
+            const auto info = ariac_common::ClassifyModelName(model.name);
+            if (!info.IsPart())
+                continue;
+
+            // Get pose in insert
+            KDL::Frame sensor_to_part;
+            tf2::fromMsg(model.pose, sensor_to_part);
+            KDL::Frame insert_to_part = sensor_to_insert.Inverse() * sensor_to_part;
+
+            insert_parts.emplace_back(ariac_common::Part(info.color, info.type), model.name, tf2::toMsg(insert_to_part));
+        }
+
+        return ariac_common::AssemblyShipment(insert_id, insert_parts);
+    }
+
+    //==============================================================================
+    int ScoreQuadrant(bool is_correct_part_type, bool is_correct_part_color, bool is_flipped_part, bool is_faulty_part)
+    {
+        bool B = is_correct_part_type;
+        bool C = is_correct_part_color;
+        bool D = is_flipped_part;
+        bool E = is_faulty_part;
+
+        if (!B || E)
+            return 0;
+
+        if (B && C && !D && !E)
+            return 3;
+
+        if (B && !C && !D && !E)
+            return 2;
+
+        if (B && C && D && !E)
+            return 2;
+
+        if (B && !C && D && !E)
+            return 1;
+
+        return 0;
+    }
+
+    //==============================================================================
+    std::array<bool, 4> FindFaultyParts(ariac_common::FaultyPartChallenge &_challenge,
+                                        const ariac_common::KittingTask &_task,
+                                        const ariac_common::KittingShipment &_shipment,
+                                        std::vector<std::pair<int, std::string>> &_newly_faulty)
+    {
+        // quadrant1, quadrant2, quadrant3, quadrant4
+        std::array<bool, 4> faulty_parts = {false, false, false, false};
+
+        for (int i = 1; i < 5; i++)
+        {
+            if (!_challenge.IsQuadrantFaulty(i))
+                continue;
+
+            if (!_challenge.WasQuadrantChecked(i))
+            {
+                // Every part of the ordered type and color found in the quadrant becomes faulty
+                for (const auto &product : _task.GetProducts())
+                {
+                    if (product.GetQuadrant() != static_cast<unsigned int>(i))
+                        continue;
+
+                    for (const auto &tray_part : _shipment.GetTrayParts())
+                    {
+                        if (tray_part.GetQuadrant() == static_cast<unsigned int>(i) &&
+                            tray_part.isCorrectType(product.GetPart().GetType()) &&
+                            tray_part.isCorrectColor(product.GetPart().GetColor()))
+                        {
+                            _challenge.SetQuadrantChecked(i);
+                            _newly_faulty.emplace_back(i, tray_part.GetModelName());
+                            faulty_parts[i - 1] = true;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                for (const auto &tray_part : _shipment.GetTrayParts())
+                {
+                    if (tray_part.GetQuadrant() == static_cast<unsigned int>(i))
+                        faulty_parts[i - 1] = tray_part.isFaulty();
+                }
+            }
+        }
+        return faulty_parts;
+    }
+
+    //==============================================================================
+    std::shared_ptr<ariac_common::KittingScore> ScoreKittingTask(const std::string &_order_id,
+                                                                 const ariac_common::KittingTask &_task,
+                                                                 const ariac_common::KittingShipment &_shipment,
+                                                                 int _agv_location,
+                                                                 const std::array<bool, 4> &_faulty_parts)
+    {
+        std::shared_ptr<ariac_common::Quadrant> quadrant1_ptr = nullptr;
+        std::shared_ptr<ariac_common::Quadrant> quadrant2_ptr = nullptr;
+        std::shared_ptr<ariac_common::Quadrant> quadrant3_ptr = nullptr;
+        std::shared_ptr<ariac_common::Quadrant> quadrant4_ptr = nullptr;
+
+        // Bonus points for completing the order
+        int bonus = 0;
+        // Points for correct tray
+        int tray_score = 0;
+        // destination
+        int destination_score = 1;
+        // penalty for having extra parts
+        int penalty = 0;
+
+        int expected_number_of_parts = _task.GetProducts().size();
+
+        std::map<int, int> quadrant_scores = {{1, 0}, {2, 0}, {3, 0}, {4, 0}};
+
+        for (const auto &product : _task.GetProducts())
+        {
+            for (const auto &tray_part : _shipment.GetTrayParts())
+            {
+                if (tray_part.GetQuadrant() != product.GetQuadrant())
+                    continue;
+
+                auto quadrant = product.GetQuadrant();
+                bool is_correct_part_type = tray_part.isCorrectType(product.GetPart().GetType());
+                bool is_correct_part_color = tray_part.isCorrectColor(product.GetPart().GetColor());
+                bool is_faulty_part = quadrant >= 1 && quadrant <= 4 && _faulty_parts[quadrant - 1];
+                bool is_flipped_part = tray_part.isFlipped();
+
+                quadrant_scores[quadrant] = ScoreQuadrant(is_correct_part_type, is_correct_part_color, is_flipped_part, is_faulty_part);
+
+                auto quadrant_ptr = std::make_shared<ariac_common::Quadrant>(quadrant, is_correct_part_type, is_correct_part_color, is_faulty_part, is_flipped_part, quadrant_scores[quadrant]);
+                if (quadrant == 1)
+                    quadrant1_ptr = quadrant_ptr;
+                else if (quadrant == 2)
+                    quadrant2_ptr = quadrant_ptr;
+                else if (quadrant == 3)
+                    quadrant3_ptr = quadrant_ptr;
+                else if (quadrant == 4)
+                    quadrant4_ptr = quadrant_ptr;
+            }
+        }
+
+        // Check isCorrectTrayId
+        if (_task.GetTrayId() == _shipment.GetTrayId())
+            tray_score = 3;
+
+        // Sum quadrant scores
+        int total_quadrants_score = quadrant_scores[1] + quadrant_scores[2] + quadrant_scores[3] + quadrant_scores[4];
+
+        // Compute bonus
+        if (total_quadrants_score == 3 * expected_number_of_parts)
+            bonus = expected_number_of_parts;
+
+        // Compute penalty for having extra parts in the tray
+        int number_of_tray_parts = _shipment.GetTrayParts().size();
+        if (number_of_tray_parts > expected_number_of_parts)
+            penalty = number_of_tray_parts - expected_number_of_parts;
+
+        // Check destination
+        if (_agv_location != static_cast<int>(_task.GetDestination()))
+            destination_score = 0;
+
+        // Compute the score for the submitted kit
+        int kit_score = std::max(tray_score + total_quadrants_score + bonus - penalty, 0) * destination_score;
+
+        return std::make_shared<ariac_common::KittingScore>(
+            _order_id,
+            kit_score,
+            tray_score,
+            quadrant1_ptr,
+            quadrant2_ptr,
+            quadrant3_ptr,
+            quadrant4_ptr,
+            bonus,
+            penalty,
+            _task.GetAgvNumber(),
+            destination_score);
+    }
+
+    //==============================================================================
+    std::shared_ptr<ariac_common::AssemblyScore> ScoreAssemblyTask(const std::string &_order_id,
+                                                                   const ariac_common::AssemblyTask &_task,
+                                                                   const ariac_common::AssemblyShipment &_shipment)
+    {
+        int expected_number_of_parts = _task.GetProducts().size();
+
+        auto scored = ScoreInsertParts(_task.GetProducts(), _shipment, 3, 2, 1);
+
+        // Check isCorrectStation
+        int station_score = _task.GetStation() == _shipment.GetStation() ? 1 : 0;
+
+        // Compute bonus points
+        int bonus = 0;
+        if (scored.parts_score == expected_number_of_parts * 3)
+            bonus = expected_number_of_parts * 4;
+
+        // Compute the score for the submitted shipment
+        int insert_score = (scored.parts_score + bonus) * station_score;
+
+        return std::make_shared<ariac_common::AssemblyScore>(
+            _order_id,
+            insert_score,
+            _shipment.GetStation(),
+            scored.battery,
+            scored.pump,
+            scored.regulator,
+            scored.sensor,
+            bonus);
+    }
+
+    //==============================================================================
+    std::shared_ptr<ariac_common::CombinedScore> ScoreCombinedTask(const std::string &_order_id,
+                                                                   const ariac_common::CombinedTask &_task,
+                                                                   const ariac_common::AssemblyShipment &_shipment)
+    {
+        int expected_number_of_parts = _task.GetProducts().size();
+
+        auto scored = ScoreInsertParts(_task.GetProducts(), _shipment, 5, 4, 3);
+
+        // Check isCorrectStation
+        int station_score = _task.GetStation() == _shipment.GetStation() ? 1 : 0;
+
+        // Compute bonus points
+        int bonus = 0;
+        if (scored.parts_score == expected_number_of_parts * 5)
+            bonus = expected_number_of_parts * 4;
+
+        // Compute the score for the submitted shipment
+        int insert_score = (scored.parts_score + bonus) * station_score;
+
+        return std::make_shared<ariac_common::CombinedScore>(
+            _order_id,
+            insert_score,
+            _shipment.GetStation(),
+            scored.battery,
+            scored.pump,
+            scored.regulator,
+            scored.sensor,
+            bonus);
+    }
+
+    //==============================================================================
+    int ScoreSubmission(const Submission &_submission)
+    {
+        if (_submission.kitting_task && _submission.kitting_shipment)
+            return ScoreKittingTask(_submission.order_id, *_submission.kitting_task, *_submission.kitting_shipment,
+                                    _submission.agv_location, _submission.faulty_parts)
+                ->GetScore();
+
+        if (_submission.assembly_task && _submission.assembly_shipment)
+            return ScoreAssemblyTask(_submission.order_id, *_submission.assembly_task, *_submission.assembly_shipment)->GetScore();
+
+        if (_submission.combined_task && _submission.assembly_shipment)
+            return ScoreCombinedTask(_submission.order_id, *_submission.combined_task, *_submission.assembly_shipment)->GetScore();
+
+        return 0;
+    }
+
+    //==============================================================================
+    double ComputeTrialScore(const std::vector<std::shared_ptr<ariac_common::Order>> &_orders)
+    {
+        double trial_score = 0;
+        for (const auto &order : _orders)
+        {
+            if (order->GetKittingScore())
+                trial_score += order->GetKittingScore()->GetScore();
+            if (order->GetAssemblyScore())
+                trial_score += order->GetAssemblyScore()->GetScore();
+            if (order->GetCombinedScore())
+                trial_score += order->GetCombinedScore()->GetScore();
+        }
+        return trial_score;
+    }
+
+    //==============================================================================
+    void WriteSubmissions(std::ostream &_out, const std::vector<Submission> &_submissions)
+    {
+        auto precision = _out.precision(std::numeric_limits<double>::max_digits10);
+
+        for (const auto &submission : _submissions)
+        {
+            _out << "submission " << submission.order_id << " " << submission.type << " " << submission.submitted_time << "\n";
+
+            if (submission.kitting_task)
+            {
+                const auto &task = *submission.kitting_task;
+                _out << "kitting_task " << task.GetAgvNumber() << " " << task.GetTrayId() << " " << task.GetDestination() << "\n";
+                for (const auto &product : task.GetProducts())
+                    _out << "kitting_product " << product.GetQuadrant() << " " << product.GetPart().GetType() << " "
+                         << product.GetPart().GetColor() << "\n";
+            }
+
+            if (submission.assembly_task)
+            {
+                const auto &task = *submission.assembly_task;
+                _out << "assembly_task " << task.GetStation() << " " << task.GetAgvNumbers().size();
+                for (auto agv : task.GetAgvNumbers())
+                    _out << " " << agv;
+                _out << "\n";
+                WriteAssemblyProducts(_out, task.GetProducts());
+            }
+
+            if (submission.combined_task)
+            {
+                _out << "combined_task " << submission.combined_task->GetStation() << "\n";
+                WriteAssemblyProducts(_out, submission.combined_task->GetProducts());
+            }
+
+            _out << "agv_location " << submission.agv_location << "\n";
+            _out << "faulty_parts " << submission.faulty_parts[0] << " " << submission.faulty_parts[1] << " "
+                 << submission.faulty_parts[2] << " " << submission.faulty_parts[3] << "\n";
+
+            if (submission.kitting_shipment)
+            {
+                _out << "kit_tray " << submission.kitting_shipment->GetTrayId() << "\n";
+                for (const auto &part : submission.kitting_shipment->GetTrayParts())
+                {
+                    _out << "tray_part " << part.GetModelName() << " " << part.GetPart().GetType() << " "
+                         << part.GetPart().GetColor() << " ";
+                    WritePose(_out, part.GetPoseOnTray());
+                    _out << "\n";
+                }
+            }
+
+            if (submission.assembly_shipment)
+            {
+                _out << "insert " << submission.assembly_shipment->GetStation() << "\n";
+                for (const auto &part : submission.assembly_shipment->GetInsertParts())
+                {
+                    _out << "insert_part " << part.GetModelName() << " " << part.GetPart().GetType() << " "
+                         << part.GetPart().GetColor() << " ";
+                    WritePose(_out, part.GetPoseInInsert());
+                    _out << "\n";
+                }
+            }
+
+            _out << "end\n";
+        }
+
+        _out.precision(precision);
+    }
+
+    //==============================================================================
+    bool ReadSubmissions(std::istream &_in, std::vector<Submission> &_submissions, std::string &_error)
+    {
+        std::unique_ptr<PendingSubmission> pending;
+        std::string line;
+        int line_number = 0;
+
+        auto fail = [&](const std::string &_reason)
+        {
+            _error = "line " + std::to_string(line_number) + ": " + _reason;
+            return false;
+        };
+
+        while (std::getline(_in, line))
+        {
+            line_number++;
+
+            std::istringstream fields(line);
+            std::string keyword;
+            if (!(fields >> keyword) || keyword[0] == '#')
+                continue;
+
+            if (keyword == "submission")
+            {
+                if (pending)
+                    return fail("missing end of submission " + pending->submission.order_id);
+                pending = std::make_unique<PendingSubmission>();
+                if (!(fields >> pending->submission.order_id >> pending->submission.type >> pending->submission.submitted_time))
+                    return fail("malformed submission");
+                continue;
+            }
+
+            if (!pending)
+                return fail("'" + keyword + "' outside of a submission");
+
+            bool ok = true;
+            if (keyword == "end")
+            {
+                _submissions.push_back(pending->Build());
+                pending.reset();
+            }
+            else if (keyword == "kitting_task")
+            {
+                pending->has_kitting_task = true;
+                ok = static_cast<bool>(fields >> pending->agv >> pending->tray_id >> pending->destination);
+            }
+            else if (keyword == "kitting_product")
+            {
+                unsigned int quadrant, type, color;
+                ok = static_cast<bool>(fields >> quadrant >> type >> color);
+                if (ok)
+                    pending->kitting_products.emplace_back(quadrant, ariac_common::Part(color, type));
+            }
+            else if (keyword == "assembly_task" || keyword == "combined_task")
+            {
+                (keyword == "assembly_task" ? pending->has_assembly_task : pending->has_combined_task) = true;
+                ok = static_cast<bool>(fields >> pending->station);
+                std::size_t agv_count = 0;
+                if (ok && keyword == "assembly_task")
+                    ok = static_cast<bool>(fields >> agv_count);
+                for (std::size_t i = 0; ok && i < agv_count; i++)
+                {
+                    unsigned int agv;
+                    ok = static_cast<bool>(fields >> agv);
+                    pending->agvs.push_back(agv);
+                }
+            }
+            else if (keyword == "assembly_product")
+            {
+                unsigned int type, color;
+                double x, y, z, qx, qy, qz, qw, dx, dy, dz;
+                ok = static_cast<bool>(fields >> type >> color >> x >> y >> z >> qx >> qy >> qz >> qw >> dx >> dy >> dz);
+                if (ok)
+                    pending->assembly_products.emplace_back(ariac_common::Part(color, type),
+                                                            ignition::math::Pose3d(x, y, z, qw, qx, qy, qz),
+                                                            ignition::math::Vector3d(dx, dy, dz));
+            }
+            else if (keyword == "agv_location")
+            {
+                ok = static_cast<bool>(fields >> pending->submission.agv_location);
+            }
+            else if (keyword == "faulty_parts")
+            {
+                auto &faulty = pending->submission.faulty_parts;
+                ok = static_cast<bool>(fields >> faulty[0] >> faulty[1] >> faulty[2] >> faulty[3]);
+            }
+            else if (keyword == "kit_tray")
+            {
+                pending->has_kit_tray = true;
+                ok = static_cast<bool>(fields >> pending->kit_tray_id);
+            }
+            else if (keyword == "insert")
+            {
+                pending->has_insert = true;
+                ok = static_cast<bool>(fields >> pending->insert_station);
+            }
+            else if (keyword == "tray_part" || keyword == "insert_part")
+            {
+                std::string model_name;
+                unsigned int type, color;
+                geometry_msgs::msg::Pose pose;
+                ok = static_cast<bool>(fields >> model_name >> type >> color) && ReadPose(fields, pose);
+                if (ok && keyword == "tray_part")
+                    pending->tray_parts.emplace_back(ariac_common::Part(color, type), model_name, pose);
+                else if (ok)
+                    pending->insert_parts.emplace_back(ariac_common::Part(color, type), model_name, pose);
+            }
+            else
+            {
+                return fail("unknown keyword '" + keyword + "'");
+            }
+
+            if (!ok)
+                return fail("malformed " + keyword);
+        }
+
+        if (pending)
+            return fail("missing end of submission " + pending->submission.order_id);
+
+        return true;
+    }
+
+} // namespace ariac_scoring
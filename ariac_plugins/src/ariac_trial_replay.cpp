@@ -0,0 +1,584 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+// Replay trial captures recorded by the task manager (ARIAC_CAPTURE_FILE) without Gazebo.
+//
+// Usage: ariac_trial_replay [--jobs N] [--tolerance S] [--verbose] <capture>...
+//
+// Sensor images, AGV statuses, quality checks and submissions are fed to the
+// same parsing and scoring code the task manager uses. Scores computed during
+// the recorded trial are compared with the replayed ones and every difference
+// is reported. "<capture> <replayed trial score>" is printed for each capture,
+// in the order they were given.
+//
+// The announcement conditions of the orders and challenges are registered with
+// the timed event, part placement and submission triggers of the task manager,
+// which are then driven by the recorded images, submissions and times. Orders
+// announced and challenges started more than S seconds (0.05 by default) away
+// from the recorded time, or not at all, are reported as differences.
+
+// C++
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+// Messages
+#include <ariac_msgs/msg/challenge.hpp>
+#include <ariac_msgs/msg/condition.hpp>
+#include <ariac_msgs/msg/order.hpp>
+#include <ariac_msgs/msg/trial.hpp>
+// ARIAC
+#include <ariac_plugins/ariac_scoring.hpp>
+#include <ariac_plugins/model_name_classifier.hpp>
+#include <ariac_plugins/task_manager_plugin.hpp>
+#include <ariac_plugins/trial_capture.hpp>
+
+namespace
+{
+    //==============================================================================
+    struct ReplayResult
+    {
+        bool ok = false;
+        std::string error;
+        std::size_t records = 0;
+        std::size_t submissions = 0;
+        double trial_score = 0.0;
+        //! Differences between the recorded and the replayed scores, announcements and challenges
+        std::vector<std::string> mismatches;
+        //! Announcements and challenges, printed with --verbose
+        std::vector<std::string> timeline;
+    };
+
+    //==============================================================================
+    // Description of a challenge in the CHALLENGE_STARTED records of the task manager
+    std::string ChallengeDescription(unsigned int _type)
+    {
+        switch (_type)
+        {
+        case ariac_msgs::msg::Challenge::SENSOR_BLACKOUT:
+            return "sensor blackout";
+        case ariac_msgs::msg::Challenge::ROBOT_MALFUNCTION:
+            return "robot malfunction";
+        case ariac_msgs::msg::Challenge::HUMAN:
+            return "human";
+        default:
+            return "challenge " + std::to_string(_type);
+        }
+    }
+
+    //==============================================================================
+    /**
+     * @brief State of the task manager rebuilt from the records of a capture
+     */
+    class TrialReplay
+    {
+    public:
+        TrialReplay(ReplayResult &_result, double _tolerance) : result_(_result), tolerance_(_tolerance) {}
+
+        bool Apply(ariac_capture::Record &_record);
+        void Finish();
+
+    private:
+        std::string Describe(const ariac_capture::Record &_record, const std::string &_event) const;
+        void AdvanceTo(double _sim_time);
+        void AddTriggers(const ariac_msgs::msg::Trial &_trial);
+        void AddTrigger(const ariac_msgs::msg::Condition &_condition, const std::string &_event);
+        void PlaceParts(unsigned int _agv);
+        void CompareTriggers();
+        void FaultyParts(const std::string &_order_id,
+                         const ariac_common::KittingTask &_task,
+                         const ariac_common::KittingShipment &_shipment,
+                         std::array<bool, 4> &_faulty_parts);
+        void QualityCheck(const std::string &_order_id);
+        void SubmitOrder(const std::string &_order_id, double _sim_time);
+
+        ReplayResult &result_;
+        std::map<unsigned int, std::vector<ariac_scoring::SensedModel>> tray_images_;
+        std::map<unsigned int, std::vector<ariac_scoring::SensedModel>> station_images_;
+        std::map<unsigned int, int> agv_locations_;
+        std::map<std::string, std::shared_ptr<ariac_common::Order>> orders_;
+        std::vector<std::shared_ptr<ariac_common::FaultyPartChallenge>> faulty_part_challenges_;
+        std::map<std::string, int> replayed_scores_;
+        bool has_trial_end_ = false;
+        double recorded_trial_score_ = 0.0;
+
+        //! Runs the announcement triggers, it is never loaded in a world
+        ariac_plugins::TaskManagerPlugin triggers_;
+        bool has_trial_config_ = false;
+        double tolerance_;
+        double sim_time_ = 0.0;
+        //! Parts on the kit tray of each AGV, as the task manager stores them for the part placement triggers
+        std::map<unsigned int, std::vector<ariac_common::Part>> tray_parts_;
+        //! Times of the order announcements and challenge starts, by event
+        std::map<std::string, std::vector<double>> recorded_events_;
+        std::map<std::string, std::vector<double>> replayed_events_;
+    };
+
+    //==============================================================================
+    std::string TrialReplay::Describe(const ariac_capture::Record &_record, const std::string &_event) const
+    {
+        std::ostringstream out;
+        out << "t=" << _record.sim_time << " " << _event;
+        return out.str();
+    }
+
+    //==============================================================================
+    void TrialReplay::AdvanceTo(double _sim_time)
+    {
+        // The task manager runs the timed events on every world update, the records are
+        // the only updates here so timed events fire late and report their due time
+        sim_time_ = _sim_time;
+        triggers_.SetElapsedTime(_sim_time);
+        triggers_.ProcessTimedEvents();
+    }
+
+    //==============================================================================
+    void TrialReplay::AddTriggers(const ariac_msgs::msg::Trial &_trial)
+    {
+        for (const auto &order : _trial.order_conditions)
+            AddTrigger(order.condition, "order " + order.id + " announced");
+
+        for (const auto &challenge : _trial.challenges)
+        {
+            auto event = "challenge started: " + ChallengeDescription(challenge.type);
+            if (challenge.type == ariac_msgs::msg::Challenge::SENSOR_BLACKOUT)
+                AddTrigger(challenge.sensor_blackout_challenge.condition, event);
+            else if (challenge.type == ariac_msgs::msg::Challenge::ROBOT_MALFUNCTION)
+                AddTrigger(challenge.robot_malfunction_challenge.condition, event);
+            else if (challenge.type == ariac_msgs::msg::Challenge::HUMAN)
+                AddTrigger(challenge.human_challenge.condition, event);
+        }
+        has_trial_config_ = true;
+    }
+
+    //==============================================================================
+    void TrialReplay::AddTrigger(const ariac_msgs::msg::Condition &_condition, const std::string &_event)
+    {
+        // Same triggers as TaskManagerPlugin::StoreOrders and the Store*Challenges, with an action that records the time
+        if (_condition.type == ariac_msgs::msg::Condition::TIME)
+        {
+            double due = _condition.time_condition.seconds;
+            triggers_.ScheduleTimedEvent(due, [this, _event, due]()
+                                         { replayed_events_[_event].push_back(due); });
+        }
+        else if (_condition.type == ariac_msgs::msg::Condition::PART_PLACE)
+        {
+            const auto &part = _condition.part_place_condition.part;
+            triggers_.AddPartPlacementTrigger(_condition.part_place_condition.agv,
+                                              std::make_shared<ariac_common::Part>(part.color, part.type),
+                                              [this, _event]()
+                                              { replayed_events_[_event].push_back(sim_time_); });
+        }
+        else if (_condition.type == ariac_msgs::msg::Condition::SUBMISSION)
+        {
+            triggers_.AddSubmissionTrigger(_condition.submission_condition.order_id, [this, _event]()
+                                           { replayed_events_[_event].push_back(sim_time_); });
+        }
+    }
+
+    //==============================================================================
+    void TrialReplay::PlaceParts(unsigned int _agv)
+    {
+        // Same parts as TaskManagerPluginPrivate::StoreAGVParts, none when no kit tray is seen
+        std::vector<ariac_common::Part> parts;
+        bool has_kit_tray = false;
+        for (const auto &model : tray_images_[_agv])
+        {
+            const auto info = ariac_common::ClassifyModelName(model.name);
+            if (info.IsKitTray())
+                has_kit_tray = true;
+            else if (info.IsPart())
+                parts.push_back(ariac_common::Part(info.color, info.type));
+        }
+        if (!has_kit_tray)
+            parts.clear();
+
+        triggers_.QueueAddedAGVParts(_agv, tray_parts_[_agv], parts);
+        tray_parts_[_agv] = std::move(parts);
+        triggers_.ProcessPartPlacementTriggers();
+    }
+
+    //==============================================================================
+    bool TrialReplay::Apply(ariac_capture::Record &_record)
+    {
+        auto &payload = _record.payload;
+        uint32_t id;
+        std::string order_id;
+
+        AdvanceTo(_record.sim_time);
+
+        switch (_record.type)
+        {
+        case ariac_capture::TRAY_IMAGE:
+            if (!payload.U32(id) || !payload.Models(tray_images_[id]))
+                return false;
+            PlaceParts(id);
+            return true;
+
+        case ariac_capture::STATION_IMAGE:
+            return payload.U32(id) && payload.Models(station_images_[id]);
+
+        case ariac_capture::AGV_STATUS:
+        {
+            int32_t location;
+            if (!payload.U32(id) || !payload.I32(location))
+                return false;
+            agv_locations_[id] = location;
+            return true;
+        }
+
+        case ariac_capture::ORDER_ANNOUNCED:
+        {
+            auto order = ariac_capture::ReadOrder(payload);
+            if (!order)
+                return false;
+            order->SetAnnouncedTime(_record.sim_time);
+            order->SetIsAnnounced();
+            orders_[order->GetId()] = order;
+            recorded_events_["order " + order->GetId() + " announced"].push_back(_record.sim_time);
+            result_.timeline.push_back(Describe(_record, "order " + order->GetId() + " announced"));
+            return true;
+        }
+
+        case ariac_capture::CHALLENGE_STARTED:
+        {
+            std::string description;
+            if (!payload.U32(id) || !payload.String(description))
+                return false;
+            recorded_events_["challenge started: " + description].push_back(_record.sim_time);
+            result_.timeline.push_back(Describe(_record, "challenge started: " + description));
+            return true;
+        }
+
+        case ariac_capture::TRIAL_CONFIG:
+        {
+            ariac_msgs::msg::Trial trial;
+            if (!ariac_capture::ReadTrialConfig(payload, trial))
+                return false;
+            AddTriggers(trial);
+            return true;
+        }
+
+        case ariac_capture::FAULTY_PART_CHALLENGE:
+        {
+            ariac_msgs::msg::FaultyPartChallenge challenge;
+            if (!ariac_capture::ReadFaultyPartChallenge(payload, challenge))
+                return false;
+            faulty_part_challenges_.push_back(std::make_shared<ariac_common::FaultyPartChallenge>(challenge));
+            return true;
+        }
+
+        case ariac_capture::QUALITY_CHECK:
+            if (!payload.String(order_id))
+                return false;
+            QualityCheck(order_id);
+            return true;
+
+        case ariac_capture::SUBMIT_ORDER:
+            if (!payload.String(order_id))
+                return false;
+            SubmitOrder(order_id, _record.sim_time);
+            triggers_.QueueSubmissionTriggers(order_id);
+            triggers_.ProcessSubmissionTriggers();
+            return true;
+
+        case ariac_capture::ORDER_SCORED:
+        {
+            int32_t score;
+            if (!payload.String(order_id) || !payload.I32(score))
+                return false;
+            auto it = replayed_scores_.find(order_id);
+            if (it == replayed_scores_.end())
+                result_.mismatches.push_back(Describe(_record, "order " + order_id + " was not replayed"));
+            else if (it->second != score)
+                result_.mismatches.push_back(Describe(_record, "order " + order_id + " recorded " + std::to_string(score) +
+                                                                   ", replayed " + std::to_string(it->second)));
+            return true;
+        }
+
+        case ariac_capture::TRIAL_END:
+            has_trial_end_ = true;
+            return payload.F64(recorded_trial_score_);
+
+        default:
+            // Records added by newer versions of the task manager are skipped
+            return true;
+        }
+    }
+
+    //==============================================================================
+    void TrialReplay::FaultyParts(const std::string &_order_id,
+                                  const ariac_common::KittingTask &_task,
+                                  const ariac_common::KittingShipment &_shipment,
+                                  std::array<bool, 4> &_faulty_parts)
+    {
+        // Parts renamed as faulty by the task manager show up in the images recorded after the rename
+        std::vector<std::pair<int, std::string>> newly_faulty;
+        for (auto &challenge : faulty_part_challenges_)
+        {
+            if (challenge->GetOrderId() == _order_id)
+                _faulty_parts = ariac_scoring::FindFaultyParts(*challenge, _task, _shipment, newly_faulty);
+        }
+    }
+
+    //==============================================================================
+    void TrialReplay::QualityCheck(const std::string &_order_id)
+    {
+        auto it = orders_.find(_order_id);
+        if (it == orders_.end() || it->second->GetType() != ariac_msgs::msg::Order::KITTING)
+            return;
+
+        auto task = it->second->GetKittingTask();
+        auto shipment = ariac_scoring::ParseKittingShipment(tray_images_[task->GetAgvNumber()]);
+
+        std::array<bool, 4> faulty_parts = {false, false, false, false};
+        FaultyParts(_order_id, *task, shipment, faulty_parts);
+    }
+
+    //==============================================================================
+    void TrialReplay::SubmitOrder(const std::string &_order_id, double _sim_time)
+    {
+        auto it = orders_.find(_order_id);
+        if (it == orders_.end() || it->second->IsSubmitted())
+            return;
+
+        auto order = it->second;
+        order->SetIsSubmitted();
+        order->SetSubmittedTime(_sim_time);
+        result_.submissions++;
+
+        if (auto task = order->GetKittingTask())
+        {
+            auto shipment = ariac_scoring::ParseKittingShipment(tray_images_[task->GetAgvNumber()]);
+            std::array<bool, 4> faulty_parts = {false, false, false, false};
+            FaultyParts(_order_id, *task, shipment, faulty_parts);
+
+            auto location = agv_locations_.find(task->GetAgvNumber());
+            int agv_location = location == agv_locations_.end() ? -1 : location->second;
+
+            order->SetKittingScore(ariac_scoring::ScoreKittingTask(_order_id, *task, shipment, agv_location, faulty_parts));
+            replayed_scores_[_order_id] = order->GetKittingScore()->GetScore();
+        }
+        else if (auto task = order->GetAssemblyTask())
+        {
+            auto shipment = ariac_scoring::ParseAssemblyShipment(station_images_[task->GetStation()]);
+            order->SetAssemblyScore(ariac_scoring::ScoreAssemblyTask(_order_id, *task, shipment));
+            replayed_scores_[_order_id] = order->GetAssemblyScore()->GetScore();
+        }
+        else if (auto task = order->GetCombinedTask())
+        {
+            auto shipment = ariac_scoring::ParseAssemblyShipment(station_images_[task->GetStation()]);
+            order->SetCombinedScore(ariac_scoring::ScoreCombinedTask(_order_id, *task, shipment));
+            replayed_scores_[_order_id] = order->GetCombinedScore()->GetScore();
+        }
+    }
+
+    //==============================================================================
+    void TrialReplay::CompareTriggers()
+    {
+        std::map<std::string, std::pair<std::vector<double>, std::vector<double>>> events;
+        for (const auto &entry : recorded_events_)
+            events[entry.first].first = entry.second;
+        for (const auto &entry : replayed_events_)
+            events[entry.first].second = entry.second;
+
+        // Several challenges of a type may start, the n-th recorded start is compared with the n-th replayed one
+        for (auto &entry : events)
+        {
+            auto &recorded = entry.second.first;
+            auto &replayed = entry.second.second;
+            std::sort(recorded.begin(), recorded.end());
+            std::sort(replayed.begin(), replayed.end());
+
+            for (std::size_t i = 0; i < std::max(recorded.size(), replayed.size()); i++)
+            {
+                std::ostringstream out;
+                out << entry.first;
+                if (i >= replayed.size())
+                    out << " at t=" << recorded[i] << " was not replayed";
+                else if (i >= recorded.size())
+                    out << " at t=" << replayed[i] << " by the replay was not recorded";
+                else if (std::abs(recorded[i] - replayed[i]) > tolerance_)
+                    out << " recorded at t=" << recorded[i] << ", replayed at t=" << replayed[i];
+                else
+                    continue;
+                result_.mismatches.push_back(out.str());
+            }
+        }
+    }
+
+    //==============================================================================
+    void TrialReplay::Finish()
+    {
+        // Captures recorded before the trial configuration was captured only replay the scores
+        if (has_trial_config_)
+            CompareTriggers();
+        else
+            result_.timeline.push_back("no trial configuration recorded, announcements were not replayed");
+
+        std::vector<std::shared_ptr<ariac_common::Order>> orders;
+        for (const auto &entry : orders_)
+            orders.push_back(entry.second);
+
+        result_.trial_score = ariac_scoring::ComputeTrialScore(orders);
+
+        if (has_trial_end_ && recorded_trial_score_ != result_.trial_score)
+            result_.mismatches.push_back("trial score recorded " + std::to_string(recorded_trial_score_) +
+                                         ", replayed " + std::to_string(result_.trial_score));
+    }
+
+    //==============================================================================
+    ReplayResult ReplayCapture(const std::string &_path, double _tolerance)
+    {
+        ReplayResult result;
+
+        ariac_capture::CaptureReader reader;
+        if (!reader.Open(_path, result.error))
+            return result;
+
+        TrialReplay replay(result, _tolerance);
+        ariac_capture::Record record;
+        while (reader.Next(record))
+        {
+            result.records++;
+            if (!replay.Apply(record))
+            {
+                result.error = "malformed record " + std::to_string(result.records) + " (type " + std::to_string(record.type) + ")";
+                return result;
+            }
+        }
+
+        // A capture cut short still holds the submissions made before the crash
+        if (reader.Truncated())
+            result.mismatches.push_back("capture is truncated after record " + std::to_string(result.records));
+
+        replay.Finish();
+        result.ok = true;
+        return result;
+    }
+
+    //==============================================================================
+    void PrintUsage()
+    {
+        std::cerr << "Usage: ariac_trial_replay [--jobs N] [--tolerance S] [--verbose] <capture>..." << std::endl;
+    }
+} // namespace
+
+//==============================================================================
+int main(int argc, char **argv)
+{
+    unsigned int jobs = std::max(1u, std::thread::hardware_concurrency());
+    double tolerance = 0.05;
+    bool verbose = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--jobs" || arg == "-j")
+        {
+            if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0)
+            {
+                PrintUsage();
+                return 1;
+            }
+            jobs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--tolerance" || arg == "-t")
+        {
+            if (i + 1 >= argc || std::atof(argv[i + 1]) < 0)
+            {
+                PrintUsage();
+                return 1;
+            }
+            tolerance = std::atof(argv[++i]);
+        }
+        else if (arg == "--verbose" || arg == "-v")
+        {
+            verbose = true;
+        }
+        else if (arg == "--help" || arg == "-h")
+        {
+            PrintUsage();
+            return 0;
+        }
+        else
+        {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    jobs = std::min<unsigned int>(jobs, paths.size());
+
+    std::vector<ReplayResult> results(paths.size());
+    std::atomic<std::size_t> next{0};
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Each worker claims the next capture until none are left
+    std::vector<std::thread> workers;
+    for (unsigned int j = 0; j < jobs; j++)
+    {
+        workers.emplace_back([&]()
+                             {
+            for (std::size_t i = next++; i < paths.size(); i = next++)
+                results[i] = ReplayCapture(paths[i], tolerance); });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int status = 0;
+    std::size_t records = 0;
+    for (std::size_t i = 0; i < paths.size(); i++)
+    {
+        const auto &result = results[i];
+        if (!result.ok)
+        {
+            std::cerr << paths[i] << ": " << result.error << std::endl;
+            status = 1;
+            continue;
+        }
+
+        if (verbose)
+        {
+            for (const auto &event : result.timeline)
+                std::cerr << paths[i] << ": " << event << std::endl;
+        }
+        for (const auto &mismatch : result.mismatches)
+        {
+            std::cerr << paths[i] << ": " << mismatch << std::endl;
+            status = 1;
+        }
+
+        records += result.records;
+        std::cout << paths[i] << " " << result.trial_score << "\n";
+    }
+
+    std::cerr << "Replayed " << records << " records from " << paths.size() << " captures with "
+              << jobs << " jobs in " << elapsed << " s" << std::endl;
+
+    return status;
+}
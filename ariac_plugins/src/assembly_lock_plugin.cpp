@@ -18,6 +18,7 @@ Distributions of NIST software should also include copyright and licensing state
 #include <gazebo/transport/Node.hh>
 #include <ignition/math.hh>
 #include <ariac_plugins/assembly_lock_plugin.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 
 #include <map>
 #include <memory>
@@ -49,6 +50,9 @@ namespace ariac_plugins
 
     std::string assembly_part_type_;
 
+    /// Latency of OnUpdate, shared by all the assembly locks
+    ariac_common::LatencyHistogram *update_timing_{nullptr};
+
     bool CheckModelContact(ConstContactsPtr &);
     void AttachJoint();
     void PublishState();
@@ -93,6 +97,8 @@ namespace ariac_plugins
     impl_->timer_.Reset();
     impl_->timer_.Start();
 
+    impl_->update_timing_ = ariac_common::TimingRegistry::Instance().Histogram("AssemblyLock", "OnUpdate");
+
     // Create a connection so the OnUpdate function is called at every simulation
     // iteration. Remove this call, the connection and the callback if not needed.
     impl_->update_connection_ = gazebo::event::Events::ConnectWorldUpdateBegin(
@@ -101,6 +107,7 @@ namespace ariac_plugins
 
   void AssemblyLock::OnUpdate()
   {
+    ariac_common::ScopedTimer timer(impl_->update_timing_);
     if (!impl_->part_attached_ && impl_->in_contact_)
     {
       impl_->AttachJoint();
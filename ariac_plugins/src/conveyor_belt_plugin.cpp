@@ -13,6 +13,7 @@ Distributions of NIST software should also include copyright and licensing state
 #include <ariac_msgs/srv/conveyor_belt_control.hpp>
 #include <ariac_msgs/msg/conveyor_belt_state.hpp>
 #include <ariac_msgs/msg/competition_state.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 
 #include <memory>
 
@@ -53,6 +54,9 @@ public:
   rclcpp::Time last_publish_time_;
   int update_ns_;
 
+  /// Latency of OnUpdate
+  ariac_common::LatencyHistogram *update_timing_{nullptr};
+
   void OnUpdate();
 
   /// Callback for enable service
@@ -117,12 +121,14 @@ void ConveyorBeltPlugin::Load(gazebo::physics::ModelPtr model, sdf::ElementPtr s
   impl_->last_publish_time_ = impl_->ros_node_->get_clock()->now();
 
   // Create a connection so the OnUpdate function is called at every simulation iteration. 
+  impl_->update_timing_ = ariac_common::TimingRegistry::Instance().Histogram("ConveyorBeltPlugin", "OnUpdate");
   impl_->update_connection_ = gazebo::event::Events::ConnectWorldUpdateBegin(
     std::bind(&ConveyorBeltPluginPrivate::OnUpdate, impl_.get()));
 }
 
 void ConveyorBeltPluginPrivate::OnUpdate()
 {
+  ariac_common::ScopedTimer timer(update_timing_);
   belt_joint_->SetVelocity(0, belt_velocity_);
 
   double belt_position = belt_joint_->Position(0);
@@ -18,6 +18,8 @@ Distributions of NIST software should also include copyright and licensing state
 #include <gazebo_msgs/srv/delete_entity.hpp>
 #include <gazebo_msgs/srv/delete_model.hpp>
 #include <ariac_plugins/object_disposal_plugin.hpp>
+#include <ariac_plugins/model_name_classifier.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 
 #include <gazebo_ros/node.hpp>
 #include <rclcpp/rclcpp.hpp>
@@ -46,10 +48,11 @@ namespace ariac_plugins
     gazebo::transport::SubscriberPtr contact_sub_;
     gazebo::transport::NodePtr gznode_;
 
-    std::vector<std::string> part_types_;
-
     gazebo::physics::ModelPtr model_;
 
+    /// Latency of OnContact, called for every contact message of the disposal link
+    ariac_common::LatencyHistogram *contact_timing_{nullptr};
+
     std::vector<std::string> deleted_models_;
 
     /// Penalty publisher
@@ -87,8 +90,6 @@ namespace ariac_plugins
 
     impl_->ros_node_ = gazebo_ros::Node::Get(sdf);
 
-    impl_->part_types_ = {"battery", "regulator", "pump", "sensor"};
-
     impl_->deleted_models_ = {};
 
     // Initialize a gazebo node and subscribe to the contacts for the vacuum gripper
@@ -108,12 +109,14 @@ namespace ariac_plugins
     // Create penalty publisher
     // impl_->penalty_pub_ = impl_->ros_node_->create_publisher<std_msgs::msg::String>("/ariac/penalty", 10);
 
+    impl_->contact_timing_ = ariac_common::TimingRegistry::Instance().Histogram("ObjectDisposalPlugin", "OnContact");
     impl_->contact_sub_ = impl_->gznode_->Subscribe(topic, &ObjectDisposalPlugin::OnContact, this);
   }
 
   void ObjectDisposalPlugin::OnContact(ConstContactsPtr &_msg)
   {
     using namespace std::chrono_literals;
+    ariac_common::ScopedTimer timer(impl_->contact_timing_);
     std::string model_in_contact;
 
     for (int i = 0; i < _msg->contact_size(); ++i)
@@ -143,45 +146,41 @@ namespace ariac_plugins
       if (!model_name.empty())
         // std::cout << "model: " << model_name << std::endl;
         // check model is a part
-        for (std::string &type : impl_->part_types_)
+        if (ariac_common::ClassifyModelName(model_name).type != -1)
         {
-          if (model_name.find(type) != std::string::npos)
-          {
-            RCLCPP_WARN(impl_->ros_node_->get_logger(), "Part %s in contact with floor, teleporting", model_name.c_str());
-           
-            // if (!impl_->delete_entity_client_->wait_for_service(5s))
-            // {
-            //   RCLCPP_ERROR(impl_->ros_node_->get_logger(), "Unable to find localize_part service. Start vision_node first.");
-            //   return;
-            // }
-
-            // impl_->model_->SetWorldPose({-20, 13, 0.5, 0, 0, 0}, true, true);
-            impl_->model_->SetAutoDisable(true);
-            impl_->model_->SetCollideMode("none");
-            impl_->deleted_models_.push_back(model_name);
-
-            // auto request = std::make_shared<gazebo_msgs::srv::DeleteEntity::Request>();
-            // request->name = model_name;
-            // auto future = impl_->delete_entity_client_->async_send_request(request);
-
-            // if (rclcpp::spin_until_future_complete(impl_->ros_node_->get_node_base_interface(), future) != rclcpp::FutureReturnCode::SUCCESS)
-            // {
-            //   RCLCPP_ERROR(impl_->ros_node_->get_logger(), "Failed to receive LocalizePart service response");
-            //   return;
-            // }
-
-            // auto response = future.get();
-            // if (!response->success)
-            // {
-            //   RCLCPP_ERROR(impl_->ros_node_->get_logger(), "Part deletion failed");
-            //   return;
-            // }
-
-            // impl_->deleted_models_.push_back(model_name);
-
-            // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Response: "<< response->success);
-            break;
-          }
+          RCLCPP_WARN(impl_->ros_node_->get_logger(), "Part %s in contact with floor, teleporting", model_name.c_str());
+         
+          // if (!impl_->delete_entity_client_->wait_for_service(5s))
+          // {
+          //   RCLCPP_ERROR(impl_->ros_node_->get_logger(), "Unable to find localize_part service. Start vision_node first.");
+          //   return;
+          // }
+
+          // impl_->model_->SetWorldPose({-20, 13, 0.5, 0, 0, 0}, true, true);
+          impl_->model_->SetAutoDisable(true);
+          impl_->model_->SetCollideMode("none");
+          impl_->deleted_models_.push_back(model_name);
+
+          // auto request = std::make_shared<gazebo_msgs::srv::DeleteEntity::Request>();
+          // request->name = model_name;
+          // auto future = impl_->delete_entity_client_->async_send_request(request);
+
+          // if (rclcpp::spin_until_future_complete(impl_->ros_node_->get_node_base_interface(), future) != rclcpp::FutureReturnCode::SUCCESS)
+          // {
+          //   RCLCPP_ERROR(impl_->ros_node_->get_logger(), "Failed to receive LocalizePart service response");
+          //   return;
+          // }
+
+          // auto response = future.get();
+          // if (!response->success)
+          // {
+          //   RCLCPP_ERROR(impl_->ros_node_->get_logger(), "Part deletion failed");
+          //   return;
+          // }
+
+          // impl_->deleted_models_.push_back(model_name);
+
+          // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Response: "<< response->success);
         }
     }
 
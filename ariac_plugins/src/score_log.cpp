@@ -0,0 +1,391 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#include <ariac_plugins/score_log.hpp>
+
+// C++
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace ariac_scoring
+{
+    namespace
+    {
+        const char *kSeparator = "========================================\n";
+
+        std::string JsonString(const std::string &_value)
+        {
+            std::string out = "\"";
+            for (char c : _value)
+            {
+                switch (c)
+                {
+                case '"':
+                    out += "\\\"";
+                    break;
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\t':
+                    out += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        out += escaped;
+                    }
+                    else
+                        out += c;
+                }
+            }
+            return out + "\"";
+        }
+
+        std::string JsonNumber(double _value)
+        {
+            // JSON has no representation for nan and inf
+            if (!std::isfinite(_value))
+                return "null";
+
+            std::ostringstream out;
+            out << std::setprecision(std::numeric_limits<double>::max_digits10) << _value;
+            return out.str();
+        }
+
+        ScoreRecord ScoredPartRecord(const ariac_common::ScoredAssemblyPart &_part, bool _with_faulty)
+        {
+            ScoreRecord record;
+            record.Add("part", "Part",
+                       "[" + ariac_common::ConvertPartTypeToString(_part.GetPart().GetType()) + "," +
+                           ariac_common::ConvertPartColorToString(_part.GetPart().GetColor()) + "]");
+            record.AddFlag("correct_type", "Type", true, "Correct", "Incorrect");
+            record.AddFlag("correct_color", "Color", _part.GetCorrectColor(), "Correct", "Incorrect");
+            record.AddFlag("correct_pose", "Pose", _part.GetCorrectPose(), "Correct", "Incorrect");
+            if (_with_faulty)
+                record.AddFlag("faulty", "Faulty", _part.GetIsFaulty());
+            record.Add("position", "Position", _part.GetPosition());
+            record.Add("orientation", "Orientation", _part.GetOrientation());
+            record.Add("score", "Part score", _part.GetScore());
+            return record;
+        }
+
+        template <typename T>
+        void AddScoredParts(ScoreRecord &_record, const T &_score, bool _with_faulty)
+        {
+            for (const auto &part : {_score.GetBatteryPtr(), _score.GetPumpPtr(),
+                                     _score.GetRegulatorPtr(), _score.GetSensorPtr()})
+            {
+                if (part != nullptr)
+                    _record.AddChild("parts", "", ScoredPartRecord(*part, _with_faulty));
+            }
+        }
+    } // namespace
+
+    //==============================================================================
+    ScoreRecord &ScoreRecord::Add(const std::string &_key, const std::string &_label, const std::string &_value)
+    {
+        fields_.push_back({_key, _label, JsonString(_value), _value});
+        return *this;
+    }
+
+    //==============================================================================
+    ScoreRecord &ScoreRecord::Add(const std::string &_key, const std::string &_label, const char *_value)
+    {
+        return Add(_key, _label, std::string(_value));
+    }
+
+    //==============================================================================
+    ScoreRecord &ScoreRecord::Add(const std::string &_key, const std::string &_label, int _value)
+    {
+        fields_.push_back({_key, _label, std::to_string(_value), std::to_string(_value)});
+        return *this;
+    }
+
+    //==============================================================================
+    ScoreRecord &ScoreRecord::Add(const std::string &_key, const std::string &_label, double _value)
+    {
+        fields_.push_back({_key, _label, JsonNumber(_value), std::to_string(_value)});
+        return *this;
+    }
+
+    //==============================================================================
+    ScoreRecord &ScoreRecord::Add(const std::string &_key, const std::string &_label, const geometry_msgs::msg::Vector3 &_value)
+    {
+        fields_.push_back({_key, _label,
+                           "[" + JsonNumber(_value.x) + "," + JsonNumber(_value.y) + "," + JsonNumber(_value.z) + "]",
+                           std::to_string(_value.x) + ", " + std::to_string(_value.y) + ", " + std::to_string(_value.z)});
+        return *this;
+    }
+
+    //==============================================================================
+    ScoreRecord &ScoreRecord::AddFlag(const std::string &_key, const std::string &_label, bool _value,
+                                      const std::string &_true_text, const std::string &_false_text)
+    {
+        fields_.push_back({_key, _label, _value ? "true" : "false", _value ? _true_text : _false_text});
+        return *this;
+    }
+
+    //==============================================================================
+    ScoreRecord &ScoreRecord::AddChild(const std::string &_key, const std::string &_label, ScoreRecord _child)
+    {
+        for (auto &list : children_)
+        {
+            if (list.key == _key)
+            {
+                list.records.push_back(std::move(_child));
+                return *this;
+            }
+        }
+
+        children_.push_back({_key, _label, {}});
+        children_.back().records.push_back(std::move(_child));
+        return *this;
+    }
+
+    //==============================================================================
+    std::string ScoreRecord::ToJson() const
+    {
+        std::string out;
+        AppendJson(out);
+        return out;
+    }
+
+    //==============================================================================
+    void ScoreRecord::AppendJson(std::string &_out) const
+    {
+        bool first = true;
+        auto key = [&](const std::string &_key)
+        {
+            _out += first ? "" : ",";
+            _out += JsonString(_key) + ":";
+            first = false;
+        };
+
+        _out += "{";
+        if (!event_.empty())
+        {
+            key("event");
+            _out += JsonString(event_);
+        }
+        for (const auto &field : fields_)
+        {
+            key(field.key);
+            _out += field.json;
+        }
+        for (const auto &list : children_)
+        {
+            key(list.key);
+            _out += "[";
+            for (size_t i = 0; i < list.records.size(); i++)
+            {
+                _out += i == 0 ? "" : ",";
+                list.records[i].AppendJson(_out);
+            }
+            _out += "]";
+        }
+        _out += "}";
+    }
+
+    //==============================================================================
+    std::string ScoreRecord::ToText() const
+    {
+        std::string out = "\n";
+        out += kSeparator;
+        AppendText(out);
+        return out;
+    }
+
+    //==============================================================================
+    void ScoreRecord::AppendText(std::string &_out) const
+    {
+        if (!title_.empty())
+        {
+            _out += title_ + "\n";
+            _out += kSeparator;
+        }
+        for (const auto &field : fields_)
+        {
+            if (!field.label.empty())
+                _out += field.label + ": " + field.text + "\n";
+        }
+        for (const auto &list : children_)
+        {
+            if (!list.label.empty())
+            {
+                _out += kSeparator;
+                _out += list.label + "\n";
+            }
+            for (const auto &record : list.records)
+            {
+                _out += kSeparator;
+                record.AppendText(_out);
+            }
+        }
+    }
+
+    //==============================================================================
+    ScoreRecord KittingScoreRecord(const ariac_common::KittingScore &_score)
+    {
+        ScoreRecord record("kitting_score");
+        record.Add("order_id", "Order", _score.GetOrderId());
+        record.Add("type", "Type", "Kitting");
+        record.Add("agv", "AGV", _score.GetAGV());
+        record.Add("tray_score", "Tray score", _score.GetTrayScore());
+        record.AddFlag("correct_destination", "Correct destination", _score.GetDestinationScore() == 1);
+        record.Add("bonus", "Bonus", _score.GetBonus());
+        record.Add("penalty", "", _score.GetPenalty());
+        record.Add("score", "Score", _score.GetScore());
+
+        int index = 1;
+        for (const auto &quadrant : {_score.GetQuadrant1(), _score.GetQuadrant2(),
+                                     _score.GetQuadrant3(), _score.GetQuadrant4()})
+        {
+            if (quadrant != nullptr)
+            {
+                ScoreRecord child;
+                child.Add("quadrant", "Quadrant", index);
+                child.Add("score", "Quadrant score", quadrant->GetScore());
+                child.AddFlag("correct_part_type", "Correct part type", quadrant->GetIsCorrectPartType());
+                child.AddFlag("correct_part_color", "Correct part color", quadrant->GetIsCorrectPartColor());
+                child.AddFlag("faulty", "Faulty part", quadrant->GetIsFaulty());
+                child.AddFlag("flipped", "Flipped part", quadrant->GetIsFlipped());
+                record.AddChild("quadrants", "", std::move(child));
+            }
+            index++;
+        }
+        return record;
+    }
+
+    //==============================================================================
+    ScoreRecord AssemblyScoreRecord(const ariac_common::AssemblyScore &_score)
+    {
+        ScoreRecord record("assembly_score");
+        record.Add("order_id", "Order", _score.GetOrderId());
+        record.Add("type", "Type", "Assembly");
+        record.Add("station", "Station", _score.GetStation());
+        record.Add("bonus", "Bonus", _score.GetBonus());
+        record.Add("score", "Score", _score.GetScore());
+        AddScoredParts(record, _score, false);
+        return record;
+    }
+
+    //==============================================================================
+    ScoreRecord CombinedScoreRecord(const ariac_common::CombinedScore &_score)
+    {
+        ScoreRecord record("combined_score");
+        record.Add("order_id", "Order", _score.GetOrderId());
+        record.Add("type", "Type", "Combined");
+        record.Add("station", "Station", _score.GetStation());
+        record.Add("bonus", "Bonus", _score.GetBonus());
+        record.Add("score", "Score", _score.GetScore());
+        AddScoredParts(record, _score, true);
+        return record;
+    }
+
+    //==============================================================================
+    bool ScoreLogWriter::Open(const std::string &_json_path, const std::string &_text_path)
+    {
+        Close();
+
+        std::lock_guard<std::mutex> lock(lock_);
+        json_file_.open(_json_path, std::ios::out | std::ios::app);
+        if (!json_file_)
+            return false;
+
+        if (!_text_path.empty())
+        {
+            text_file_.open(_text_path, std::ios::out | std::ios::app);
+            if (!text_file_)
+            {
+                json_file_.close();
+                return false;
+            }
+        }
+
+        open_ = true;
+        stop_ = false;
+        thread_ = std::thread(&ScoreLogWriter::Run, this);
+        return true;
+    }
+
+    //==============================================================================
+    void ScoreLogWriter::Write(ScoreRecord _record)
+    {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            if (!open_ || stop_)
+                return;
+            queue_.push_back(std::move(_record));
+        }
+        wake_.notify_one();
+    }
+
+    //==============================================================================
+    void ScoreLogWriter::Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            if (!open_)
+                return;
+            stop_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+
+        std::lock_guard<std::mutex> lock(lock_);
+        json_file_.close();
+        if (text_file_.is_open())
+            text_file_.close();
+        open_ = false;
+    }
+
+    //==============================================================================
+    bool ScoreLogWriter::IsOpen()
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        return open_ && !stop_;
+    }
+
+    //==============================================================================
+    void ScoreLogWriter::Run()
+    {
+        std::deque<ScoreRecord> batch;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(lock_);
+                wake_.wait(lock, [this]
+                           { return stop_ || !queue_.empty(); });
+                if (queue_.empty())
+                    return;
+                batch.swap(queue_);
+            }
+
+            // Rendering and disk I/O happen outside of the lock so Write never waits on them
+            for (const auto &record : batch)
+            {
+                json_file_ << record.ToJson() << '\n';
+                if (text_file_.is_open())
+                    text_file_ << record.ToText();
+            }
+            json_file_.flush();
+            if (text_file_.is_open())
+                text_file_.flush();
+            batch.clear();
+        }
+    }
+
+} // namespace ariac_scoring
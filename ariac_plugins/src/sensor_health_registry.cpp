@@ -0,0 +1,33 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#include <ariac_plugins/sensor_health_registry.hpp>
+
+namespace ariac_common
+{
+    //==============================================================================
+    SensorHealthRegistry &SensorHealthRegistry::Instance()
+    {
+        // Defined in the shared library so every plugin sees the same instance
+        static SensorHealthRegistry registry;
+        return registry;
+    }
+
+    //==============================================================================
+    ariac_msgs::msg::Sensors SensorHealthRegistry::ToMsg(uint32_t _mask)
+    {
+        ariac_msgs::msg::Sensors msg;
+        msg.break_beam = (_mask & BREAK_BEAM) != 0;
+        msg.proximity = (_mask & PROXIMITY) != 0;
+        msg.laser_profiler = (_mask & LASER_PROFILER) != 0;
+        msg.lidar = (_mask & LIDAR) != 0;
+        msg.camera = (_mask & CAMERA) != 0;
+        msg.logical_camera = (_mask & LOGICAL_CAMERA) != 0;
+        return msg;
+    }
+} // namespace ariac_common
@@ -15,9 +15,13 @@ Distributions of NIST software should also include copyright and licensing state
 #include <gazebo/sensors/LogicalCameraSensor.hh>
 #include <gazebo_ros/conversions/builtin_interfaces.hpp>
 #include <gazebo_ros/conversions/geometry_msgs.hpp>
+#include <boost/make_shared.hpp>
 
 // Messages
 #include <ariac_plugins/task_manager_plugin.hpp>
+#include <ariac_plugins/model_name_classifier.hpp>
+#include <ariac_plugins/sensor_health_registry.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 #include <ariac_msgs/msg/trial.hpp>
 #include <ariac_msgs/msg/order.hpp>
 #include <ariac_msgs/msg/order_condition.hpp>
@@ -35,10 +39,12 @@ Distributions of NIST software should also include copyright and licensing state
 #include <ariac_msgs/msg/competition_state.hpp>
 #include <ariac_msgs/msg/quality_issue.hpp>
 #include <ariac_msgs/msg/agv_status.hpp>
+#include <ariac_msgs/msg/order_score.hpp>
 #include <ariac_msgs/srv/submit_order.hpp>
 #include <ariac_msgs/srv/perform_quality_check.hpp>
 #include <ariac_msgs/srv/get_pre_assembly_poses.hpp>
 #include <std_msgs/msg/bool.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
 #include <ariac_msgs/srv/get_pre_assembly_poses.hpp>
 // ROS
 #include <rclcpp/rclcpp.hpp>
@@ -51,9 +57,28 @@ Distributions of NIST software should also include copyright and licensing state
 // C++
 #include <memory>
 #include <iostream>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <sys/stat.h>
 // ARIAC
 #include <ariac_plugins/ariac_common.hpp>
+#include <ariac_plugins/ariac_scoring.hpp>
+#include <ariac_plugins/trial_capture.hpp>
+#include <ariac_plugins/score_log.hpp>
+#include <ariac_plugins/sensed_models.hpp>
+#include <ariac_plugins/mpsc_queue.hpp>
+#include <ariac_plugins/worker_pool.hpp>
 
 namespace ariac_plugins
 {
@@ -66,6 +91,8 @@ namespace ariac_plugins
         //============== C++ =================
         /*!< A mutex to protect the current state. */
         std::mutex lock_;
+        /*!< Commands queued by the service and trial callbacks, run at the start of OnUpdate. */
+        ariac_common::MpscQueue<std::function<void()>> commands_;
         /*!< Pointer to the current state. */
         unsigned int current_state_{ariac_msgs::msg::CompetitionState::IDLE};
         /*!< Score for the whole trial. */
@@ -109,41 +136,30 @@ namespace ariac_plugins
         bool competition_time_set_{false};
         /*< Counter to keep track of the total number of orders in the current trial. */
         int total_orders_{-1};
-        unsigned int agv1_location_;
-        unsigned int agv2_location_;
-        unsigned int agv3_location_;
-        unsigned int agv4_location_;
 
-        std::map<int, std::vector<ariac_common::Part>> agv_parts_;
         std::map<int, std::vector<ariac_common::Part>> insert_parts_;
+        /*!< Part placement keys of the parts added to the AGVs since the triggers were last fired. */
+        std::vector<int> added_agv_parts_;
+
+        //============== Part Placement Triggers =================
+        /*!< Actions waiting for a part to be placed, keyed by PartPlacementKey(). */
+        std::unordered_map<int, std::vector<std::function<void()>>> part_placement_triggers_;
+        /*!< Key of a part placement trigger for a given AGV, part type and part color. */
+        static int PartPlacementKey(int agv, int type, int color) { return (agv * 100 + type) * 100 + color; }
+        /*!< Queue the parts of new_parts that were not in old_parts and have a trigger waiting on them. */
+        void QueueAddedAGVParts(int agv_id,
+                                const std::vector<ariac_common::Part> &old_parts,
+                                const std::vector<ariac_common::Part> &new_parts);
 
         //============== ROS =================
         /*!< Time since when this plugin is loaded. */
         rclcpp::Time current_sim_time_;
-        /*!< Time since the competition started. */
-        double elapsed_time_;
+        /*!< Time since the competition started. Written by OnUpdate, also read by the sensor and AGV status callbacks for the capture. */
+        std::atomic<double> elapsed_time_{0.0};
 
         //============== SUBSCRIBERS =================
         /*!< Subscriber to topic: "/ariac/trial_config"*/
         rclcpp::Subscription<ariac_msgs::msg::Trial>::SharedPtr trial_config_sub_;
-        /*!< Subscriber to topic: "/ariac/agv1_status"*/
-        rclcpp::Subscription<ariac_msgs::msg::AGVStatus>::SharedPtr agv1_status_;
-        /*!< Subscriber to topic: "/ariac/agv2_status"*/
-        rclcpp::Subscription<ariac_msgs::msg::AGVStatus>::SharedPtr agv2_status_;
-        /*!< Subscriber to topic: "/ariac/agv3_status"*/
-        rclcpp::Subscription<ariac_msgs::msg::AGVStatus>::SharedPtr agv3_status_;
-        /*!< Subscriber to topic: "/ariac/agv4_status"*/
-        rclcpp::Subscription<ariac_msgs::msg::AGVStatus>::SharedPtr agv4_status_;
-
-        gazebo::transport::SubscriberPtr agv1_tray_sub_;
-        gazebo::transport::SubscriberPtr agv2_tray_sub_;
-        gazebo::transport::SubscriberPtr agv3_tray_sub_;
-        gazebo::transport::SubscriberPtr agv4_tray_sub_;
-
-        gazebo::transport::SubscriberPtr station1_sub_;
-        gazebo::transport::SubscriberPtr station2_sub_;
-        gazebo::transport::SubscriberPtr station3_sub_;
-        gazebo::transport::SubscriberPtr station4_sub_;
 
         //============== SERVICES =================
         /*!< Service to start the competition. */
@@ -170,6 +186,25 @@ namespace ariac_plugins
         rclcpp::Publisher<ariac_msgs::msg::Robots>::SharedPtr robot_health_pub_;
         /*!< Publisher to the topic /ariac/start_human */
         rclcpp::Publisher<std_msgs::msg::Bool>::SharedPtr start_human_pub_;
+        /*!< Publisher to the topic /ariac/order_scores */
+        rclcpp::Publisher<ariac_msgs::msg::OrderScore>::SharedPtr order_score_pub_;
+        /*!< Publisher to the topic /diagnostics */
+        rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr diagnostics_pub_;
+        /*!< Timer publishing the latencies of the plugins on /diagnostics */
+        rclcpp::TimerBase::SharedPtr diagnostics_timer_;
+
+        //============== Timing =================
+        /*!< Latency histograms of the update steps, registered in the process wide TimingRegistry. */
+        ariac_common::LatencyHistogram *update_timing_{nullptr};
+        ariac_common::LatencyHistogram *commands_timing_{nullptr};
+        ariac_common::LatencyHistogram *apply_scores_timing_{nullptr};
+        ariac_common::LatencyHistogram *timed_events_timing_{nullptr};
+        ariac_common::LatencyHistogram *placement_triggers_timing_{nullptr};
+        ariac_common::LatencyHistogram *submission_triggers_timing_{nullptr};
+        ariac_common::LatencyHistogram *sensors_health_timing_{nullptr};
+        ariac_common::LatencyHistogram *store_agv_parts_timing_{nullptr};
+        ariac_common::LatencyHistogram *parse_station_timing_{nullptr};
+        ariac_common::LatencyHistogram *scoring_job_timing_{nullptr};
 
         // Reduce the rate of publishing to some topics
         rclcpp::Time last_publish_time_;
@@ -177,12 +212,12 @@ namespace ariac_plugins
         bool first_publish_;
 
         //============== Orders =================
-        /*!< List of orders. that have already been submitted*/
-        std::vector<std::string> submitted_orders_;
+        /*!< Set of orders that have already been submitted. */
+        std::unordered_set<std::string> submitted_orders_;
         /*!< List of orders. that have already been announced*/
         std::vector<std::string> announced_orders_;
-        /*!< List of trial orders. */
-        std::vector<std::string> trial_orders_;
+        /*!< Set of trial orders that have not been submitted yet. */
+        std::unordered_set<std::string> trial_orders_;
         /*!< List of orders that are announced based on time. */
         std::vector<std::shared_ptr<ariac_common::OrderTemporal>>
             time_based_orders_;
@@ -192,6 +227,39 @@ namespace ariac_plugins
         std::vector<std::shared_ptr<ariac_common::OrderOnSubmission>> on_order_submission_orders_;
         /*!< List of all orders in the trial. */
         std::vector<std::shared_ptr<ariac_common::Order>> all_orders_;
+        /*!< All orders in the trial indexed by id. */
+        std::unordered_map<std::string, std::shared_ptr<ariac_common::Order>> orders_by_id_;
+        /*!< Find an order by id, nullptr if the trial has no such order. */
+        std::shared_ptr<ariac_common::Order> FindOrder(const std::string &order_id) const;
+
+        //============== Submission Triggers =================
+        /*!< Actions waiting for an order to be submitted, keyed by the id of that order. */
+        std::unordered_map<std::string, std::vector<std::function<void()>>> submission_triggers_;
+        /*!< Orders submitted since the submission triggers were last fired. */
+        std::vector<std::string> newly_submitted_orders_;
+
+        //============== Timed Events =================
+        /*!< Action to run once the elapsed time reaches a given time. */
+        struct TimedEvent
+        {
+            /*!< Elapsed competition time at which the event is due. */
+            double time;
+            /*!< Insertion order, keeps events due at the same time in FIFO order. */
+            uint64_t sequence;
+            /*!< Action to run. */
+            std::function<void()> action;
+
+            bool operator>(const TimedEvent &_other) const
+            {
+                if (time != _other.time)
+                    return time > _other.time;
+                return sequence > _other.sequence;
+            }
+        };
+        /*!< Min-heap of timed events (announcements, challenge starts and ends, safe zone penalty end). */
+        std::priority_queue<TimedEvent, std::vector<TimedEvent>, std::greater<TimedEvent>> timed_events_;
+        /*!< Sequence number given to the next timed event. */
+        uint64_t timed_event_sequence_{0};
 
         //============== Human Challenge =================
         /*!< human challenge announced based on time. */
@@ -219,8 +287,6 @@ namespace ariac_plugins
         std::vector<std::shared_ptr<ariac_common::SensorBlackoutOnPartPlacement>> on_part_placement_sensor_blackouts_;
         /*!< List of sensor blackout challenges that are announced based on submission. */
         std::vector<std::shared_ptr<ariac_common::SensorBlackoutOnSubmission>> on_submission_sensor_blackouts_;
-        /*!< List of sensor blackout challenges that have been started. */
-        std::vector<std::shared_ptr<ariac_common::SensorBlackout>> in_progress_sensor_blackouts_;
 
         //============== Robot Malfunction Challenge =================
         /*!< List of robot malfunction challenges that are announced based on time. */
@@ -230,8 +296,6 @@ namespace ariac_plugins
         std::vector<std::shared_ptr<ariac_common::RobotMalfunctionOnPartPlacement>> on_part_placement_robot_malfunctions_;
         /*!< List of robot malfunction challenges that are announced based on submission. */
         std::vector<std::shared_ptr<ariac_common::RobotMalfunctionOnSubmission>> on_submission_robot_malfunctions_;
-        /*!< List of robot malfunction challenges that have been started. */
-        std::vector<std::shared_ptr<ariac_common::RobotMalfunction>> in_progress_robot_malfunctions_;
 
         //============== Faulty Part Challenge =================
         /*!< List of faulty part challenges. */
@@ -243,36 +307,76 @@ namespace ariac_plugins
             ariac_common::KittingShipment _shipment);
 
         //============== Tray and AGV Sensors =================
-        /*!< Map of AGV trays. The key is the AGV ID and the value is information about the tray*/
-        std::map<int, gazebo::msgs::LogicalCameraImage> agv_tray_images_;
-        /*!< Map of Assembly Station images. The key is the AGV ID and the value is the camera image.*/
-        std::map<int, gazebo::msgs::LogicalCameraImage> assembly_station_images_;
+        /*!< Camera image as received from gazebo transport, shared with the readers instead of copied. */
+        using ImagePtr = boost::shared_ptr<const gazebo::msgs::LogicalCameraImage>;
+        /*!< What a quality check reads from a part on a tray: model name, quadrant, type, color and flipped. */
+        using TrayPartKey = std::tuple<std::string, unsigned int, unsigned int, unsigned int, bool>;
+        /*!< State of an AGV. */
+        struct AGV
+        {
+            /*!< Location reported on /ariac/agv{n}_status. */
+            std::atomic<unsigned int> location{ariac_msgs::msg::AGVStatus::KITTING};
+            /*!< Latest image of the tray sensor. */
+            ImagePtr tray_image;
+            /*!< Content hash of the last tray image parsed. */
+            std::atomic<std::size_t> tray_hash{0};
+            /*!< Parts on the tray, as of the last tray image parsed. Guarded by lock_. */
+            std::vector<ariac_common::Part> parts;
+            /*!< Tray image the quality check shipment was parsed from. Guarded by lock_. */
+            ImagePtr quality_image;
+            /*!< Shipment parsed from quality_image. Guarded by lock_. */
+            std::shared_ptr<const ariac_common::KittingShipment> quality_shipment;
+            /*!< Incremented when the parsed shipment differs from the previous one. Guarded by lock_. */
+            std::uint64_t quality_generation{0};
+            /*!< Tray ID of quality_shipment. Guarded by lock_. */
+            unsigned int quality_tray_id{0};
+            /*!< Parts of quality_shipment, as read by a quality check. Guarded by lock_. */
+            std::vector<TrayPartKey> quality_parts;
+            /*!< Subscriber to the tray sensor. */
+            gazebo::transport::SubscriberPtr tray_sub;
+            /*!< Subscriber to topic: "/ariac/agv{n}_status" */
+            rclcpp::Subscription<ariac_msgs::msg::AGVStatus>::SharedPtr status_sub;
+        };
+        /*!< State of an assembly station. */
+        struct Station
+        {
+            /*!< Latest image of the camera above the station. */
+            ImagePtr image;
+            /*!< Content hash of the last image parsed. */
+            std::atomic<std::size_t> hash{0};
+            /*!< Subscriber to the camera above the station. */
+            gazebo::transport::SubscriberPtr sub;
+        };
+        /*!< AGVs of the workcell, indexed by AGV ID - 1. The number of AGVs is set by <agv_count>. */
+        std::vector<AGV> agvs_;
+        /*!< Assembly stations of the workcell, indexed by station - 1. The number of stations is set by <station_count>. */
+        std::vector<Station> stations_;
+        /*!< AGV with the given ID, nullptr if there is none. */
+        AGV *FindAGV(int _agv_id);
+        /*!< Assembly station with the given ID, nullptr if there is none. */
+        Station *FindStation(int _station);
+        /*!< Latest tray image of an AGV, an empty image if there is none. */
+        ImagePtr LatestTrayImage(int _agv_id);
+        /*!< Latest image of an assembly station, an empty image if there is none. */
+        ImagePtr LatestStationImage(int _station);
+        /*!< Location of an AGV, -1 if there is no such AGV. */
+        int AGVLocation(int _agv_id);
 
         //============== Callbacks for Tray and AGVs Cameras =================
-        /*!< Callback to parse the tray located on AGV1. */
-        void AGV1TraySensorCallback(ConstLogicalCameraImagePtr &_msg);
-        /*!< Callback to parse the tray located on AGV2. */
-        void AGV2TraySensorCallback(ConstLogicalCameraImagePtr &_msg);
-        /*!< Callback to parse the tray located on AGV3. */
-        void AGV3TraySensorCallback(ConstLogicalCameraImagePtr &_msg);
-        /*!< Callback to parse the tray located on AGV4. */
-        void AGV4TraySensorCallback(ConstLogicalCameraImagePtr &_msg);
-        /*!< Callback to logical camera above assembly station 1. */
-        void Station1SensorCallback(ConstLogicalCameraImagePtr &_msg);
-        /*!< Callback to logical camera above assembly station 2. */
-        void Station2SensorCallback(ConstLogicalCameraImagePtr &_msg);
-        /*!< Callback to logical camera above assembly station 3. */
-        void Station3SensorCallback(ConstLogicalCameraImagePtr &_msg);
-        /*!< Callback to logical camera above assembly station 4. */
-        void Station4SensorCallback(ConstLogicalCameraImagePtr &_msg);
+        /*!< Store a new tray image and update the AGV parts if its content changed. */
+        void UpdateAGVTrayImage(int agv_id, ConstLogicalCameraImagePtr &_msg);
+        /*!< Store a new station image and update insert_parts_ if its content changed. */
+        void UpdateStationImage(int station, ConstLogicalCameraImagePtr &_msg);
+        /*!< Order-independent hash of the models seen in a logical camera image. */
+        static std::size_t HashImageContent(const gazebo::msgs::LogicalCameraImage &_msg);
 
         //============== Score Displays =================
-        /*!< Print details of the score for an assembly task. */
-        void PrintAssemblyScore(std::shared_ptr<ariac_common::AssemblyScore> assembly_score);
-        /*!< Print details of the score for a combined task. */
-        void PrintCombinedScore(std::shared_ptr<ariac_common::CombinedScore> combined_score);
-        /*!< Print details of the score for a kitting task. */
-        void PrintKittingScore(std::shared_ptr<ariac_common::KittingScore> kitting_score);
+        /*!< Print details of the score for an assembly task submitted at _time. */
+        void PrintAssemblyScore(std::shared_ptr<ariac_common::AssemblyScore> assembly_score, double _time);
+        /*!< Print details of the score for a combined task submitted at _time. */
+        void PrintCombinedScore(std::shared_ptr<ariac_common::CombinedScore> combined_score, double _time);
+        /*!< Print details of the score for a kitting task submitted at _time. */
+        void PrintKittingScore(std::shared_ptr<ariac_common::KittingScore> kitting_score, double _time);
         /*!< Print details of the score for the trial. */
         void PrintTrialScore(
             std::shared_ptr<ariac_common::Order> kitting_order,
@@ -280,45 +384,116 @@ namespace ariac_plugins
             std::shared_ptr<ariac_common::Order> combined_order);
 
         /**
-         * @brief Retrieve the tray information from the message and store it in the agv_parts_ map.
+         * @brief Retrieve the tray information from the message, OnUpdate stores it in the parts of the AGV.
          * @param _msg The message containing the tray information.
          */
-        void StoreAGVParts(int agv_id, gazebo::msgs::LogicalCameraImage &_msg);
+        void StoreAGVParts(int agv_id, const gazebo::msgs::LogicalCameraImage &_msg);
 
         /**
-         * @brief Retrieve the insert information from the message and store it in the insert_parts_ map.
+         * @brief Retrieve the insert information from the message, OnUpdate stores it in the insert_parts_ map.
          * @param _msg The message containing the insert information.
          */
-        void StoreStationParts(int station, gazebo::msgs::LogicalCameraImage &_msg);
-
-        int ScoreQuadrant(bool is_correct_part_type, bool is_correct_part_color, bool is_flipped_part, bool is_faulty_part);
-
-        void ScoreKittingTask(std::shared_ptr<ariac_common::Order> _order, std::string _submitted_order_id);
-        void ScoreAssemblyTask(std::shared_ptr<ariac_common::Order> _order, std::string _submitted_order_id);
-        void ScoreCombinedTask(std::shared_ptr<ariac_common::Order> _order, std::string _submitted_order_id);
-        ariac_common::KittingShipment ParseAGVTraySensorImage(gazebo::msgs::LogicalCameraImage &_msg);
-        ariac_common::AssemblyShipment ParseAssemblyStationImage(gazebo::msgs::LogicalCameraImage &_msg);
-        ariac_msgs::msg::QualityIssue CheckQuadrantQuality(int quadrant, ariac_common::KittingTask task, ariac_common::KittingShipment shipment, std::string order_id);
+        void StoreStationParts(int station, const gazebo::msgs::LogicalCameraImage &_msg);
+
+        //============== Scoring =================
+        /*!< A submitted order, copied from the state of the trial when the order was submitted. */
+        struct ScoringJob
+        {
+            /*!< Order to set the score of, only used by the update thread. */
+            std::shared_ptr<ariac_common::Order> order;
+            /*!< Faulty part challenge of the order, only used by the update thread. */
+            std::shared_ptr<ariac_common::FaultyPartChallenge> challenge;
+            /*!< Copy of the faulty part challenge of the order, used by the worker. */
+            std::shared_ptr<ariac_common::FaultyPartChallenge> challenge_copy;
+            /*!< Image of the AGV tray or assembly station when the order was submitted. */
+            ImagePtr image;
+            /*!< What the order is scored against, completed by the worker. */
+            ariac_scoring::Submission submission;
+            /*!< Quadrants and names of the parts found faulty by the worker. */
+            std::vector<std::pair<int, std::string>> newly_faulty;
+            std::shared_ptr<ariac_common::KittingScore> kitting_score;
+            std::shared_ptr<ariac_common::AssemblyScore> assembly_score;
+            std::shared_ptr<ariac_common::CombinedScore> combined_score;
+        };
+        /*!< Threads scoring the submitted orders. */
+        std::unique_ptr<ariac_scoring::WorkerPool> scoring_pool_;
+        /*!< Jobs scored by the workers, applied to the trial by the update thread. */
+        ariac_common::MpscQueue<std::shared_ptr<ScoringJob>> scored_jobs_;
+        /*!< Copy what a submitted order is scored against and queue it for the workers. */
+        void ScoreOrder(std::shared_ptr<ariac_common::Order> _order);
+        /*!< Parse the shipment and score the order, run by a worker. */
+        void RunScoringJob(ScoringJob &_job);
+        /*!< Set the scores computed by the workers and rename the parts found faulty. */
+        void ApplyScores();
+        ariac_common::KittingShipment ParseAGVTraySensorImage(const gazebo::msgs::LogicalCameraImage &_msg);
+        ariac_common::AssemblyShipment ParseAssemblyStationImage(const gazebo::msgs::LogicalCameraImage &_msg);
+        ariac_msgs::msg::QualityIssue CheckQuadrantQuality(int quadrant, const ariac_common::KittingTask &task, const ariac_common::KittingShipment &shipment, const std::string &order_id);
 
         void PerformQualityCheck(ariac_msgs::srv::PerformQualityCheck::Request::SharedPtr request,
                                  ariac_msgs::srv::PerformQualityCheck::Response::SharedPtr response);
 
+        //============== Quality Checks =================
+        /*!< Last quality check response of an order, with the AGV and shipment generation it was computed for. */
+        struct QualityCheckEntry
+        {
+            int agv;
+            std::uint64_t generation;
+            ariac_msgs::srv::PerformQualityCheck::Response response;
+        };
+        /*!< Quality check responses by order ID. Guarded by lock_, the service is queued for OnUpdate. */
+        std::unordered_map<std::string, QualityCheckEntry> quality_checks_;
+        /*!< Shipment on the tray of an AGV, parsed at most once per tray image. Requires lock_. */
+        std::shared_ptr<const ariac_common::KittingShipment> TrayShipment(int _agv_id, std::uint64_t &_generation);
+
         void GetPreAssemblyPoses(ariac_msgs::srv::GetPreAssemblyPoses::Request::SharedPtr request,
                                  ariac_msgs::srv::GetPreAssemblyPoses::Response::SharedPtr response);
 
-        std::map<std::string, int> part_types_ = {{"battery", ariac_msgs::msg::Part::BATTERY},
-                                                  {"pump", ariac_msgs::msg::Part::PUMP},
-                                                  {"sensor", ariac_msgs::msg::Part::SENSOR},
-                                                  {"regulator", ariac_msgs::msg::Part::REGULATOR}};
+        void RunCommands();
 
-        std::map<std::string, int> part_colors_ = {{"red", ariac_msgs::msg::Part::RED},
-                                                   {"green", ariac_msgs::msg::Part::GREEN},
-                                                   {"blue", ariac_msgs::msg::Part::BLUE},
-                                                   {"orange", ariac_msgs::msg::Part::ORANGE},
-                                                   {"purple", ariac_msgs::msg::Part::PURPLE}};
-
-        void WriteToLog();
-        std::string log_message_ = "";
+        /**
+         * @brief Create a service whose requests are handled by OnUpdate
+         *
+         * The executor thread only queues the request, the response is sent
+         * once the handler ran at the start of the next world update.
+         */
+        template <typename ServiceT>
+        typename rclcpp::Service<ServiceT>::SharedPtr CreateQueuedService(
+            const std::string &_name,
+            std::function<bool(const std::shared_ptr<typename ServiceT::Request>,
+                               std::shared_ptr<typename ServiceT::Response>)> _handler)
+        {
+            return ros_node_->create_service<ServiceT>(
+                _name,
+                [this, _name, _handler](std::shared_ptr<rclcpp::Service<ServiceT>> _service,
+                                        std::shared_ptr<rmw_request_id_t> _header,
+                                        std::shared_ptr<typename ServiceT::Request> _request)
+                {
+                    auto queued_time = std::chrono::steady_clock::now();
+                    commands_.Push(
+                        [this, _name, _handler, _service, _header, _request, queued_time]()
+                        {
+                            auto response = std::make_shared<typename ServiceT::Response>();
+                            _handler(_request, response);
+                            _service->send_response(*_header, *response);
+
+                            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - queued_time);
+                            RCLCPP_DEBUG_STREAM(ros_node_->get_logger(),
+                                                _name << " answered after " << latency.count() << " us");
+                        });
+                });
+        }
+
+        void OpenScoreLog();
+        void WriteSnapshot();
+        /*!< Scores of the trial, streamed to disk as each order is scored. */
+        ariac_scoring::ScoreLogWriter score_log_;
+        /*!< Path of the log files without extension, empty when not logging. */
+        std::string log_base_path_;
+        /*!< Submitted orders and what they were scored against, written next to the log. */
+        std::vector<ariac_scoring::Submission> submissions_;
+        /*!< Event log of the trial for ariac_trial_replay, only set when ARIAC_CAPTURE_FILE is set. */
+        std::unique_ptr<ariac_capture::CaptureWriter> capture_;
     };
     //==============================================================================
     TaskManagerPlugin::TaskManagerPlugin()
@@ -328,43 +503,55 @@ namespace ariac_plugins
     //==============================================================================
     TaskManagerPlugin::~TaskManagerPlugin()
     {
+        // The workers and the diagnostics timer use the node, stop them first
+        impl_->diagnostics_timer_.reset();
+        impl_->scoring_pool_.reset();
         impl_->ros_node_.reset();
     }
 
-    void TaskManagerPluginPrivate::WriteToLog()
+    void TaskManagerPluginPrivate::OpenScoreLog()
     {
         // Get the environment variable INSIDE_DOCKER
         auto inside_docker = std::getenv("INSIDE_DOCKER");
 
-        // compare inside_docker to "ok"
         if (inside_docker == NULL)
         {
-            // RCLCPP_WARN_STREAM_ONCE(ros_node_->get_logger(), "INSIDE_DOCKER environment variable not set");
             return;
         }
 
-        // Create a folder
+        // Create the folder, it may already exist
         std::string folder_path = "/home/ubuntu/logs/";
-        std::string command = "mkdir -p " + folder_path;
-        system(command.c_str());
+        mkdir(folder_path.c_str(), 0755);
 
         // remove .yaml from trial name
-        if (trial_name_.length() > 5)
+        std::string log_name = trial_name_;
+        if (log_name.length() > 5)
+        {
+            log_name.erase(log_name.length() - 5);
+        }
+
+        // Scores are appended as they come, the text report is rendered from the same records
+        log_base_path_ = folder_path + log_name;
+        if (!score_log_.Open(log_base_path_ + ".jsonl", log_base_path_ + ".txt"))
         {
-            trial_name_.erase(trial_name_.length() - 5);
+            RCLCPP_ERROR_STREAM(ros_node_->get_logger(), "Unable to open score log: " << log_base_path_ << ".jsonl");
+            log_base_path_.clear();
+            return;
         }
+        RCLCPP_WARN_STREAM_ONCE(ros_node_->get_logger(), "Generating log file: " << log_base_path_ << ".jsonl");
+    }
 
-        // Create a file name with the trial name
-        std::string file_name = trial_name_ + ".txt";
-        auto log_file_path = folder_path + file_name;
+    //==============================================================================
+    void TaskManagerPluginPrivate::WriteSnapshot()
+    {
+        if (log_base_path_.empty())
+        {
+            return;
+        }
 
-        // Open the log file
-        RCLCPP_WARN_STREAM_ONCE(ros_node_->get_logger(), "Generating log file: " << log_file_path);
-        auto log_file = std::ofstream(log_file_path);
-        // Write to log file
-        log_file << log_message_;
-        // Close the log file
-        log_file.close();
+        // Write the submissions of the trial so they can be rescored with ariac_batch_scorer
+        auto snapshot_file = std::ofstream(log_base_path_ + "_snapshot.txt");
+        ariac_scoring::WriteSubmissions(snapshot_file, submissions_);
     }
 
     //==============================================================================
@@ -387,25 +574,27 @@ namespace ariac_plugins
         impl_->gznode_ = gazebo::transport::NodePtr(new gazebo::transport::Node());
         impl_->gznode_->Init(impl_->world_->Name());
 
-        std::string tray1_topic = "/gazebo/world/agv_tray_sensor_1/sensor_base/agv_tray_sensor/models";
-        std::string tray2_topic = "/gazebo/world/agv_tray_sensor_2/sensor_base/agv_tray_sensor/models";
-        std::string tray3_topic = "/gazebo/world/agv_tray_sensor_3/sensor_base/agv_tray_sensor/models";
-        std::string tray4_topic = "/gazebo/world/agv_tray_sensor_4/sensor_base/agv_tray_sensor/models";
-
-        impl_->agv1_tray_sub_ = impl_->gznode_->Subscribe(tray1_topic, &TaskManagerPluginPrivate::AGV1TraySensorCallback, impl_.get());
-        impl_->agv2_tray_sub_ = impl_->gznode_->Subscribe(tray2_topic, &TaskManagerPluginPrivate::AGV2TraySensorCallback, impl_.get());
-        impl_->agv3_tray_sub_ = impl_->gznode_->Subscribe(tray3_topic, &TaskManagerPluginPrivate::AGV3TraySensorCallback, impl_.get());
-        impl_->agv4_tray_sub_ = impl_->gznode_->Subscribe(tray4_topic, &TaskManagerPluginPrivate::AGV4TraySensorCallback, impl_.get());
+        // The state of each AGV and station is allocated once, the vectors are never resized
+        impl_->agvs_ = std::vector<TaskManagerPluginPrivate::AGV>(_sdf->Get<unsigned int>("agv_count", 4u).first);
+        impl_->stations_ = std::vector<TaskManagerPluginPrivate::Station>(_sdf->Get<unsigned int>("station_count", 4u).first);
 
-        std::string station1_topic = "/gazebo/world/assembly_station_sensor_1/sensor_base/assembly_station_sensor/models";
-        std::string station2_topic = "/gazebo/world/assembly_station_sensor_2/sensor_base/assembly_station_sensor/models";
-        std::string station3_topic = "/gazebo/world/assembly_station_sensor_3/sensor_base/assembly_station_sensor/models";
-        std::string station4_topic = "/gazebo/world/assembly_station_sensor_4/sensor_base/assembly_station_sensor/models";
+        for (int agv_id = 1; agv_id <= static_cast<int>(impl_->agvs_.size()); agv_id++)
+        {
+            std::string tray_topic = "/gazebo/world/agv_tray_sensor_" + std::to_string(agv_id) + "/sensor_base/agv_tray_sensor/models";
+            impl_->agvs_[agv_id - 1].tray_sub = impl_->gznode_->Subscribe<gazebo::msgs::LogicalCameraImage>(
+                tray_topic,
+                [this, agv_id](ConstLogicalCameraImagePtr &_msg)
+                { impl_->UpdateAGVTrayImage(agv_id, _msg); });
+        }
 
-        impl_->station1_sub_ = impl_->gznode_->Subscribe(station1_topic, &TaskManagerPluginPrivate::Station1SensorCallback, impl_.get());
-        impl_->station2_sub_ = impl_->gznode_->Subscribe(station2_topic, &TaskManagerPluginPrivate::Station2SensorCallback, impl_.get());
-        impl_->station3_sub_ = impl_->gznode_->Subscribe(station3_topic, &TaskManagerPluginPrivate::Station3SensorCallback, impl_.get());
-        impl_->station4_sub_ = impl_->gznode_->Subscribe(station4_topic, &TaskManagerPluginPrivate::Station4SensorCallback, impl_.get());
+        for (int station = 1; station <= static_cast<int>(impl_->stations_.size()); station++)
+        {
+            std::string station_topic = "/gazebo/world/assembly_station_sensor_" + std::to_string(station) + "/sensor_base/assembly_station_sensor/models";
+            impl_->stations_[station - 1].sub = impl_->gznode_->Subscribe<gazebo::msgs::LogicalCameraImage>(
+                station_topic,
+                [this, station](ConstLogicalCameraImagePtr &_msg)
+                { impl_->UpdateStationImage(station, _msg); });
+        }
 
         RCLCPP_INFO(impl_->ros_node_->get_logger(), "Starting ARIAC 2023");
 
@@ -420,30 +609,56 @@ namespace ariac_plugins
         // Init subscribers
         impl_->trial_config_sub_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::Trial>(
             "/ariac/trial_config", qos.get_subscription_qos("/ariac/trial_config", rclcpp::QoS(1)),
-            std::bind(&TaskManagerPlugin::OnTrialCallback, this, std::placeholders::_1));
-
-        impl_->agv1_status_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::AGVStatus>(
-            "/ariac/agv1_status", qos.get_subscription_qos("/ariac/agv1_status", rclcpp::QoS(1)),
-            std::bind(&TaskManagerPlugin::OnAGV1StatusCallback, this, std::placeholders::_1));
-
-        impl_->agv2_status_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::AGVStatus>(
-            "/ariac/agv2_status", qos.get_subscription_qos("/ariac/agv2_status", rclcpp::QoS(1)),
-            std::bind(&TaskManagerPlugin::OnAGV2StatusCallback, this, std::placeholders::_1));
-
-        impl_->agv3_status_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::AGVStatus>(
-            "/ariac/agv3_status", qos.get_subscription_qos("/ariac/agv3_status", rclcpp::QoS(1)),
-            std::bind(&TaskManagerPlugin::OnAGV3StatusCallback, this, std::placeholders::_1));
+            [this](const ariac_msgs::msg::Trial::SharedPtr _msg)
+            {
+                impl_->commands_.Push([this, _msg]()
+                                      { OnTrialCallback(_msg); });
+            });
 
-        impl_->agv4_status_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::AGVStatus>(
-            "/ariac/agv4_status", qos.get_subscription_qos("/ariac/agv4_status", rclcpp::QoS(1)),
-            std::bind(&TaskManagerPlugin::OnAGV4StatusCallback, this, std::placeholders::_1));
+        for (int agv_id = 1; agv_id <= static_cast<int>(impl_->agvs_.size()); agv_id++)
+        {
+            std::string status_topic = "/ariac/agv" + std::to_string(agv_id) + "_status";
+            impl_->agvs_[agv_id - 1].status_sub = impl_->ros_node_->create_subscription<ariac_msgs::msg::AGVStatus>(
+                status_topic, qos.get_subscription_qos(status_topic, rclcpp::QoS(1)),
+                std::bind(&TaskManagerPlugin::OnAGVStatusCallback, this, agv_id, std::placeholders::_1));
+        }
 
         // Init publishers
         impl_->start_human_pub_ = impl_->ros_node_->create_publisher<std_msgs::msg::Bool>("/ariac/start_human", 10);
-        impl_->sensor_health_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::Sensors>("/ariac/sensor_health", 10);
+        // Plugins read the health from SensorHealthRegistry, late joiners outside the simulation get the last message
+        impl_->sensor_health_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::Sensors>(
+            "/ariac/sensor_health", rclcpp::QoS(1).transient_local());
         impl_->robot_health_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::Robots>("/ariac/robot_health", 10);
         impl_->competition_state_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::CompetitionState>("/ariac/competition_state", 10);
         impl_->order_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::Order>("/ariac/orders", 1);
+        impl_->order_score_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::OrderScore>("/ariac/order_scores", 10);
+
+        // Every plugin of the process records its latencies in the TimingRegistry, they are published from here
+        auto &timing = ariac_common::TimingRegistry::Instance();
+        impl_->update_timing_ = timing.Histogram("TaskManagerPlugin", "OnUpdate");
+        impl_->commands_timing_ = timing.Histogram("TaskManagerPlugin", "RunCommands");
+        impl_->apply_scores_timing_ = timing.Histogram("TaskManagerPlugin", "ApplyScores");
+        impl_->timed_events_timing_ = timing.Histogram("TaskManagerPlugin", "ProcessTimedEvents");
+        impl_->placement_triggers_timing_ = timing.Histogram("TaskManagerPlugin", "ProcessPartPlacementTriggers");
+        impl_->submission_triggers_timing_ = timing.Histogram("TaskManagerPlugin", "ProcessSubmissionTriggers");
+        impl_->sensors_health_timing_ = timing.Histogram("TaskManagerPlugin", "UpdateSensorsHealth");
+        impl_->store_agv_parts_timing_ = timing.Histogram("TaskManagerPlugin", "StoreAGVParts");
+        impl_->parse_station_timing_ = timing.Histogram("TaskManagerPlugin", "ParseAssemblyStationImage");
+        impl_->scoring_job_timing_ = timing.Histogram("TaskManagerPlugin", "RunScoringJob");
+
+        impl_->diagnostics_pub_ = impl_->ros_node_->create_publisher<diagnostic_msgs::msg::DiagnosticArray>("/diagnostics", 10);
+        impl_->diagnostics_timer_ = impl_->ros_node_->create_wall_timer(
+            std::chrono::seconds(1),
+            [this]()
+            {
+                auto msg = ariac_common::TimingRegistry::Instance().ToMsg();
+                msg.header.stamp = impl_->ros_node_->get_clock()->now();
+                impl_->diagnostics_pub_->publish(msg);
+            });
+
+        // Submitted orders are scored away from the update thread
+        impl_->scoring_pool_ = std::make_unique<ariac_scoring::WorkerPool>(
+            _sdf->Get<unsigned int>("scoring_threads", 2u).first);
         // Init sensor health
         impl_->break_beam_sensor_health_ = true;
         impl_->proximity_sensor_health_ = true;
@@ -451,6 +666,8 @@ namespace ariac_plugins
         impl_->lidar_sensor_health_ = true;
         impl_->camera_sensor_health_ = true;
         impl_->logical_camera_sensor_health_ = true;
+        ariac_common::SensorHealthRegistry::Instance().SetMask(ariac_common::SensorHealthRegistry::ALL);
+        impl_->sensor_health_pub_->publish(ariac_common::SensorHealthRegistry::ToMsg(ariac_common::SensorHealthRegistry::ALL));
         // Init robot health
         impl_->ceiling_robot_health_ = true;
         impl_->floor_robot_health_ = true;
@@ -468,54 +685,158 @@ namespace ariac_plugins
         impl_->ceiling_robot_grace_period_ = 10.0;
         // Init elapsed time
         impl_->elapsed_time_ = 0.0;
+
+        // Record the trial for offline replay
+        auto capture_file = std::getenv("ARIAC_CAPTURE_FILE");
+        if (capture_file != NULL)
+        {
+            impl_->capture_ = std::make_unique<ariac_capture::CaptureWriter>();
+            if (impl_->capture_->Open(capture_file))
+            {
+                RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Capturing trial to: " << capture_file);
+            }
+            else
+            {
+                RCLCPP_ERROR_STREAM(impl_->ros_node_->get_logger(), "Unable to create capture file: " << capture_file);
+                impl_->capture_.reset();
+            }
+        }
         double publish_rate = 10;
         impl_->update_ns_ = int((1 / publish_rate) * 1e9);
         impl_->first_publish_ = true;
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::AGV1TraySensorCallback(ConstLogicalCameraImagePtr &_msg)
+    std::size_t TaskManagerPluginPrivate::HashImageContent(const gazebo::msgs::LogicalCameraImage &_msg)
+    {
+        // Parts are identified by model name only, so poses are not part of the hash.
+        // Per-model hashes are mixed and summed so the result does not depend on the
+        // order in which the sensor reports the models.
+        std::size_t hash = _msg.model_size();
+        for (int i = 0; i < _msg.model_size(); i++)
+        {
+            std::size_t h = std::hash<std::string>{}(_msg.model(i).name());
+            h ^= (h >> 33);
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= (h >> 33);
+            hash += h;
+        }
+        return hash;
+    }
+
+    //==============================================================================
+    std::shared_ptr<ariac_common::Order> TaskManagerPluginPrivate::FindOrder(const std::string &order_id) const
     {
-        agv_tray_images_.insert_or_assign(1, *_msg);
+        auto it = orders_by_id_.find(order_id);
+        if (it == orders_by_id_.end())
+            return nullptr;
+        return it->second;
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::AGV2TraySensorCallback(ConstLogicalCameraImagePtr &_msg)
+    void TaskManagerPluginPrivate::UpdateAGVTrayImage(int agv_id, ConstLogicalCameraImagePtr &_msg)
     {
-        agv_tray_images_.insert_or_assign(2, *_msg);
+        // Readers take their own reference to the image, so it is published without copying or locking
+        auto &agv = agvs_[agv_id - 1];
+        boost::atomic_store(&agv.tray_image, ImagePtr(_msg));
+
+        // The capture is synchronized on its own, the image is not held up by the world update
+        if (capture_)
+            capture_->WriteTrayImage(elapsed_time_, agv_id, ToSensedModels(*_msg));
+
+        // Only parse the image again when the set of models on the tray changed
+        auto hash = HashImageContent(*_msg);
+        if (agv.tray_hash.exchange(hash) == hash)
+            return;
+
+        StoreAGVParts(agv_id, *_msg);
+    }
+
+    //==============================================================================
+    void TaskManagerPluginPrivate::QueueAddedAGVParts(int agv_id,
+                                                      const std::vector<ariac_common::Part> &old_parts,
+                                                      const std::vector<ariac_common::Part> &new_parts)
+    {
+        if (part_placement_triggers_.empty())
+            return;
+
+        // Count the parts that were already on the tray, each one cancels out one identical new part
+        std::unordered_map<int, int> previous_counts;
+        for (const auto &part : old_parts)
+            previous_counts[PartPlacementKey(agv_id, part.GetType(), part.GetColor())]++;
+
+        for (const auto &part : new_parts)
+        {
+            int key = PartPlacementKey(agv_id, part.GetType(), part.GetColor());
+            auto it = previous_counts.find(key);
+            if (it != previous_counts.end() && it->second > 0)
+            {
+                it->second--;
+                continue;
+            }
+            if (part_placement_triggers_.count(key) > 0)
+                added_agv_parts_.push_back(key);
+        }
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::AGV3TraySensorCallback(ConstLogicalCameraImagePtr &_msg)
+    void TaskManagerPluginPrivate::UpdateStationImage(int station, ConstLogicalCameraImagePtr &_msg)
     {
-        agv_tray_images_.insert_or_assign(3, *_msg);
+        auto &station_state = stations_[station - 1];
+        boost::atomic_store(&station_state.image, ImagePtr(_msg));
+
+        if (capture_)
+            capture_->WriteStationImage(elapsed_time_, station, ToSensedModels(*_msg));
+
+        // Only parse the image again when the set of models at the station changed
+        auto hash = HashImageContent(*_msg);
+        if (station_state.hash.exchange(hash) == hash)
+            return;
+
+        StoreStationParts(station, *_msg);
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::AGV4TraySensorCallback(ConstLogicalCameraImagePtr &_msg)
+    TaskManagerPluginPrivate::AGV *TaskManagerPluginPrivate::FindAGV(int _agv_id)
     {
-        agv_tray_images_.insert_or_assign(4, *_msg);
+        if (_agv_id < 1 || _agv_id > static_cast<int>(agvs_.size()))
+            return nullptr;
+        return &agvs_[_agv_id - 1];
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::Station1SensorCallback(ConstLogicalCameraImagePtr &_msg)
+    TaskManagerPluginPrivate::Station *TaskManagerPluginPrivate::FindStation(int _station)
     {
-        assembly_station_images_.insert_or_assign(1, *_msg);
+        if (_station < 1 || _station > static_cast<int>(stations_.size()))
+            return nullptr;
+        return &stations_[_station - 1];
     }
+
     //==============================================================================
-    void TaskManagerPluginPrivate::Station2SensorCallback(ConstLogicalCameraImagePtr &_msg)
+    TaskManagerPluginPrivate::ImagePtr TaskManagerPluginPrivate::LatestTrayImage(int _agv_id)
     {
-        assembly_station_images_.insert_or_assign(2, *_msg);
+        static const ImagePtr empty_image = boost::make_shared<gazebo::msgs::LogicalCameraImage>();
+
+        auto agv = FindAGV(_agv_id);
+        auto image = agv ? boost::atomic_load(&agv->tray_image) : ImagePtr();
+        return image ? image : empty_image;
     }
+
     //==============================================================================
-    void TaskManagerPluginPrivate::Station3SensorCallback(ConstLogicalCameraImagePtr &_msg)
+    TaskManagerPluginPrivate::ImagePtr TaskManagerPluginPrivate::LatestStationImage(int _station)
     {
-        assembly_station_images_.insert_or_assign(3, *_msg);
+        static const ImagePtr empty_image = boost::make_shared<gazebo::msgs::LogicalCameraImage>();
+
+        auto station = FindStation(_station);
+        auto image = station ? boost::atomic_load(&station->image) : ImagePtr();
+        return image ? image : empty_image;
     }
+
     //==============================================================================
-    void TaskManagerPluginPrivate::Station4SensorCallback(ConstLogicalCameraImagePtr &_msg)
+    int TaskManagerPluginPrivate::AGVLocation(int _agv_id)
     {
-        assembly_station_images_.insert_or_assign(4, *_msg);
+        auto agv = FindAGV(_agv_id);
+        return agv ? static_cast<int>(agv->location.load()) : -1;
     }
 
     //==============================================================================
@@ -641,470 +962,229 @@ namespace ariac_plugins
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessTemporalOrders()
+    void TaskManagerPlugin::ScheduleTimedEvent(double _time, std::function<void()> _action)
     {
-        for (const auto &order : impl_->time_based_orders_)
-        {
-            if (!order->IsAnnounced())
-            {
-                if (impl_->elapsed_time_ >= order->GetAnnouncementTime() && !order->IsAnnounced())
-                {
-                    auto order_message = BuildOrderMsg(order);
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Announcing order");
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "\n" << *order);
-
-                    impl_->order_pub_->publish(order_message);
-                    impl_->announced_orders_.push_back(order_message.id);
-                    order->SetAnnouncedTime(impl_->elapsed_time_);
-                    order->SetIsAnnounced();
-                    impl_->total_orders_--;
-                }
-            }
-        }
+        impl_->timed_events_.push({_time, impl_->timed_event_sequence_++, std::move(_action)});
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessOnPartPlacementOrders()
+    void TaskManagerPlugin::SetElapsedTime(double _time)
     {
-        for (const auto &order : impl_->on_part_placement_orders_)
-        {
-            // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Order: " << order->GetId());
-
-            if (!order->IsAnnounced())
-            {
-                auto part_condition = order->GetPart();
-                auto agv_condition = order->GetAgv();
-
-                auto parts = impl_->agv_parts_.find(agv_condition)->second;
-
-                if (parts.empty())
-                {
-                    return;
-                }
-
-                for (const auto &agv_part : parts)
-                {
-                    // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Part type: " << agv_part.GetType());
-                    // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Part color: " << agv_part.GetColor());
-                    // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Part condition type: " << part_condition->GetType());
-                    // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Part condition color: " << part_condition->GetColor());
-                    if (agv_part.GetType() == part_condition->GetType() && agv_part.GetColor() == part_condition->GetColor())
-                    {
-                        auto order_message = BuildOrderMsg(order);
-
-                        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Announcing order");
-                        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "\n" << *order);
-                        impl_->order_pub_->publish(order_message);
-                        impl_->announced_orders_.push_back(order_message.id);
-                        order->SetAnnouncedTime(impl_->elapsed_time_);
-                        order->SetIsAnnounced();
-                        impl_->total_orders_--;
-                    }
-                }
-            }
-        }
+        impl_->elapsed_time_ = _time;
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessOnSubmissionOrders()
+    void TaskManagerPlugin::ProcessTimedEvents()
     {
-        for (const auto &order : impl_->on_order_submission_orders_)
+        ariac_common::ScopedTimer timer(impl_->timed_events_timing_);
+        // Only the events that are due are popped, the rest of the heap is untouched
+        while (!impl_->timed_events_.empty() && impl_->timed_events_.top().time <= impl_->elapsed_time_)
         {
-            if (!order->IsAnnounced())
-            {
-                // Get the id of the order which will trigger the announcement of order_ins
-                auto trigger_order = order->GetOrderId();
-
-                // parse the list of submitted orders to see if the trigger order has been submitted
-                if (std::find(impl_->submitted_orders_.begin(), impl_->submitted_orders_.end(), trigger_order) != impl_->submitted_orders_.end())
-                {
-
-                    auto order_message = BuildOrderMsg(order);
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Announcing order");
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "\n" << *order);
-                    impl_->order_pub_->publish(order_message);
-                    order->SetAnnouncedTime(impl_->elapsed_time_);
-                    order->SetIsAnnounced();
-                    impl_->total_orders_--;
-                }
-            }
+            // Actions may schedule new events, so take the action out before running it
+            auto action = impl_->timed_events_.top().action;
+            impl_->timed_events_.pop();
+            action();
         }
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessOrdersToAnnounce()
+    void TaskManagerPlugin::AnnounceOrder(std::shared_ptr<ariac_common::Order> _order)
     {
-        if (!impl_->time_based_orders_.empty())
-        {
-            ProcessTemporalOrders();
-        }
-        // TODO: Implement on part placement and on submission orders
-        if (!impl_->on_part_placement_orders_.empty())
-        {
-            ProcessOnPartPlacementOrders();
-        }
-        if (!impl_->on_order_submission_orders_.empty())
-        {
-            ProcessOnSubmissionOrders();
-        }
+        if (_order->IsAnnounced())
+            return;
+
+        auto order_message = BuildOrderMsg(_order);
+        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Announcing order");
+        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "\n" << *_order);
+
+        impl_->order_pub_->publish(order_message);
+        impl_->announced_orders_.push_back(order_message.id);
+        if (impl_->capture_)
+            impl_->capture_->WriteOrderAnnounced(impl_->elapsed_time_, *_order);
+        _order->SetAnnouncedTime(impl_->elapsed_time_);
+        _order->SetIsAnnounced();
+        impl_->total_orders_--;
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessInProgressRobotMalfunctions()
+    void TaskManagerPlugin::AddPartPlacementTrigger(unsigned int _agv,
+                                                    std::shared_ptr<ariac_common::Part> _part,
+                                                    std::function<void()> _action)
     {
-        for (const auto &robot_malfunction : impl_->in_progress_robot_malfunctions_)
-        {
-            if (robot_malfunction->HasStarted() && !robot_malfunction->HasCompleted())
-            {
-                auto duration = robot_malfunction->GetDuration();
-                auto start_time = robot_malfunction->GetStartTime();
-
-                if (impl_->elapsed_time_ >= start_time + duration)
-                {
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Stopping robot malfunction challenge at time: " << impl_->elapsed_time_);
-                    robot_malfunction->SetCompleted();
-
-                    impl_->ceiling_robot_health_ = true;
-                    impl_->floor_robot_health_ = true;
-                    // remove the challenge from the list
-                    impl_->in_progress_robot_malfunctions_.erase(std::remove(impl_->in_progress_robot_malfunctions_.begin(),
-                                                                             impl_->in_progress_robot_malfunctions_.end(), robot_malfunction),
-                                                                 impl_->in_progress_robot_malfunctions_.end());
-                }
-            }
-        }
+        int key = TaskManagerPluginPrivate::PartPlacementKey(_agv, _part->GetType(), _part->GetColor());
+        impl_->part_placement_triggers_[key].push_back(std::move(_action));
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessInProgressSensorBlackouts()
+    void TaskManagerPlugin::ProcessPartPlacementTriggers()
     {
-        for (const auto &sensor_blackout : impl_->in_progress_sensor_blackouts_)
+        ariac_common::ScopedTimer timer(impl_->placement_triggers_timing_);
+        // Only the parts added since the last call are checked, each trigger fires once
+        for (int key : impl_->added_agv_parts_)
         {
-            if (sensor_blackout->HasStarted() && !sensor_blackout->HasCompleted())
-            {
-                auto duration = sensor_blackout->GetDuration();
-                auto start_time = sensor_blackout->GetStartTime();
-                // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Sensor blackout challenge in progress");
-                // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), start_time);
-                // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), duration);
+            auto it = impl_->part_placement_triggers_.find(key);
+            if (it == impl_->part_placement_triggers_.end())
+                continue;
 
-                if (impl_->elapsed_time_ >= start_time + duration)
-                {
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Stopping sensor blackout challenge at time: " << impl_->elapsed_time_);
-                    sensor_blackout->SetCompleted();
-                    impl_->break_beam_sensor_health_ = true;
-                    impl_->proximity_sensor_health_ = true;
-                    impl_->laser_profiler_sensor_health_ = true;
-                    impl_->lidar_sensor_health_ = true;
-                    impl_->camera_sensor_health_ = true;
-                    impl_->logical_camera_sensor_health_ = true;
-                    // remove the sensor blackout from the list
-                    impl_->in_progress_sensor_blackouts_.erase(std::remove(impl_->in_progress_sensor_blackouts_.begin(),
-                                                                           impl_->in_progress_sensor_blackouts_.end(), sensor_blackout),
-                                                               impl_->in_progress_sensor_blackouts_.end());
-                }
-            }
+            auto actions = std::move(it->second);
+            impl_->part_placement_triggers_.erase(it);
+            for (auto &action : actions)
+                action();
         }
+        impl_->added_agv_parts_.clear();
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessTemporalRobotMalfunctions()
+    void TaskManagerPlugin::QueueAddedAGVParts(unsigned int _agv,
+                                               const std::vector<ariac_common::Part> &_old_parts,
+                                               const std::vector<ariac_common::Part> &_new_parts)
     {
-        for (const auto &robot_malfunction : impl_->time_based_robot_malfunctions_)
-        {
-            if (impl_->elapsed_time_ >= robot_malfunction->GetTriggerTime() && !robot_malfunction->HasStarted())
-            {
-                RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting robot malfunction challenge at time: " << impl_->elapsed_time_);
-                // Duration of the challenge
-                auto duration = robot_malfunction->GetDuration();
-                // Get the list of robots to disable for the challenge
-                auto robots_to_disable = robot_malfunction->GetRobotsToDisable();
-                // Disable the robots according to the list
-                SetRobotsHealth(robots_to_disable);
-                robot_malfunction->SetStartTime(impl_->elapsed_time_);
-                robot_malfunction->SetStarted();
-                impl_->in_progress_robot_malfunctions_.push_back(robot_malfunction);
-            }
-        }
+        impl_->QueueAddedAGVParts(_agv, _old_parts, _new_parts);
     }
 
     //==============================================================================
-    void
-    TaskManagerPlugin::ProcessOnSubmissionRobotMalfunctions()
+    void TaskManagerPlugin::AddSubmissionTrigger(const std::string &_order_id, std::function<void()> _action)
     {
-        for (const auto &rm : impl_->on_submission_robot_malfunctions_)
-        {
-            // Get the id of the order which will trigger the start of this challenge
-            auto trigger_order = rm->GetTriggerOrderId();
+        // The trigger order may already be submitted, fire on the next update
+        if (impl_->submitted_orders_.count(_order_id) > 0)
+            QueueSubmissionTriggers(_order_id);
 
-            // parse the list of submitted orders to see if the trigger order has been submitted
-            if (std::find(impl_->submitted_orders_.begin(), impl_->submitted_orders_.end(), trigger_order) != impl_->submitted_orders_.end())
-            {
-                if (!rm->HasStarted())
-                {
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting robot malfunction challenge at time: " << impl_->elapsed_time_);
-                    auto duration = rm->GetDuration();
-                    auto robots_to_disable = rm->GetRobotsToDisable();
-                    SetRobotsHealth(robots_to_disable);
-                    rm->SetStartTime(impl_->elapsed_time_);
-                    rm->SetStarted();
-                    impl_->in_progress_robot_malfunctions_.push_back(rm);
-                }
-            }
-        }
+        impl_->submission_triggers_[_order_id].push_back(std::move(_action));
     }
 
     //==============================================================================
-    void
-    TaskManagerPlugin::SetSensorsHealth(const std::vector<std::string> &_sensors_to_disable)
+    void TaskManagerPlugin::ProcessSubmissionTriggers()
     {
-        for (const auto &sensor : _sensors_to_disable)
+        ariac_common::ScopedTimer timer(impl_->submission_triggers_timing_);
+        // Only the orders submitted since the last call are checked, each trigger fires once
+        for (const auto &order_id : impl_->newly_submitted_orders_)
         {
-            if (sensor == "break_beam")
-                impl_->break_beam_sensor_health_ = false;
-            if (sensor == "proximity")
-                impl_->proximity_sensor_health_ = false;
-            if (sensor == "laser_profiler")
-                impl_->laser_profiler_sensor_health_ = false;
-            if (sensor == "lidar")
-                impl_->lidar_sensor_health_ = false;
-            if (sensor == "camera")
-                impl_->camera_sensor_health_ = false;
-            if (sensor == "logical_camera")
-                impl_->logical_camera_sensor_health_ = false;
+            auto it = impl_->submission_triggers_.find(order_id);
+            if (it == impl_->submission_triggers_.end())
+                continue;
+
+            auto actions = std::move(it->second);
+            impl_->submission_triggers_.erase(it);
+            for (auto &action : actions)
+                action();
         }
+        impl_->newly_submitted_orders_.clear();
     }
 
     //==============================================================================
-    void
-    TaskManagerPlugin::SetRobotsHealth(const std::vector<std::string> &_robots_to_disable)
+    void TaskManagerPlugin::QueueSubmissionTriggers(const std::string &_order_id)
     {
-        for (const auto &robot : _robots_to_disable)
-        {
-            if (robot == "ceiling_robot")
-                impl_->ceiling_robot_health_ = false;
-            if (robot == "floor_robot")
-                impl_->floor_robot_health_ = false;
-        }
+        impl_->newly_submitted_orders_.push_back(_order_id);
     }
 
     //==============================================================================
-    void
-    TaskManagerPlugin::ProcessOnSubmissionSensorBlackouts()
+    void TaskManagerPlugin::StartRobotMalfunction(std::shared_ptr<ariac_common::RobotMalfunction> _malfunction)
     {
-        for (const auto &sb : impl_->on_submission_sensor_blackouts_)
-        {
-            // Get the id of the order which will trigger the announcement of order_ins
-            auto trigger_order = sb->GetTriggerOrderId();
+        if (_malfunction->HasStarted())
+            return;
 
-            // parse the list of submitted orders to see if the trigger order has been submitted
-            if (std::find(impl_->submitted_orders_.begin(), impl_->submitted_orders_.end(), trigger_order) != impl_->submitted_orders_.end())
-            {
-                if (!sb->HasStarted())
-                {
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting sensor blackout challenge at time: " << impl_->elapsed_time_);
-                    auto duration = sb->GetDuration();
-                    auto sensors_to_disable = sb->GetSensorsToDisable();
-                    SetSensorsHealth(sensors_to_disable);
-                    sb->SetStartTime(impl_->elapsed_time_);
-                    sb->SetStarted();
-                    impl_->in_progress_sensor_blackouts_.push_back(sb);
-                }
-            }
-        }
+        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting robot malfunction challenge at time: " << impl_->elapsed_time_.load());
+        // Disable the robots according to the list
+        SetRobotsHealth(_malfunction->GetRobotsToDisable());
+        _malfunction->SetStartTime(impl_->elapsed_time_);
+        _malfunction->SetStarted();
+        if (impl_->capture_)
+            impl_->capture_->WriteChallengeStarted(impl_->elapsed_time_, ariac_msgs::msg::Challenge::ROBOT_MALFUNCTION, "robot malfunction");
+
+        ScheduleTimedEvent(impl_->elapsed_time_ + _malfunction->GetDuration(),
+                           [this, _malfunction]()
+                           { EndRobotMalfunction(_malfunction); });
     }
 
     //==============================================================================
-    void
-    TaskManagerPlugin::ProcessTemporalSensorBlackouts()
+    void TaskManagerPlugin::EndRobotMalfunction(std::shared_ptr<ariac_common::RobotMalfunction> _malfunction)
     {
-        for (const auto &sensor_blackout : impl_->time_based_sensor_blackouts_)
-        {
-            if (impl_->elapsed_time_ >= sensor_blackout->GetTriggerTime() && !sensor_blackout->HasStarted())
-            {
-                RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting sensor blackout challenge at time: " << impl_->elapsed_time_);
-                auto sensors_to_disable = sensor_blackout->GetSensorsToDisable();
+        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Stopping robot malfunction challenge at time: " << impl_->elapsed_time_.load());
+        _malfunction->SetCompleted();
 
-                SetSensorsHealth(sensors_to_disable);
-                sensor_blackout->SetStartTime(impl_->elapsed_time_);
-                sensor_blackout->SetStarted();
-                impl_->in_progress_sensor_blackouts_.push_back(sensor_blackout);
-            }
-        }
+        impl_->ceiling_robot_health_ = true;
+        impl_->floor_robot_health_ = true;
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessTemporalHumanChallenge()
+    void TaskManagerPlugin::StartSensorBlackout(std::shared_ptr<ariac_common::SensorBlackout> _blackout)
     {
-        // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Elapsed time: " << impl_->elapsed_time_);
-        if (impl_->elapsed_time_ >= impl_->time_based_human_challenge_->GetTriggerTime())
-        {
-            RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting human challenge");
-            std_msgs::msg::Bool msg;
-            msg.data = true;
-            impl_->start_human_pub_->publish(msg);
-            impl_->time_based_human_challenge_->SetStartTime(impl_->elapsed_time_);
-            impl_->time_based_human_challenge_->SetStarted();
-        }
-    }
+        if (_blackout->HasStarted())
+            return;
 
-    //==============================================================================
-    void TaskManagerPlugin::ProcessChallengesToAnnounce()
-    {
-        // time based human challenge
-        if (impl_->time_based_human_challenge_)
-        {
-            if (!impl_->time_based_human_challenge_->HasStarted())
-            {
-                ProcessTemporalHumanChallenge();
-            }
-        }
-        // on part placement human challenge
-        if (impl_->on_part_placement_human_challenge_)
-        {
-            if (!impl_->on_part_placement_human_challenge_->HasStarted())
-            {
-                ProcessOnPartPlacementHumanChallenge();
-            }
-        }
-        // on order submission human challenge
-        if (impl_->on_order_submission_human_challenge_)
-        {
-            if (!impl_->on_order_submission_human_challenge_->HasStarted())
-            {
-                ProcessOnOrderSubmissionHumanChallenge();
-            }
-        }
+        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting sensor blackout challenge at time: " << impl_->elapsed_time_.load());
+        SetSensorsHealth(_blackout->GetSensorsToDisable());
+        _blackout->SetStartTime(impl_->elapsed_time_);
+        _blackout->SetStarted();
+        if (impl_->capture_)
+            impl_->capture_->WriteChallengeStarted(impl_->elapsed_time_, ariac_msgs::msg::Challenge::SENSOR_BLACKOUT, "sensor blackout");
 
-        if (!impl_->time_based_sensor_blackouts_.empty())
-            ProcessTemporalSensorBlackouts();
-        if (!impl_->on_part_placement_sensor_blackouts_.empty())
-            ProcessOnPartPlacementSensorBlackouts();
-        if (!impl_->on_submission_sensor_blackouts_.empty())
-            ProcessOnSubmissionSensorBlackouts();
-        if (!impl_->time_based_robot_malfunctions_.empty())
-            ProcessTemporalRobotMalfunctions();
-        if (!impl_->on_part_placement_robot_malfunctions_.empty())
-            ProcessOnPartPlacementRobotMalfunctions();
-        if (!impl_->on_submission_robot_malfunctions_.empty())
-            ProcessOnSubmissionRobotMalfunctions();
+        ScheduleTimedEvent(impl_->elapsed_time_ + _blackout->GetDuration(),
+                           [this, _blackout]()
+                           { EndSensorBlackout(_blackout); });
     }
 
     //==============================================================================
-    void
-    TaskManagerPlugin::ProcessOnOrderSubmissionHumanChallenge()
+    void TaskManagerPlugin::EndSensorBlackout(std::shared_ptr<ariac_common::SensorBlackout> _blackout)
     {
-
-        // Get the id of the order which will trigger the start of this challenge
-        auto trigger_order = impl_->on_order_submission_human_challenge_->GetTriggerOrderId();
-
-        // parse the list of submitted orders to see if the trigger order has been submitted
-        if (std::find(impl_->submitted_orders_.begin(), impl_->submitted_orders_.end(), trigger_order) != impl_->submitted_orders_.end())
-        {
-            RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting human challenge");
-            std_msgs::msg::Bool msg;
-            msg.data = true;
-            impl_->start_human_pub_->publish(msg);
-            impl_->on_order_submission_human_challenge_->SetStartTime(impl_->elapsed_time_);
-            impl_->on_order_submission_human_challenge_->SetStarted();
-        }
+        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Stopping sensor blackout challenge at time: " << impl_->elapsed_time_.load());
+        _blackout->SetCompleted();
+        impl_->break_beam_sensor_health_ = true;
+        impl_->proximity_sensor_health_ = true;
+        impl_->laser_profiler_sensor_health_ = true;
+        impl_->lidar_sensor_health_ = true;
+        impl_->camera_sensor_health_ = true;
+        impl_->logical_camera_sensor_health_ = true;
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessOnPartPlacementHumanChallenge()
+    void
+    TaskManagerPlugin::SetSensorsHealth(const std::vector<std::string> &_sensors_to_disable)
     {
-        auto agv_condition = impl_->on_part_placement_human_challenge_->GetAgv();
-        auto part_condition = impl_->on_part_placement_human_challenge_->GetPart();
-
-        // Get the list of parts on the agv
-        auto agv_parts = impl_->agv_parts_.find(agv_condition)->second;
-
-        // if the agv is empty, skip it
-        if (agv_parts.empty())
-            return;
-
-        for (const auto &agv_part : agv_parts)
+        for (const auto &sensor : _sensors_to_disable)
         {
-            if (agv_part.GetType() == part_condition->GetType() && agv_part.GetColor() == part_condition->GetColor())
-            {
-                RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting human challenge");
-                std_msgs::msg::Bool msg;
-                msg.data = true;
-                impl_->start_human_pub_->publish(msg);
-                impl_->on_part_placement_human_challenge_->SetStartTime(impl_->elapsed_time_);
-                impl_->on_part_placement_human_challenge_->SetStarted();
-            }
+            if (sensor == "break_beam")
+                impl_->break_beam_sensor_health_ = false;
+            if (sensor == "proximity")
+                impl_->proximity_sensor_health_ = false;
+            if (sensor == "laser_profiler")
+                impl_->laser_profiler_sensor_health_ = false;
+            if (sensor == "lidar")
+                impl_->lidar_sensor_health_ = false;
+            if (sensor == "camera")
+                impl_->camera_sensor_health_ = false;
+            if (sensor == "logical_camera")
+                impl_->logical_camera_sensor_health_ = false;
         }
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessOnPartPlacementRobotMalfunctions()
+    void
+    TaskManagerPlugin::SetRobotsHealth(const std::vector<std::string> &_robots_to_disable)
     {
-        for (const auto &part_placement_challenge : impl_->on_part_placement_robot_malfunctions_)
+        for (const auto &robot : _robots_to_disable)
         {
-            // if this challenge is in progress, skip it
-            if (part_placement_challenge->HasStarted())
-                return;
-
-            auto agv_condition = part_placement_challenge->GetAgv();
-            auto part_condition = part_placement_challenge->GetPart();
-
-            // Get the list of parts on the agv
-            auto agv_parts = impl_->agv_parts_.find(agv_condition)->second;
-
-            // if the agv is empty, skip it
-            if (agv_parts.empty())
-                return;
-
-            for (const auto &agv_part : agv_parts)
-            {
-                if (agv_part.GetType() == part_condition->GetType() && agv_part.GetColor() == part_condition->GetColor())
-                {
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting robot malfunction challenge at time: " << impl_->elapsed_time_);
-                    auto robots_to_disable = part_placement_challenge->GetRobotsToDisable();
-                    // Disable the robots according to the list
-                    SetRobotsHealth(robots_to_disable);
-                    part_placement_challenge->SetStartTime(impl_->elapsed_time_);
-                    part_placement_challenge->SetStarted();
-                    impl_->in_progress_robot_malfunctions_.push_back(part_placement_challenge);
-                }
-            }
+            if (robot == "ceiling_robot")
+                impl_->ceiling_robot_health_ = false;
+            if (robot == "floor_robot")
+                impl_->floor_robot_health_ = false;
         }
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessOnPartPlacementSensorBlackouts()
+    void TaskManagerPlugin::StartHumanChallenge(std::shared_ptr<ariac_common::HumanChallenge> _challenge)
     {
-        for (const auto &part_placement_challenge : impl_->on_part_placement_sensor_blackouts_)
-        {
-            // if this challenge is in progress, skip it
-            if (part_placement_challenge->HasStarted())
-                return;
-
-            auto agv_condition = part_placement_challenge->GetAgv();
-            auto part_condition = part_placement_challenge->GetPart();
-
-            // Get the list of parts on the agv
-            auto agv_parts = impl_->agv_parts_.find(agv_condition)->second;
-
-            // if the agv is empty, skip it
-            if (agv_parts.empty())
-                return;
-
-            for (const auto &agv_part : agv_parts)
-            {
-                if (agv_part.GetType() == part_condition->GetType() && agv_part.GetColor() == part_condition->GetColor())
-                {
-                    RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting sensor blackout challenge at time: " << impl_->elapsed_time_);
-                    auto sensors_to_disable = part_placement_challenge->GetSensorsToDisable();
+        if (_challenge->HasStarted())
+            return;
 
-                    SetSensorsHealth(sensors_to_disable);
-                    part_placement_challenge->SetStartTime(impl_->elapsed_time_);
-                    part_placement_challenge->SetStarted();
-                    impl_->in_progress_sensor_blackouts_.push_back(part_placement_challenge);
-                }
-            }
-        }
+        RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Starting human challenge");
+        std_msgs::msg::Bool msg;
+        msg.data = true;
+        impl_->start_human_pub_->publish(msg);
+        _challenge->SetStartTime(impl_->elapsed_time_);
+        _challenge->SetStarted();
+        if (impl_->capture_)
+            impl_->capture_->WriteChallengeStarted(impl_->elapsed_time_, ariac_msgs::msg::Challenge::HUMAN, "human");
     }
 
     //==============================================================================
@@ -1118,7 +1198,14 @@ namespace ariac_plugins
     //==============================================================================
     void TaskManagerPlugin::OnUpdate()
     {
+        // Includes the time spent waiting for the lock
+        ariac_common::ScopedTimer timer(impl_->update_timing_);
         std::lock_guard<std::mutex> lock(impl_->lock_);
+
+        // Requests received since the last update are handled before anything else
+        impl_->RunCommands();
+        impl_->ApplyScores();
+
         auto current_sim_time = impl_->world_->SimTime();
 
         // if the competition has ended, disable all sensors and robots
@@ -1152,19 +1239,19 @@ namespace ariac_plugins
         {
             // Create the start competition service
             // Now competitors can call this service to start the competition
-            impl_->start_competition_service_ = impl_->ros_node_->create_service<std_srvs::srv::Trigger>("/ariac/start_competition", std::bind(&TaskManagerPlugin::StartCompetitionServiceCallback, this, std::placeholders::_1, std::placeholders::_2));
+            impl_->start_competition_service_ = impl_->CreateQueuedService<std_srvs::srv::Trigger>("/ariac/start_competition", std::bind(&TaskManagerPlugin::StartCompetitionServiceCallback, this, std::placeholders::_1, std::placeholders::_2));
 
             RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "You can now start the competition!");
             impl_->current_state_ = ariac_msgs::msg::CompetitionState::READY;
 
             // Create the end competition service
             // Now competitors can call this service to end the competition
-            impl_->end_competition_service_ = impl_->ros_node_->create_service<std_srvs::srv::Trigger>(
+            impl_->end_competition_service_ = impl_->CreateQueuedService<std_srvs::srv::Trigger>(
                 "/ariac/end_competition",
                 std::bind(&TaskManagerPlugin::EndCompetitionServiceCallback,
                           this, std::placeholders::_1, std::placeholders::_2));
 
-            impl_->human_safe_zone_penalty_service_ = impl_->ros_node_->create_service<std_srvs::srv::Trigger>(
+            impl_->human_safe_zone_penalty_service_ = impl_->CreateQueuedService<std_srvs::srv::Trigger>(
                 "/ariac/set_human_safe_zone_penalty",
                 std::bind(&TaskManagerPlugin::SafeZonePenaltyServiceCallback,
                           this, std::placeholders::_1, std::placeholders::_2));
@@ -1194,24 +1281,30 @@ namespace ariac_plugins
             impl_->start_competition_time_ = current_sim_time;
             impl_->competition_time_set_ = true;
 
-            impl_->submit_order_service_ = impl_->ros_node_->create_service<ariac_msgs::srv::SubmitOrder>(
+            impl_->submit_order_service_ = impl_->CreateQueuedService<ariac_msgs::srv::SubmitOrder>(
                 "/ariac/submit_order",
                 std::bind(&TaskManagerPlugin::SubmitOrderServiceCallback,
                           this, std::placeholders::_1, std::placeholders::_2));
 
-            impl_->quality_check_service_ = impl_->ros_node_->create_service<ariac_msgs::srv::PerformQualityCheck>(
+            // Runs on the update thread, it reads the orders and renames faulty parts
+            impl_->quality_check_service_ = impl_->CreateQueuedService<ariac_msgs::srv::PerformQualityCheck>(
                 "/ariac/perform_quality_check",
-                std::bind(&TaskManagerPluginPrivate::PerformQualityCheck,
-                          this->impl_.get(),
-                          std::placeholders::_1,
-                          std::placeholders::_2));
+                [this](const ariac_msgs::srv::PerformQualityCheck::Request::SharedPtr _request,
+                       ariac_msgs::srv::PerformQualityCheck::Response::SharedPtr _response)
+                {
+                    impl_->PerformQualityCheck(_request, _response);
+                    return true;
+                });
 
-            impl_->pre_assembly_poses_service_ = impl_->ros_node_->create_service<ariac_msgs::srv::GetPreAssemblyPoses>(
+            // Runs on the update thread, it reads the orders and the AGVs and marks the order
+            impl_->pre_assembly_poses_service_ = impl_->CreateQueuedService<ariac_msgs::srv::GetPreAssemblyPoses>(
                 "/ariac/get_pre_assembly_poses",
-                std::bind(&TaskManagerPluginPrivate::GetPreAssemblyPoses,
-                          this->impl_.get(),
-                          std::placeholders::_1,
-                          std::placeholders::_2));
+                [this](const ariac_msgs::srv::GetPreAssemblyPoses::Request::SharedPtr _request,
+                       ariac_msgs::srv::GetPreAssemblyPoses::Response::SharedPtr _response)
+                {
+                    impl_->GetPreAssemblyPoses(_request, _response);
+                    return true;
+                });
         }
 
         // If the competition has started, do the main work
@@ -1221,32 +1314,22 @@ namespace ariac_plugins
             // Update the elapsed time
             impl_->elapsed_time_ = (current_sim_time - impl_->start_competition_time_).Double();
 
-            // Store images received by the sensor attached to each AGV
-            impl_->StoreAGVParts(1, impl_->agv_tray_images_[1]);
-            impl_->StoreAGVParts(2, impl_->agv_tray_images_[2]);
-            impl_->StoreAGVParts(3, impl_->agv_tray_images_[3]);
-            impl_->StoreAGVParts(4, impl_->agv_tray_images_[4]);
-
-            // Store images received by the sensor attached to each assembly station
-            impl_->StoreStationParts(1, impl_->assembly_station_images_[1]);
-            impl_->StoreStationParts(2, impl_->assembly_station_images_[2]);
-            impl_->StoreStationParts(3, impl_->assembly_station_images_[3]);
-            impl_->StoreStationParts(4, impl_->assembly_station_images_[4]);
+            // Parts on the AGVs and stations are indexed by the sensor callbacks
+            // when a new image arrives, which also queue the parts added to the
+            // AGVs for the part placement triggers
+            ProcessTimedEvents();
+            ProcessPartPlacementTriggers();
+            ProcessSubmissionTriggers();
 
-            ProcessEndSafeZonePenalty();
-            ProcessOrdersToAnnounce();
-            ProcessChallengesToAnnounce();
-            ProcessInProgressSensorBlackouts();
-            ProcessInProgressRobotMalfunctions();
+            // Only publishes when the health changed, so it is done every update
+            UpdateSensorsHealth();
 
             if (impl_->first_publish_)
             {
-                UpdateSensorsHealth();
                 UpdateRobotsHealth();
             }
             else if (now - impl_->last_publish_time_ >= rclcpp::Duration(0, impl_->update_ns_))
             {
-                UpdateSensorsHealth();
                 UpdateRobotsHealth();
             }
         }
@@ -1264,19 +1347,24 @@ namespace ariac_plugins
         impl_->last_on_update_time_ = current_sim_time;
     }
 
+    //==============================================================================
+    void TaskManagerPluginPrivate::RunCommands()
+    {
+        ariac_common::ScopedTimer timer(commands_timing_);
+        std::function<void()> command;
+        while (commands_.TryPop(command))
+        {
+            command();
+        }
+    }
+
     //==============================================================================
     void TaskManagerPlugin::DisableAllSensors()
     {
         RCLCPP_WARN_STREAM_ONCE(impl_->ros_node_->get_logger(), "Competition ended: All sensors are now disabled.");
-        auto sensor_message = ariac_msgs::msg::Sensors();
-        sensor_message.break_beam = false;
-        sensor_message.proximity = false;
-        sensor_message.laser_profiler = false;
-        sensor_message.lidar = false;
-        sensor_message.camera = false;
-        sensor_message.logical_camera = false;
 
-        impl_->sensor_health_pub_->publish(sensor_message);
+        if (ariac_common::SensorHealthRegistry::Instance().SetMask(0))
+            impl_->sensor_health_pub_->publish(ariac_common::SensorHealthRegistry::ToMsg(0));
     }
 
     //==============================================================================
@@ -1291,35 +1379,25 @@ namespace ariac_plugins
     }
 
     //==============================================================================
-    void TaskManagerPlugin::OnAGV1StatusCallback(const ariac_msgs::msg::AGVStatus::SharedPtr _msg)
-    {
-
-        impl_->agv1_location_ = _msg->location;
-    }
-
-    void TaskManagerPlugin::OnAGV2StatusCallback(const ariac_msgs::msg::AGVStatus::SharedPtr _msg)
-    {
-        impl_->agv2_location_ = _msg->location;
-    }
-
-    void TaskManagerPlugin::OnAGV3StatusCallback(const ariac_msgs::msg::AGVStatus::SharedPtr _msg)
-    {
-        impl_->agv3_location_ = _msg->location;
-    }
-
-    void TaskManagerPlugin::OnAGV4StatusCallback(const ariac_msgs::msg::AGVStatus::SharedPtr _msg)
+    void TaskManagerPlugin::OnAGVStatusCallback(int _agv_id, const ariac_msgs::msg::AGVStatus::SharedPtr _msg)
     {
-        impl_->agv4_location_ = _msg->location;
+        impl_->agvs_[_agv_id - 1].location = _msg->location;
+        if (impl_->capture_)
+            impl_->capture_->WriteAGVStatus(impl_->elapsed_time_, _agv_id, _msg->location);
     }
 
     //==============================================================================
     void TaskManagerPlugin::OnTrialCallback(const ariac_msgs::msg::Trial::SharedPtr _msg)
     {
-        std::lock_guard<std::mutex> scoped_lock(impl_->lock_);
         // RCLCPP_FATAL_STREAM(impl_->ros_node_->get_logger(), "------Time limit: " << _msg->time_limit);
         // RCLCPP_FATAL_STREAM(impl_->ros_node_->get_logger(), "------Trial name: " << _msg->trial_name);
         impl_->time_limit_ = _msg->time_limit;
         impl_->trial_name_ = _msg->trial_name;
+        impl_->OpenScoreLog();
+
+        // ariac_trial_replay runs the announcement triggers again from the conditions
+        if (impl_->capture_)
+            impl_->capture_->WriteTrialConfig(impl_->elapsed_time_, *_msg);
 
         // Store orders to be processed later
         std::vector<std::shared_ptr<ariac_msgs::msg::OrderCondition>>
@@ -1445,7 +1523,7 @@ namespace ariac_plugins
         {
             auto order_id = order->id;
             // Keep track of order ids
-            impl_->trial_orders_.push_back(order_id);
+            impl_->trial_orders_.insert(order_id);
 
             auto order_type = order->type;
             auto order_priority = order->priority;
@@ -1493,6 +1571,8 @@ namespace ariac_plugins
                 // Add to the list of time based orders
                 impl_->time_based_orders_.push_back(order_instance);
                 impl_->all_orders_.push_back(order_instance);
+                ScheduleTimedEvent(announcement_time, [this, order_instance]()
+                                   { AnnounceOrder(order_instance); });
             }
             else if (order->condition.type == ariac_msgs::msg::Condition::PART_PLACE)
             {
@@ -1510,6 +1590,8 @@ namespace ariac_plugins
                 // Add to the list of part placement orders
                 impl_->on_part_placement_orders_.push_back(order_instance);
                 impl_->all_orders_.push_back(order_instance);
+                AddPartPlacementTrigger(agv, part, [this, order_instance]()
+                                        { AnnounceOrder(order_instance); });
             }
             else if (order->condition.type == ariac_msgs::msg::Condition::SUBMISSION)
             {
@@ -1526,11 +1608,17 @@ namespace ariac_plugins
                 // Add to the list of submission orders
                 impl_->on_order_submission_orders_.push_back(order_instance);
                 impl_->all_orders_.push_back(order_instance);
+                AddSubmissionTrigger(submitted_order_id, [this, order_instance]()
+                                     { AnnounceOrder(order_instance); });
             }
             else
             {
                 RCLCPP_ERROR_STREAM(impl_->ros_node_->get_logger(), "Unknown condition type: " << int(order->condition.type));
             }
+
+            // Index the order for lookups by id
+            if (!impl_->all_orders_.empty() && impl_->all_orders_.back()->GetId() == order_id)
+                impl_->orders_by_id_[order_id] = impl_->all_orders_.back();
         }
     }
 
@@ -1559,6 +1647,8 @@ namespace ariac_plugins
             auto trigger_time = condition.time_condition.seconds;
             auto robot_malfunction = std::make_shared<ariac_common::RobotMalfunctionTemporal>(duration, robots_to_disable_vect, trigger_time);
             impl_->time_based_robot_malfunctions_.push_back(robot_malfunction);
+            ScheduleTimedEvent(trigger_time, [this, robot_malfunction]()
+                               { StartRobotMalfunction(robot_malfunction); });
         }
         else if (condition.type == ariac_msgs::msg::Condition::PART_PLACE)
         {
@@ -1566,12 +1656,16 @@ namespace ariac_plugins
             auto part = std::make_shared<ariac_common::Part>(condition.part_place_condition.part.color, condition.part_place_condition.part.type);
             auto robot_malfunction = std::make_shared<ariac_common::RobotMalfunctionOnPartPlacement>(duration, robots_to_disable_vect, part, agv);
             impl_->on_part_placement_robot_malfunctions_.push_back(robot_malfunction);
+            AddPartPlacementTrigger(agv, part, [this, robot_malfunction]()
+                                    { StartRobotMalfunction(robot_malfunction); });
         }
         else if (condition.type == ariac_msgs::msg::Condition::SUBMISSION)
         {
             auto submitted_order_id = condition.submission_condition.order_id;
             auto robot_malfunction = std::make_shared<ariac_common::RobotMalfunctionOnSubmission>(duration, robots_to_disable_vect, submitted_order_id);
             impl_->on_submission_robot_malfunctions_.push_back(robot_malfunction);
+            AddSubmissionTrigger(submitted_order_id, [this, robot_malfunction]()
+                                 { StartRobotMalfunction(robot_malfunction); });
         }
     }
 
@@ -1608,6 +1702,8 @@ namespace ariac_plugins
             auto trigger_time = condition.time_condition.seconds;
             auto sensor_blackout = std::make_shared<ariac_common::SensorBlackoutTemporal>(duration, sensors_to_disable_vect, trigger_time);
             impl_->time_based_sensor_blackouts_.push_back(sensor_blackout);
+            ScheduleTimedEvent(trigger_time, [this, sensor_blackout]()
+                               { StartSensorBlackout(sensor_blackout); });
         }
         else if (condition.type == ariac_msgs::msg::Condition::PART_PLACE)
         {
@@ -1615,12 +1711,16 @@ namespace ariac_plugins
             auto part = std::make_shared<ariac_common::Part>(condition.part_place_condition.part.color, condition.part_place_condition.part.type);
             auto sensor_blackout = std::make_shared<ariac_common::SensorBlackoutOnPartPlacement>(duration, sensors_to_disable_vect, part, agv);
             impl_->on_part_placement_sensor_blackouts_.push_back(sensor_blackout);
+            AddPartPlacementTrigger(agv, part, [this, sensor_blackout]()
+                                    { StartSensorBlackout(sensor_blackout); });
         }
         else if (condition.type == ariac_msgs::msg::Condition::SUBMISSION)
         {
             auto submitted_order_id = condition.submission_condition.order_id;
             auto sensor_blackout = std::make_shared<ariac_common::SensorBlackoutOnSubmission>(duration, sensors_to_disable_vect, submitted_order_id);
             impl_->on_submission_sensor_blackouts_.push_back(sensor_blackout);
+            AddSubmissionTrigger(submitted_order_id, [this, sensor_blackout]()
+                                 { StartSensorBlackout(sensor_blackout); });
         }
     }
 
@@ -1628,6 +1728,8 @@ namespace ariac_plugins
     {
         auto faulty_part_challenge = std::make_shared<ariac_common::FaultyPartChallenge>(_challenge);
         impl_->faulty_part_challenges_.push_back(faulty_part_challenge);
+        if (impl_->capture_)
+            impl_->capture_->WriteFaultyPartChallenge(impl_->elapsed_time_, _challenge);
     }
 
     void TaskManagerPlugin::StoreDroppedPartChallenges(const ariac_msgs::msg::DroppedPartChallenge &_challenge) {}
@@ -1644,6 +1746,8 @@ namespace ariac_plugins
             auto trigger_time = condition.time_condition.seconds;
             auto human_challenge = std::make_shared<ariac_common::HumanChallengeTemporal>(behavior, trigger_time);
             impl_->time_based_human_challenge_ = human_challenge;
+            ScheduleTimedEvent(trigger_time, [this, human_challenge]()
+                               { StartHumanChallenge(human_challenge); });
         }
         else if (condition.type == ariac_msgs::msg::Condition::PART_PLACE)
         {
@@ -1651,12 +1755,16 @@ namespace ariac_plugins
             auto part = std::make_shared<ariac_common::Part>(condition.part_place_condition.part.color, condition.part_place_condition.part.type);
             auto human_challenge = std::make_shared<ariac_common::HumanChallengeOnPartPlacement>(behavior, part, agv);
             impl_->on_part_placement_human_challenge_ = human_challenge;
+            AddPartPlacementTrigger(agv, part, [this, human_challenge]()
+                                    { StartHumanChallenge(human_challenge); });
         }
         else if (condition.type == ariac_msgs::msg::Condition::SUBMISSION)
         {
             auto submitted_order_id = condition.submission_condition.order_id;
             auto human_challenge = std::make_shared<ariac_common::HumanChallengeOnSubmission>(behavior, submitted_order_id);
             impl_->on_order_submission_human_challenge_ = human_challenge;
+            AddSubmissionTrigger(submitted_order_id, [this, human_challenge]()
+                                 { StartHumanChallenge(human_challenge); });
         }
     }
 
@@ -1688,15 +1796,26 @@ namespace ariac_plugins
     //==============================================================================
     void TaskManagerPlugin::UpdateSensorsHealth()
     {
-        auto sensor_message = ariac_msgs::msg::Sensors();
-        sensor_message.break_beam = impl_->break_beam_sensor_health_;
-        sensor_message.proximity = impl_->proximity_sensor_health_;
-        sensor_message.laser_profiler = impl_->laser_profiler_sensor_health_;
-        sensor_message.lidar = impl_->lidar_sensor_health_;
-        sensor_message.camera = impl_->camera_sensor_health_;
-        sensor_message.logical_camera = impl_->logical_camera_sensor_health_;
+        ariac_common::ScopedTimer timer(impl_->sensors_health_timing_);
+        using Registry = ariac_common::SensorHealthRegistry;
 
-        impl_->sensor_health_pub_->publish(sensor_message);
+        uint32_t mask = 0;
+        if (impl_->break_beam_sensor_health_)
+            mask |= Registry::BREAK_BEAM;
+        if (impl_->proximity_sensor_health_)
+            mask |= Registry::PROXIMITY;
+        if (impl_->laser_profiler_sensor_health_)
+            mask |= Registry::LASER_PROFILER;
+        if (impl_->lidar_sensor_health_)
+            mask |= Registry::LIDAR;
+        if (impl_->camera_sensor_health_)
+            mask |= Registry::CAMERA;
+        if (impl_->logical_camera_sensor_health_)
+            mask |= Registry::LOGICAL_CAMERA;
+
+        // Sensor plugins see the new mask right away, the topic is only for nodes outside the simulation
+        if (Registry::Instance().SetMask(mask))
+            impl_->sensor_health_pub_->publish(Registry::ToMsg(mask));
     }
 
     //==============================================================================
@@ -1722,827 +1841,173 @@ namespace ariac_plugins
     }
 
     //==============================================================================
-    // int TaskManagerPluginPrivate::ScoreQuadrant(ariac_msgs::msg::QualityIssue quadrant)
-    // {
-    //     int quadrant_score = 0;
-    //     bool B = !quadrant.incorrect_part_type;
-    //     bool C = !quadrant.incorrect_part_color;
-    //     bool D = quadrant.flipped_part;
-    //     bool E = quadrant.faulty_part;
-
-    //     if (!B || E)
-    //         quadrant_score = 0;
-
-    //     if (B && C && !D && !E)
-    //         quadrant_score = 3;
-
-    //     if (B && !C && !D && !E)
-    //         quadrant_score = 2;
-
-    //     if (B && C && D && !E)
-    //         quadrant_score = 2;
-
-    //     if (B && !C && D && !E)
-    //         quadrant_score = 1;
-
-    //     return quadrant_score;
-    // }
-
-    int TaskManagerPluginPrivate::ScoreQuadrant(bool is_correct_part_type, bool is_correct_part_color, bool is_flipped_part, bool is_faulty_part)
-    {
-        bool B = is_correct_part_type;
-        bool C = is_correct_part_color;
-        bool D = is_flipped_part;
-        bool E = is_faulty_part;
-
-        if (!B || E)
-            return 0;
-
-        if (B && C && !D && !E)
-            return 3;
-
-        if (B && !C && !D && !E)
-            return 2;
-
-        if (B && C && D && !E)
-            return 2;
-
-        if (B && !C && D && !E)
-            return 1;
-
-        return 0;
-    }
-
-    //==============================================================================
-    void TaskManagerPluginPrivate::ScoreKittingTask(std::shared_ptr<ariac_common::Order> _order, std::string _submitted_order_id)
+    void TaskManagerPluginPrivate::ScoreOrder(std::shared_ptr<ariac_common::Order> _order)
     {
+        auto job = std::make_shared<ScoringJob>();
+        job->order = _order;
 
-        // RCLCPP_DEBUG_STREAM(ros_node_->get_logger(), "Scoring kitting task for order: " << _submitted_order_id);
+        auto &submission = job->submission;
+        submission.order_id = _order->GetId();
+        submission.type = _order->GetType();
+        submission.submitted_time = _order->GetSubmittedTime();
+        submission.kitting_task = _order->GetKittingTask();
+        submission.assembly_task = _order->GetAssemblyTask();
+        submission.combined_task = _order->GetCombinedTask();
 
-        // These shared pointers are uniquely for KittingScore
-        std::shared_ptr<ariac_common::Quadrant> quadrant1_ptr = nullptr;
-        std::shared_ptr<ariac_common::Quadrant> quadrant2_ptr = nullptr;
-        std::shared_ptr<ariac_common::Quadrant> quadrant3_ptr = nullptr;
-        std::shared_ptr<ariac_common::Quadrant> quadrant4_ptr = nullptr;
-
-        // Bonus points for completing the order
-        int bonus = 0;
-        // Points for correct tray
-        int tray_score = 0;
-
-        int total_quadrants_score = 0;
-
-        // destination
-        int destination_score = 1;
-
-        // penalty for having extra parts
-        int penalty = 0;
-
-        // current AGV location
-        int agv_current_location = -1;
-
-        // Get the kitting task for this order
-        auto kitting_task = _order->GetKittingTask();
-        auto expected_destination = kitting_task->GetDestination();
-
-        int expected_number_of_parts = kitting_task->GetProducts().size();
-
-        // Get the AGV for this kitting task
-        auto expected_agv = kitting_task->GetAgvNumber();
-        // RCLCPP_ERROR_STREAM(ros_node_->get_logger(), "Expected AGV: " << expected_agv);
-
-        // Get AGV current location
-        if (expected_agv == 1)
-            agv_current_location = agv1_location_;
-        else if (expected_agv == 2)
-            agv_current_location = agv2_location_;
-        else if (expected_agv == 3)
-            agv_current_location = agv3_location_;
-        else if (expected_agv == 4)
-            agv_current_location = agv4_location_;
-
-        // RCLCPP_ERROR_STREAM(ros_node_->get_logger(), "Expected AGV location: " << expected_destination);
-        // RCLCPP_ERROR_STREAM(ros_node_->get_logger(), "Current AGV location: " << agv_current_location);
+        if (submission.kitting_task)
+        {
+            // Get the AGV for this kitting task
+            auto expected_agv = submission.kitting_task->GetAgvNumber();
 
-        // Get tray sensor information for this AGV
-        auto shipment = ParseAGVTraySensorImage(agv_tray_images_[expected_agv]);
+            // current AGV location
+            submission.agv_location = AGVLocation(expected_agv);
 
-        std::map<int, int> quadrant_scores;
-        quadrant_scores[1] = 0;
-        quadrant_scores[2] = 0;
-        quadrant_scores[3] = 0;
-        quadrant_scores[4] = 0;
+            // Get tray sensor information for this AGV
+            job->image = LatestTrayImage(expected_agv);
 
-        // If faulty part challenge is used in the trial
-        std::array<bool, 4> faulty_parts = {false, false, false, false};
-        if (faulty_part_challenges_.size() > 0)
-        {
+            // If faulty part challenge is used in the trial, the worker updates a copy of it
             for (auto &challenge : faulty_part_challenges_)
             {
-                if (challenge->GetOrderId() == _submitted_order_id)
-                {
-                    faulty_parts = HandleFaultyParts(challenge, *kitting_task, shipment);
-                }
+                if (challenge->GetOrderId() == submission.order_id)
+                    job->challenge = challenge;
             }
+            if (job->challenge)
+                job->challenge_copy = std::make_shared<ariac_common::FaultyPartChallenge>(*job->challenge);
         }
-
-        // Parse the kitting task and get the parts
-        for (auto product : kitting_task->GetProducts())
+        else if (submission.assembly_task)
         {
-            for (auto tray_part : shipment.GetTrayParts())
-            {
-                if (tray_part.GetQuadrant() == product.GetQuadrant())
-                {
-                    auto quadrant = product.GetQuadrant();
-                    // RCLCPP_ERROR_STREAM(ros_node_->get_logger(), "Inspecting quadrant: " << quadrant);
-                    bool is_missing_part = false;
-                    bool is_correct_part_type = tray_part.isCorrectType(product.GetPart().GetType());
-                    bool is_correct_part_color = tray_part.isCorrectColor(product.GetPart().GetColor());
-                    bool is_faulty_part = faulty_parts[quadrant - 1];
-                    bool is_flipped_part = tray_part.isFlipped();
-
-                    quadrant_scores[quadrant] = ScoreQuadrant(is_correct_part_type, is_correct_part_color, is_flipped_part, is_faulty_part);
-
-                    // RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Score: " << quadrant_scores[quadrant]);
-
-                    auto quadrant_ptr = std::make_shared<ariac_common::Quadrant>(quadrant, is_correct_part_type, is_correct_part_color, is_faulty_part, is_flipped_part, quadrant_scores[quadrant]);
-                    if (quadrant == 1)
-                        quadrant1_ptr = quadrant_ptr;
-                    else if (quadrant == 2)
-                        quadrant2_ptr = quadrant_ptr;
-                    else if (quadrant == 3)
-                        quadrant3_ptr = quadrant_ptr;
-                    else if (quadrant == 4)
-                        quadrant4_ptr = quadrant_ptr;
-                }
-            }
+            // Get insert sensor information for this station
+            job->image = LatestStationImage(submission.assembly_task->GetStation());
+        }
+        else if (submission.combined_task)
+        {
+            job->image = LatestStationImage(submission.combined_task->GetStation());
         }
 
-        // Check isCorrectTrayId
-        if (kitting_task->GetTrayId() == shipment.GetTrayId())
-            tray_score = 3;
-
-        // Sum quadrant scores
-        total_quadrants_score = quadrant_scores[1] + quadrant_scores[2] + quadrant_scores[3] + quadrant_scores[4];
-
-        std::cout << "Quadrant 1 score: " << quadrant_scores[1] << std::endl;
-        std::cout << "Quadrant 2 score: " << quadrant_scores[2] << std::endl;
-        std::cout << "Quadrant 3 score: " << quadrant_scores[3] << std::endl;
-        std::cout << "Quadrant 4 score: " << quadrant_scores[4] << std::endl;
-        std::cout << "Expected number of parts: " << expected_number_of_parts << std::endl;
-        std::cout << "Total quadrant score: " << total_quadrants_score << std::endl;
-
-        // Compute bonus
-        if (total_quadrants_score == 3 * expected_number_of_parts)
-            bonus = expected_number_of_parts;
-
-        // Compute penalty for having extra parts in the tray
-        if (shipment.GetTrayParts().size() > expected_number_of_parts)
-            penalty = shipment.GetTrayParts().size() - expected_number_of_parts;
-
-        // Check destination
-        if (agv_current_location != expected_destination)
-            destination_score = 0;
-
-        // Compute the score for the submitted kit
-        int kit_score = std::max(tray_score + total_quadrants_score + bonus - penalty, 0) * destination_score;
-
-        // Create a kitting score object
-        auto kitting_score = std::make_shared<ariac_common::KittingScore>(
-            _order->GetId(),
-            kit_score,
-            tray_score,
-            quadrant1_ptr,
-            quadrant2_ptr,
-            quadrant3_ptr,
-            quadrant4_ptr,
-            bonus,
-            penalty,
-            expected_agv,
-            destination_score);
-
-        // Set the kitting score for this order
-        _order->SetKittingScore(kitting_score);
-
-        PrintKittingScore(kitting_score);
-
-        // Display the score on the screen
-        // RCLCPP_INFO_STREAM(ros_node_->get_logger(), *kitting_score);
+        scoring_pool_->Post(
+            [this, job]()
+            {
+                RunScoringJob(*job);
+                scored_jobs_.Push(job);
+            });
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::PrintKittingScore(std::shared_ptr<ariac_common::KittingScore> kitting_score)
+    void TaskManagerPluginPrivate::RunScoringJob(ScoringJob &_job)
     {
-        std::string output = "";
-        output += "\n========================================\n";
-        output += "Order: " + kitting_score->GetOrderId() + "\n";
-        output += "Type: Kitting\n";
-        output += "AGV: " + std::to_string(kitting_score->GetAGV()) + "\n";
-        output += "Tray score: " + std::to_string(kitting_score->GetTrayScore()) + "\n";
-        kitting_score->GetDestinationScore() == 1 ? output += "Correct destination: Yes\n" : output += "Correct destination: No\n";
-        output += "Bonus: " + std::to_string(kitting_score->GetBonus()) + "\n";
-        output += "Score: " + std::to_string(kitting_score->GetScore()) + "\n";
+        ariac_common::ScopedTimer timer(scoring_job_timing_);
+        auto &submission = _job.submission;
+        auto models = ToSensedModels(*_job.image);
+        int score = 0;
 
-        auto quadrant1 = kitting_score->GetQuadrant1();
-        auto quadrant2 = kitting_score->GetQuadrant2();
-        auto quadrant3 = kitting_score->GetQuadrant3();
-        auto quadrant4 = kitting_score->GetQuadrant4();
-
-        if (quadrant1 != nullptr)
-        {
-            output += "========================================\n";
-            output += "Quadrant: 1\n";
-            output += "Quadrant score: " + std::to_string(quadrant1->GetScore()) + "\n";
-            output += "----------------------------------------\n";
-            quadrant1->GetIsCorrectPartType() ? output += "Correct part type: Yes\n" : output += "Correct part type: No\n";
-            quadrant1->GetIsCorrectPartColor() ? output += "Correct part color: Yes\n" : output += "Correct part color: No\n";
-            quadrant1->GetIsFaulty() ? output += "Faulty part: Yes\n" : output += "Faulty part: No\n";
-            quadrant1->GetIsFlipped() ? output += "Flipped part: Yes\n" : output += "Flipped part: No\n";
-        }
-        if (quadrant2 != nullptr)
+        if (submission.kitting_task)
         {
-            output += "========================================\n";
-            output += "Quadrant: 2\n";
-            output += "Quadrant score: " + std::to_string(quadrant2->GetScore()) + "\n";
-            output += "----------------------------------------\n";
-            quadrant2->GetIsCorrectPartType() ? output += "Correct part type: Yes\n" : output += "Correct part type: No\n";
-            quadrant2->GetIsCorrectPartColor() ? output += "Correct part color: Yes\n" : output += "Correct part color: No\n";
-            quadrant2->GetIsFaulty() ? output += "Faulty: Yes\n" : output += "Faulty: No\n";
-            quadrant2->GetIsFlipped() ? output += "Flipped: Yes\n" : output += "Flipped: No\n";
+            auto shipment = ariac_scoring::ParseKittingShipment(models);
+            if (_job.challenge_copy)
+                submission.faulty_parts = ariac_scoring::FindFaultyParts(
+                    *_job.challenge_copy, *submission.kitting_task, shipment, _job.newly_faulty);
+            submission.kitting_shipment = std::make_shared<ariac_common::KittingShipment>(shipment);
+
+            _job.kitting_score = ariac_scoring::ScoreKittingTask(
+                submission.order_id, *submission.kitting_task, shipment, submission.agv_location, submission.faulty_parts);
+            score = _job.kitting_score->GetScore();
+            PrintKittingScore(_job.kitting_score, submission.submitted_time);
         }
-        if (quadrant3 != nullptr)
+        else if (submission.assembly_task)
         {
-            output += "========================================\n";
-            output += "Quadrant: 3\n";
-            output += "Quadrant score: " + std::to_string(quadrant3->GetScore()) + "\n";
-            output += "----------------------------------------\n";
-            quadrant3->GetIsCorrectPartType() ? output += "Correct part type: Yes\n" : output += "Correct part type: No\n";
-            quadrant3->GetIsCorrectPartColor() ? output += "Correct part color: Yes\n" : output += "Correct part color: No\n";
-            quadrant3->GetIsFaulty() ? output += "Faulty: Yes\n" : output += "Faulty: No\n";
-            quadrant3->GetIsFlipped() ? output += "Flipped: Yes\n" : output += "Flipped: No\n";
+            auto shipment = ariac_scoring::ParseAssemblyShipment(models);
+            submission.assembly_shipment = std::make_shared<ariac_common::AssemblyShipment>(shipment);
+
+            _job.assembly_score = ariac_scoring::ScoreAssemblyTask(submission.order_id, *submission.assembly_task, shipment);
+            score = _job.assembly_score->GetScore();
+            PrintAssemblyScore(_job.assembly_score, submission.submitted_time);
         }
-        if (quadrant4 != nullptr)
+        else if (submission.combined_task)
         {
-            output += "========================================\n";
-            output += "Quadrant: 4\n";
-            output += "Quadrant score: " + std::to_string(quadrant4->GetScore()) + "\n";
-            output += "----------------------------------------\n";
-            quadrant4->GetIsCorrectPartType() ? output += "Correct part type: Yes\n" : output += "Correct part type: No\n";
-            quadrant4->GetIsCorrectPartColor() ? output += "Correct part color: Yes\n" : output += "Correct part color: No\n";
-            quadrant4->GetIsFaulty() ? output += "Faulty: Yes\n" : output += "Faulty: No\n";
-            quadrant4->GetIsFlipped() ? output += "Flipped: Yes\n" : output += "Flipped: No\n";
+            auto shipment = ariac_scoring::ParseAssemblyShipment(models);
+            submission.assembly_shipment = std::make_shared<ariac_common::AssemblyShipment>(shipment);
+
+            _job.combined_score = ariac_scoring::ScoreCombinedTask(submission.order_id, *submission.combined_task, shipment);
+            score = _job.combined_score->GetScore();
+            PrintCombinedScore(_job.combined_score, submission.submitted_time);
         }
 
-        RCLCPP_INFO_STREAM(ros_node_->get_logger(), output);
-        log_message_ += output;
+        if (capture_)
+            capture_->WriteOrderScored(submission.submitted_time, submission.order_id, score);
+
+        ariac_msgs::msg::OrderScore score_msg;
+        score_msg.order_id = submission.order_id;
+        score_msg.type = submission.type;
+        score_msg.submitted_time = submission.submitted_time;
+        score_msg.score = score;
+        order_score_pub_->publish(score_msg);
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::ScoreAssemblyTask(std::shared_ptr<ariac_common::Order> _order, std::string _submitted_order_id)
+    void TaskManagerPluginPrivate::ApplyScores()
     {
-        // These shared pointers are uniquely for KittingScore
-        std::shared_ptr<ariac_common::ScoredAssemblyPart> battery_ptr = nullptr;
-        std::shared_ptr<ariac_common::ScoredAssemblyPart> pump_ptr = nullptr;
-        std::shared_ptr<ariac_common::ScoredAssemblyPart> regulator_ptr = nullptr;
-        std::shared_ptr<ariac_common::ScoredAssemblyPart> sensor_ptr = nullptr;
-
-        // 2 cm tolerance for the translation
-        double translation_target{0.02};
-        // 15 deg tolerance for the rotation
-        double rotation_target{0.261799};
-
-        // Bonus points for completing the order
-        int bonus = 0;
-
-        int parts_score = 0;
-
-        // score for correct station
-        int station_score = 0;
-
-        // Get the assembly task for this order
-        auto assembly_task = _order->GetAssemblyTask();
-        auto expected_station = assembly_task->GetStation();
-
-        int expected_number_of_parts = assembly_task->GetProducts().size();
-
-        // Get insert sensor information for this station
-        auto shipment = ParseAssemblyStationImage(assembly_station_images_[expected_station]);
-
-        // Parse the assembly task and get the parts
-        for (auto order_product : assembly_task->GetProducts())
+        ariac_common::ScopedTimer timer(apply_scores_timing_);
+        std::shared_ptr<ScoringJob> job;
+        while (scored_jobs_.TryPop(job))
         {
-            // Parse the shipment and get the parts
-            for (auto shipment_product : shipment.GetInsertParts())
+            // Rename parts in gazebo so they are reported as faulty from now on
+            for (const auto &faulty : job->newly_faulty)
             {
-                auto shipment_part = shipment_product.GetPart();
-                auto shipment_part_pose = shipment_product.GetPoseInInsert();
-                auto order_part_pose = order_product.GetPartPose();
-
-                bool is_correct_pose = true;
-                bool is_correct_part_type = shipment_product.isCorrectType(order_product.GetPart().GetType());
-                bool is_correct_part_color = shipment_product.isCorrectColor(order_product.GetPart().GetColor());
-
-                if (is_correct_part_type)
-                {
-                    int part_score = 0;
-
-                    // compute translation distance
-                    ignition::math::Vector3d position_diff(
-                        order_part_pose.X() - shipment_part_pose.position.x,
-                        order_part_pose.Y() - shipment_part_pose.position.y,
-                        order_part_pose.Z() - shipment_part_pose.position.z);
-
-                    const double translation_distance = position_diff.Length();
-                    if (translation_distance > translation_target)
-                    {
-                        is_correct_pose = false;
-                    }
-
-                    // compute orientation distance
-                    // quaternion for the part in the order
-                    ignition::math::Quaterniond order_part_q(
-                        order_part_pose.Rot().W(),
-                        order_part_pose.Rot().X(),
-                        order_part_pose.Rot().Y(),
-                        order_part_pose.Rot().Z());
-
-                    // quaternion for the part in the shipment
-                    ignition::math::Quaterniond shipment_part_q(
-                        shipment_part_pose.orientation.w,
-                        shipment_part_pose.orientation.x,
-                        shipment_part_pose.orientation.y,
-                        shipment_part_pose.orientation.z);
-
-                    // Filter products that aren't in the appropriate orientation (loosely).
-                    // If the quaternions represent the same orientation, q1 = +-q2 => q1.dot(q2) = +-1
-                    const double orientation_diff = shipment_part_q.Dot(order_part_q);
-                    const double orientation_threshold = 0.05;
-
-                    if (std::abs(orientation_diff) < (1.0 - orientation_threshold))
-                    {
-                        is_correct_pose = false;
-                    }
-
-                    // Compute the score for this part
-                    if (is_correct_part_type && is_correct_part_color && is_correct_pose)
-                    {
-                        part_score = 3;
-                    }
-                    else if (is_correct_part_type && (is_correct_part_color || is_correct_pose))
-                    {
-                        part_score = 2;
-                    }
-                    else if (is_correct_part_type && (!is_correct_part_color && !is_correct_pose))
-                    {
-                        part_score = 1;
-                    }
-                    else
-                    {
-                        part_score = 0;
-                    }
-
-                    // Part orientation in RPY
-                    tf2::Quaternion q(
-                        shipment_part_pose.orientation.x,
-                        shipment_part_pose.orientation.y,
-                        shipment_part_pose.orientation.z,
-                        shipment_part_pose.orientation.w);
-
-                    tf2::Matrix3x3 m(q);
-                    double roll, pitch, yaw;
-                    m.getRPY(roll, pitch, yaw);
-
-                    geometry_msgs::msg::Vector3 part_position;
-                    part_position.x = shipment_part_pose.position.x;
-                    part_position.y = shipment_part_pose.position.y;
-                    part_position.z = shipment_part_pose.position.z;
-
-                    geometry_msgs::msg::Vector3 part_orientation;
-                    part_orientation.x = roll;
-                    part_orientation.y = pitch;
-                    part_orientation.z = yaw;
-
-                    if (order_product.GetPart().GetType() == ariac_msgs::msg::Part::BATTERY)
-                    {
-                        bool faulty_part = false;
-                        battery_ptr = std::make_shared<ariac_common::ScoredAssemblyPart>(
-                            shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, faulty_part);
-                    }
-                    else if (order_product.GetPart().GetType() == ariac_msgs::msg::Part::PUMP)
-                    {
-                        bool faulty_part = false;
-                        pump_ptr = std::make_shared<ariac_common::ScoredAssemblyPart>(shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, faulty_part);
-                    }
-                    else if (order_product.GetPart().GetType() == ariac_msgs::msg::Part::REGULATOR)
-                    {
-                        bool faulty_part = false;
-                        regulator_ptr = std::make_shared<ariac_common::ScoredAssemblyPart>(shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, faulty_part);
-                    }
-                    else if (order_product.GetPart().GetType() == ariac_msgs::msg::Part::SENSOR)
-                    {
-                        bool faulty_part = false;
-                        sensor_ptr = std::make_shared<ariac_common::ScoredAssemblyPart>(shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, faulty_part);
-                    }
+                job->challenge->SetQuadrantChecked(faulty.first);
 
-                    parts_score += part_score;
-                }
+                auto model = world_->ModelByName(faulty.second);
+                if (model)
+                    model->SetName(faulty.second + "_faulty");
+                RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Part in quadrant " << std::to_string(faulty.first) << " is faulty");
             }
-        }
-        // Check isCorrectStation
-        if (assembly_task->GetStation() == shipment.GetStation())
-            station_score = 1;
-
-        // Compute bonus points
-        if (parts_score == expected_number_of_parts * 3)
-            bonus = expected_number_of_parts * 4;
-
-        // Compute the score for the submitted shipment
-        int insert_score = (parts_score + bonus) * station_score;
-
-        // Create a shared pointer to an AssemblyScore object
-        auto assembly_score = std::make_shared<ariac_common::AssemblyScore>(
-            _order->GetId(),
-            insert_score,
-            shipment.GetStation(),
-            battery_ptr,
-            pump_ptr,
-            regulator_ptr,
-            sensor_ptr,
-            bonus);
-
-        // Set the score for this assembly task
-        _order->SetAssemblyScore(assembly_score);
-
-        // Display the score in the terminal
-        PrintAssemblyScore(assembly_score);
-    }
-
-    //==============================================================================
-    void TaskManagerPluginPrivate::PrintAssemblyScore(std::shared_ptr<ariac_common::AssemblyScore> assembly_score)
-    {
-        std::string output = "";
-        output += "\n========================================\n";
-        output += "Order: " + assembly_score->GetOrderId() + "\n";
-        output += "Type: Assembly\n";
-        output += "Station: " + std::to_string(assembly_score->GetStation()) + "\n";
-        output += "Bonus: " + std::to_string(assembly_score->GetBonus()) + "\n";
-        output += "Score: " + std::to_string(assembly_score->GetScore()) + "\n";
-
-        auto battery = assembly_score->GetBatteryPtr();
-        auto pump = assembly_score->GetPumpPtr();
-        auto regulator = assembly_score->GetRegulatorPtr();
-        auto sensor = assembly_score->GetSensorPtr();
-        if (battery != nullptr)
-        {
-            auto battery_type = ariac_common::ConvertPartTypeToString(battery->GetPart().GetType());
-            auto battery_color = ariac_common::ConvertPartColorToString(battery->GetPart().GetColor());
-            output += "========================================\n";
-            output += "Part: [" + battery_type + "," + battery_color + "]\n";
-            output += "----------------------------------------\n";
-            output += "Type: Correct\n";
-            battery->GetCorrectColor() ? output += "Color: Correct\n" : output += "Color: Incorrect\n";
-            battery->GetCorrectPose() ? output += "Pose: Correct\n" : output += "Pose: Incorrect\n";
-            output += "Position: " + std::to_string(battery->GetPosition().x) + ", " + std::to_string(battery->GetPosition().y) + ", " + std::to_string(battery->GetPosition().z) + "\n";
-            output += "Orientation: " + std::to_string(battery->GetOrientation().x) + ", " + std::to_string(battery->GetOrientation().y) + ", " + std::to_string(battery->GetOrientation().z) + "\n";
-            output += "Part score: " + std::to_string(battery->GetScore()) + "\n";
-        }
-        if (pump != nullptr)
-        {
-            auto pump_type = ariac_common::ConvertPartTypeToString(pump->GetPart().GetType());
-            auto pump_color = ariac_common::ConvertPartColorToString(pump->GetPart().GetColor());
-            output += "========================================\n";
-            output += "Part: [" + pump_type + "," + pump_color + "]\n";
-            output += "----------------------------------------\n";
-            output += "Type: Correct\n";
-            pump->GetCorrectColor() ? output += "Color: Correct\n" : output += "Color: Incorrect\n";
-            pump->GetCorrectPose() ? output += "Pose: Correct\n" : output += "Pose: Incorrect\n";
-            output += "Position: " + std::to_string(pump->GetPosition().x) + ", " + std::to_string(pump->GetPosition().y) + ", " + std::to_string(pump->GetPosition().z) + "\n";
-            output += "Orientation: " + std::to_string(pump->GetOrientation().x) + ", " + std::to_string(pump->GetOrientation().y) + ", " + std::to_string(pump->GetOrientation().z) + "\n";
-            output += "Part score: " + std::to_string(pump->GetScore()) + "\n";
-        }
-        if (regulator != nullptr)
-        {
-            auto regulator_type = ariac_common::ConvertPartTypeToString(regulator->GetPart().GetType());
-            auto regulator_color = ariac_common::ConvertPartColorToString(regulator->GetPart().GetColor());
-            output += "========================================\n";
-            output += "Part: [" + regulator_type + "," + regulator_color + "]\n";
-            output += "----------------------------------------\n";
-            output += "Type: Correct\n";
-            regulator->GetCorrectColor() ? output += "Color: Correct\n" : output += "Color: Incorrect\n";
-            regulator->GetCorrectPose() ? output += "Pose: Correct\n" : output += "Pose: Incorrect\n";
-            output += "Position: " + std::to_string(regulator->GetPosition().x) + ", " + std::to_string(regulator->GetPosition().y) + ", " + std::to_string(regulator->GetPosition().z) + "\n";
-            output += "Orientation: " + std::to_string(regulator->GetOrientation().x) + ", " + std::to_string(regulator->GetOrientation().y) + ", " + std::to_string(regulator->GetOrientation().z) + "\n";
-            output += "Part score: " + std::to_string(regulator->GetScore()) + "\n";
-        }
-        if (sensor != nullptr)
-        {
-            auto sensor_type = ariac_common::ConvertPartTypeToString(sensor->GetPart().GetType());
-            auto sensor_color = ariac_common::ConvertPartColorToString(sensor->GetPart().GetColor());
-            output += "========================================\n";
-            output += "Part: [" + sensor_type + "," + sensor_color + "]\n";
-            output += "----------------------------------------\n";
-            output += "Type: Correct\n";
-            sensor->GetCorrectColor() ? output += "Color: Correct\n" : output += "Color: Incorrect\n";
-            sensor->GetCorrectPose() ? output += "Pose: Correct\n" : output += "Pose: Incorrect\n";
-            output += "Position: " + std::to_string(sensor->GetPosition().x) + ", " + std::to_string(sensor->GetPosition().y) + ", " + std::to_string(sensor->GetPosition().z) + "\n";
-            output += "Orientation: " + std::to_string(sensor->GetOrientation().x) + ", " + std::to_string(sensor->GetOrientation().y) + ", " + std::to_string(sensor->GetOrientation().z) + "\n";
-            output += "Part score: " + std::to_string(sensor->GetScore()) + "\n";
-            output += "----------------------------------------\n";
-        }
-
-        RCLCPP_INFO_STREAM(ros_node_->get_logger(), output);
-        log_message_ += output;
-    }
-
-    //==============================================================================
-    void TaskManagerPluginPrivate::PrintCombinedScore(std::shared_ptr<ariac_common::CombinedScore> combined_score)
-    {
-        std::string output = "";
-        output += "\n========================================\n";
-        output += "Order: " + combined_score->GetOrderId() + "\n";
-        output += "Type: Combined\n";
-        output += "Station: " + std::to_string(combined_score->GetStation()) + "\n";
-        output += "Bonus: " + std::to_string(combined_score->GetBonus()) + "\n";
-        output += "Score: " + std::to_string(combined_score->GetScore()) + "\n";
-
-        auto battery = combined_score->GetBatteryPtr();
-        auto pump = combined_score->GetPumpPtr();
-        auto regulator = combined_score->GetRegulatorPtr();
-        auto sensor = combined_score->GetSensorPtr();
-        if (battery != nullptr)
-        {
-            auto battery_type = ariac_common::ConvertPartTypeToString(battery->GetPart().GetType());
-            auto battery_color = ariac_common::ConvertPartColorToString(battery->GetPart().GetColor());
-            output += "========================================\n";
-            output += "Part: [" + battery_type + "," + battery_color + "]\n";
-            output += "----------------------------------------\n";
-            output += "Type: Correct\n";
-            battery->GetCorrectColor() ? output += "Color: Correct\n" : output += "Color: Incorrect\n";
-            battery->GetCorrectPose() ? output += "Pose: Correct\n" : output += "Pose: Incorrect\n";
-            battery->GetIsFaulty() ? output += "Faulty: Yes\n" : output += "Faulty: No\n";
-            output += "Position: " + std::to_string(battery->GetPosition().x) + ", " + std::to_string(battery->GetPosition().y) + ", " + std::to_string(battery->GetPosition().z) + "\n";
-            output += "Orientation: " + std::to_string(battery->GetOrientation().x) + ", " + std::to_string(battery->GetOrientation().y) + ", " + std::to_string(battery->GetOrientation().z) + "\n";
-            output += "Part score: " + std::to_string(battery->GetScore()) + "\n";
-        }
-        if (pump != nullptr)
-        {
-            auto pump_type = ariac_common::ConvertPartTypeToString(pump->GetPart().GetType());
-            auto pump_color = ariac_common::ConvertPartColorToString(pump->GetPart().GetColor());
-            output += "========================================\n";
-            output += "Part: [" + pump_type + "," + pump_color + "]\n";
-            output += "----------------------------------------\n";
-            output += "Type: Correct\n";
-            pump->GetCorrectColor() ? output += "Color: Correct\n" : output += "Color: Incorrect\n";
-            pump->GetCorrectPose() ? output += "Pose: Correct\n" : output += "Pose: Incorrect\n";
-            pump->GetIsFaulty() ? output += "Faulty: Yes\n" : output += "Faulty: No\n";
-            output += "Position: " + std::to_string(pump->GetPosition().x) + ", " + std::to_string(pump->GetPosition().y) + ", " + std::to_string(pump->GetPosition().z) + "\n";
-            output += "Orientation: " + std::to_string(pump->GetOrientation().x) + ", " + std::to_string(pump->GetOrientation().y) + ", " + std::to_string(pump->GetOrientation().z) + "\n";
-            output += "Part score: " + std::to_string(pump->GetScore()) + "\n";
-        }
-        if (regulator != nullptr)
-        {
-            auto regulator_type = ariac_common::ConvertPartTypeToString(regulator->GetPart().GetType());
-            auto regulator_color = ariac_common::ConvertPartColorToString(regulator->GetPart().GetColor());
-            output += "========================================\n";
-            output += "Part: [" + regulator_type + "," + regulator_color + "]\n";
-            output += "----------------------------------------\n";
-            output += "Type: Correct\n";
-            regulator->GetCorrectColor() ? output += "Color: Correct\n" : output += "Color: Incorrect\n";
-            regulator->GetCorrectPose() ? output += "Pose: Correct\n" : output += "Pose: Incorrect\n";
-            regulator->GetIsFaulty() ? output += "Faulty: Yes\n" : output += "Faulty: No\n";
-            output += "Position: " + std::to_string(regulator->GetPosition().x) + ", " + std::to_string(regulator->GetPosition().y) + ", " + std::to_string(regulator->GetPosition().z) + "\n";
-            output += "Orientation: " + std::to_string(regulator->GetOrientation().x) + ", " + std::to_string(regulator->GetOrientation().y) + ", " + std::to_string(regulator->GetOrientation().z) + "\n";
-            output += "Part score: " + std::to_string(regulator->GetScore()) + "\n";
-        }
-        if (sensor != nullptr)
-        {
-            auto sensor_type = ariac_common::ConvertPartTypeToString(sensor->GetPart().GetType());
-            auto sensor_color = ariac_common::ConvertPartColorToString(sensor->GetPart().GetColor());
-            output += "========================================\n";
-            output += "Part: [" + sensor_type + "," + sensor_color + "]\n";
-            output += "----------------------------------------\n";
-            output += "Type: Correct\n";
-            sensor->GetCorrectColor() ? output += "Color: Correct\n" : output += "Color: Incorrect\n";
-            sensor->GetCorrectPose() ? output += "Pose: Correct\n" : output += "Pose: Incorrect\n";
-            sensor->GetIsFaulty() ? output += "Faulty: Yes\n" : output += "Faulty: No\n";
-            output += "Position: " + std::to_string(sensor->GetPosition().x) + ", " + std::to_string(sensor->GetPosition().y) + ", " + std::to_string(sensor->GetPosition().z) + "\n";
-            output += "Orientation: " + std::to_string(sensor->GetOrientation().x) + ", " + std::to_string(sensor->GetOrientation().y) + ", " + std::to_string(sensor->GetOrientation().z) + "\n";
-            output += "Part score: " + std::to_string(sensor->GetScore()) + "\n";
-            output += "----------------------------------------\n";
-        }
-
-        RCLCPP_INFO_STREAM(ros_node_->get_logger(), output);
-        log_message_ += output;
-    }
-
-    //==============================================================================
-    void TaskManagerPluginPrivate::ScoreCombinedTask(std::shared_ptr<ariac_common::Order> _order, std::string _submitted_order_id)
-    {
-        // These shared pointers are uniquely for CombinedTask
-        std::shared_ptr<ariac_common::ScoredAssemblyPart> battery_ptr = nullptr;
-        std::shared_ptr<ariac_common::ScoredAssemblyPart> pump_ptr = nullptr;
-        std::shared_ptr<ariac_common::ScoredAssemblyPart> regulator_ptr = nullptr;
-        std::shared_ptr<ariac_common::ScoredAssemblyPart> sensor_ptr = nullptr;
-
-        // 2 cm tolerance for the translation
-        double translation_target{0.02};
-        // 15 deg tolerance for the rotation
-        double rotation_target{0.261799};
-
-        // Bonus points for completing the order
-        int bonus = 0;
-
-        int parts_score = 0;
-
-        // score for correct station
-        int station_score = 0;
-
-        // Get the assembly task for this order
-        auto combined_task = _order->GetCombinedTask();
-        auto expected_station = combined_task->GetStation();
-
-        int expected_number_of_parts = combined_task->GetProducts().size();
-
-        // Get insert sensor information for this station
-        auto shipment = ParseAssemblyStationImage(assembly_station_images_[expected_station]);
-
-        // If faulty part challenge is used in the trial
-        // std::array<bool, 4> faulty_parts = {false, false, false, false};
-        // if (faulty_part_challenges_.size() > 0)
-        // {
-        //     for (auto &challenge : faulty_part_challenges_)
-        //     {
-        //         if (challenge->GetOrderId() == _submitted_order_id)
-        //         {
-        //             faulty_parts = HandleFaultyParts(challenge, *kitting_task, shipment);
-        //         }
-        //     }
-        // }
-
-        // Parse the assembly task and get the parts
-        for (auto order_product : combined_task->GetProducts())
-        {
-            // Parse the shipment and get the parts
-            for (auto shipment_product : shipment.GetInsertParts())
-            {
 
-                auto shipment_part = shipment_product.GetPart();
-                auto shipment_part_pose = shipment_product.GetPoseInInsert();
-                auto order_part_pose = order_product.GetPartPose();
+            if (job->kitting_score)
+                job->order->SetKittingScore(job->kitting_score);
+            else if (job->assembly_score)
+                job->order->SetAssemblyScore(job->assembly_score);
+            else if (job->combined_score)
+                job->order->SetCombinedScore(job->combined_score);
 
-                bool is_correct_pose = true;
-                bool is_correct_part_type = shipment_product.isCorrectType(order_product.GetPart().GetType());
-                bool is_correct_part_color = shipment_product.isCorrectColor(order_product.GetPart().GetColor());
-
-                if (is_correct_part_type)
-                {
-                    int part_score = 0;
-                    // needs to be computed and not hard coded
-                    bool is_faulty = false;
-
-                    // compute translation distance
-                    ignition::math::Vector3d position_diff(
-                        order_part_pose.X() - shipment_part_pose.position.x,
-                        order_part_pose.Y() - shipment_part_pose.position.y,
-                        order_part_pose.Z() - shipment_part_pose.position.z);
-
-                    const double translation_distance = position_diff.Length();
-                    if (translation_distance > translation_target)
-                    {
-                        is_correct_pose = false;
-                    }
-
-                    // compute orientation distance
-                    // quaternion for the part in the order
-                    ignition::math::Quaterniond order_part_q(
-                        order_part_pose.Rot().W(),
-                        order_part_pose.Rot().X(),
-                        order_part_pose.Rot().Y(),
-                        order_part_pose.Rot().Z());
-
-                    // quaternion for the part in the shipment
-                    ignition::math::Quaterniond shipment_part_q(
-                        shipment_part_pose.orientation.w,
-                        shipment_part_pose.orientation.x,
-                        shipment_part_pose.orientation.y,
-                        shipment_part_pose.orientation.z);
-
-                    // Filter products that aren't in the appropriate orientation (loosely).
-                    // If the quaternions represent the same orientation, q1 = +-q2 => q1.dot(q2) = +-1
-                    const double orientation_diff = shipment_part_q.Dot(order_part_q);
-                    const double orientation_threshold = 0.05;
-
-                    if (std::abs(orientation_diff) < (1.0 - orientation_threshold))
-                    {
-                        is_correct_pose = false;
-                    }
-
-                    // Compute the score for this part
-                    if (!is_correct_part_type || is_faulty)
-                    {
-                        part_score = 0;
-                    }
-                    else if (is_correct_part_type && is_correct_part_color && is_correct_pose)
-                    {
-                        part_score = 5;
-                    }
-                    else if (is_correct_part_type && (is_correct_part_color || is_correct_pose))
-                    {
-                        part_score = 4;
-                    }
-                    else if (is_correct_part_type && (!is_correct_part_color && !is_correct_pose))
-                    {
-                        part_score = 3;
-                    }
-                    else
-                    {
-                        part_score = 0;
-                    }
-
-                    // Convert the position and orientation to RPY for display in the terminal
-                    tf2::Quaternion q(
-                        shipment_part_pose.orientation.x,
-                        shipment_part_pose.orientation.y,
-                        shipment_part_pose.orientation.z,
-                        shipment_part_pose.orientation.w);
-
-                    tf2::Matrix3x3 m(q);
-                    double roll, pitch, yaw;
-                    m.getRPY(roll, pitch, yaw);
-
-                    geometry_msgs::msg::Vector3 part_position;
-                    part_position.x = shipment_part_pose.position.x;
-                    part_position.y = shipment_part_pose.position.y;
-                    part_position.z = shipment_part_pose.position.z;
-
-                    geometry_msgs::msg::Vector3 part_orientation;
-                    part_orientation.x = roll;
-                    part_orientation.y = pitch;
-                    part_orientation.z = yaw;
-
-                    if (order_product.GetPart().GetType() == ariac_msgs::msg::Part::BATTERY)
-                    {
-                        battery_ptr = std::make_shared<ariac_common::ScoredAssemblyPart>(
-                            shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, is_faulty);
-                    }
-                    else if (order_product.GetPart().GetType() == ariac_msgs::msg::Part::PUMP)
-                    {
-                        pump_ptr = std::make_shared<ariac_common::ScoredAssemblyPart>(shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, is_faulty);
-                    }
-                    else if (order_product.GetPart().GetType() == ariac_msgs::msg::Part::REGULATOR)
-                    {
-                        regulator_ptr = std::make_shared<ariac_common::ScoredAssemblyPart>(shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, is_faulty);
-                    }
-                    else if (order_product.GetPart().GetType() == ariac_msgs::msg::Part::SENSOR)
-                    {
-                        sensor_ptr = std::make_shared<ariac_common::ScoredAssemblyPart>(shipment_part, is_correct_part_color, is_correct_pose, part_position, part_orientation, part_score, is_faulty);
-                    }
-
-                    parts_score += part_score;
-                }
-            }
+            // Record what the order was scored against so the trial can be rescored offline
+            submissions_.push_back(job->submission);
         }
-        // Check isCorrectStation
-        if (combined_task->GetStation() == shipment.GetStation())
-            station_score = 1;
-
-        // Compute bonus points
-        if (parts_score == expected_number_of_parts * 5)
-            bonus = expected_number_of_parts * 4;
+    }
 
-        // Compute the score for the submitted shipment
-        int insert_score = (parts_score + bonus) * station_score;
+    //==============================================================================
+    void TaskManagerPluginPrivate::PrintKittingScore(std::shared_ptr<ariac_common::KittingScore> kitting_score, double _time)
+    {
+        auto record = ariac_scoring::KittingScoreRecord(*kitting_score);
+        record.Add("time", "", _time);
 
-        // Create a combined score object
-        auto combined_score = std::make_shared<ariac_common::CombinedScore>(
-            _order->GetId(),
-            insert_score,
-            shipment.GetStation(),
-            battery_ptr,
-            pump_ptr,
-            regulator_ptr,
-            sensor_ptr,
-            bonus);
+        RCLCPP_INFO_STREAM(ros_node_->get_logger(), record.ToText());
+        score_log_.Write(std::move(record));
+    }
 
-        // Set the score for this combined task
-        _order->SetCombinedScore(combined_score);
+    //==============================================================================
+    void TaskManagerPluginPrivate::PrintAssemblyScore(std::shared_ptr<ariac_common::AssemblyScore> assembly_score, double _time)
+    {
+        auto record = ariac_scoring::AssemblyScoreRecord(*assembly_score);
+        record.Add("time", "", _time);
 
-        // Display the score in the terminal
-        PrintCombinedScore(combined_score);
+        RCLCPP_INFO_STREAM(ros_node_->get_logger(), record.ToText());
+        score_log_.Write(std::move(record));
     }
 
-    // ==================================== //
-    // Services
-    // ==================================== //
+    //==============================================================================
+    void TaskManagerPluginPrivate::PrintCombinedScore(std::shared_ptr<ariac_common::CombinedScore> combined_score, double _time)
+    {
+        auto record = ariac_scoring::CombinedScoreRecord(*combined_score);
+        record.Add("time", "", _time);
+
+        RCLCPP_INFO_STREAM(ros_node_->get_logger(), record.ToText());
+        score_log_.Write(std::move(record));
+    }
 
     //==============================================================================
     bool TaskManagerPlugin::SubmitOrderServiceCallback(
         const std::shared_ptr<ariac_msgs::srv::SubmitOrder::Request> request,
         std::shared_ptr<ariac_msgs::srv::SubmitOrder::Response> response)
     {
-
-        std::lock_guard<std::mutex> lock(impl_->lock_);
-
         if (this->impl_->current_state_ == ariac_msgs::msg::CompetitionState::ENDED)
         {
             RCLCPP_WARN(impl_->ros_node_->get_logger(), "Competition has ended. No more orders can be submitted.");
@@ -2553,37 +2018,28 @@ namespace ariac_plugins
 
         auto submitted_order_id = request->order_id;
 
+        if (impl_->capture_)
+            impl_->capture_->WriteSubmitOrder(impl_->elapsed_time_, submitted_order_id);
+
         // If the order id is part of the trial orders, then it is submitted
-        if (std::find(impl_->trial_orders_.begin(), impl_->trial_orders_.end(), submitted_order_id) != impl_->trial_orders_.end())
+        if (impl_->trial_orders_.count(submitted_order_id) > 0)
         {
             // We need to set the submission time to compute the overall score against other competitors
-            for (auto &order : impl_->all_orders_)
+            auto order = impl_->FindOrder(submitted_order_id);
+            if (order)
             {
-                if (order->GetId() == submitted_order_id)
-                {
-                    order->SetIsSubmitted();
-                    order->SetSubmittedTime(impl_->elapsed_time_);
-                    // Score the kitting task
-                    if (order->GetKittingTask())
-                    {
-                        impl_->ScoreKittingTask(order, request->order_id);
-                    }
-                    else if (order->GetAssemblyTask())
-                    {
-                        impl_->ScoreAssemblyTask(order, request->order_id);
-                    }
-                    else if (order->GetCombinedTask())
-                    {
-                        impl_->ScoreCombinedTask(order, request->order_id);
-                    }
-                }
-
-                // Push the order id to the list of submitted orders
-                impl_->submitted_orders_.push_back(submitted_order_id);
-                response->success = true;
-                response->message = "Order submitted successfully";
-                impl_->trial_orders_.erase(std::remove(impl_->trial_orders_.begin(), impl_->trial_orders_.end(), submitted_order_id), impl_->trial_orders_.end());
+                order->SetIsSubmitted();
+                order->SetSubmittedTime(impl_->elapsed_time_);
+                // Scored by the workers, the score is set in a later update
+                impl_->ScoreOrder(order);
             }
+
+            // Move the order id to the set of submitted orders, submission triggers fire in OnUpdate
+            impl_->submitted_orders_.insert(submitted_order_id);
+            QueueSubmissionTriggers(submitted_order_id);
+            impl_->trial_orders_.erase(submitted_order_id);
+            response->success = true;
+            response->message = "Order submitted successfully";
         }
         else
         {
@@ -2598,8 +2054,6 @@ namespace ariac_plugins
         const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
         std::shared_ptr<std_srvs::srv::Trigger::Response> response)
     {
-        std::lock_guard<std::mutex> lock(impl_->lock_);
-
         // gzdbg << "\n";
         // gzdbg << "StartCompetitionServiceCallback\n";
 
@@ -2625,36 +2079,31 @@ namespace ariac_plugins
     //==============================================================================
     void TaskManagerPlugin::ComputeTrialScore()
     {
-        std::shared_ptr<ariac_common::KittingScore> kitting_score = nullptr;
-        std::shared_ptr<ariac_common::AssemblyScore> assembly_score = nullptr;
-        std::shared_ptr<ariac_common::CombinedScore> combined_score = nullptr;
+        // Orders submitted just before the end may still be being scored
+        impl_->scoring_pool_->Wait();
+        impl_->ApplyScores();
 
         std::shared_ptr<ariac_common::Order> kitting_order = nullptr;
         std::shared_ptr<ariac_common::Order> assembly_order = nullptr;
         std::shared_ptr<ariac_common::Order> combined_order = nullptr;
 
+        // Keep the last scored order of each type for the summary
         for (auto &order : impl_->all_orders_)
         {
             if (order->GetKittingScore())
-            {
                 kitting_order = order;
-                kitting_score = order->GetKittingScore();
-                impl_->trial_score_ += kitting_score->GetScore();
-            }
-
             if (order->GetAssemblyScore())
-            {
                 assembly_order = order;
-                assembly_score = order->GetAssemblyScore();
-                impl_->trial_score_ += assembly_score->GetScore();
-            }
-
             if (order->GetCombinedScore())
-            {
                 combined_order = order;
-                combined_score = order->GetCombinedScore();
-                impl_->trial_score_ += combined_score->GetScore();
-            }
+        }
+
+        impl_->trial_score_ += ariac_scoring::ComputeTrialScore(impl_->all_orders_);
+
+        if (impl_->capture_)
+        {
+            impl_->capture_->WriteTrialEnd(impl_->elapsed_time_, impl_->trial_score_);
+            impl_->capture_->Close();
         }
 
         impl_->PrintTrialScore(kitting_order, assembly_order, combined_order);
@@ -2694,67 +2143,52 @@ namespace ariac_plugins
 
         auto trial_completion_time = std::max({kitting_submitted_time, assembly_submitted_time, combined_submitted_time});
 
-        std::string output = "";
-        output += "\n\n\n\n========================================\n";
-        output += "END OF TRIAL\n";
-        output += "========================================\n";
-        output += "Trial file: " + trial_name_ + "\n";
-        output += "Trial time limit: " + std::to_string(time_limit_) + "\n";
-        output += "Trial completion time: " + std::to_string(trial_completion_time) + "\n";
-        output += "Trial score: " + std::to_string((int)trial_score_) + "\n";
-        output += "========================================\n";
-        output += "ORDERS\n";
+        ariac_scoring::ScoreRecord record("trial_score", "END OF TRIAL");
+        record.Add("trial_file", "Trial file", trial_name_);
+        record.Add("time_limit", "Trial time limit", time_limit_);
+        record.Add("completion_time", "Trial completion time", trial_completion_time);
+        record.Add("score", "Trial score", (int)trial_score_);
 
-        if (kitting_order != nullptr)
+        auto add_order = [&record](const std::string &type, std::shared_ptr<ariac_common::Order> order,
+                                   double completion_time, int score)
         {
-            output += "========================================\n";
-            output += "Kitting: " + kitting_order->GetId() + "\n";
-            output += "Announcement time: " + std::to_string(kitting_order->GetAnnouncedTime()) + "\n";
-            output += "Submission time: " + std::to_string(kitting_order->GetSubmittedTime()) + "\n";
-            output += "Completion time: " + std::to_string(kitting_completion_time) + "\n";
-            output += "Score: " + std::to_string(kitting_order->GetKittingScore()->GetScore()) + "\n";
-        }
+            ariac_scoring::ScoreRecord order_record;
+            order_record.Add("order_id", type, order->GetId());
+            order_record.Add("announced_time", "Announcement time", order->GetAnnouncedTime());
+            order_record.Add("submitted_time", "Submission time", order->GetSubmittedTime());
+            order_record.Add("completion_time", "Completion time", completion_time);
+            order_record.Add("score", "Score", score);
+            record.AddChild("orders", "ORDERS", std::move(order_record));
+        };
 
+        if (kitting_order != nullptr)
+            add_order("Kitting", kitting_order, kitting_completion_time, kitting_order->GetKittingScore()->GetScore());
         if (assembly_order != nullptr)
-        {
-            output += "========================================\n";
-            output += "Assembly: " + assembly_order->GetId() + "\n";
-            output += "Announcement time: " + std::to_string(assembly_order->GetAnnouncedTime()) + "\n";
-            output += "Submission time: " + std::to_string(assembly_order->GetSubmittedTime()) + "\n";
-            output += "Completion time: " + std::to_string(assembly_completion_time) + "\n";
-            output += "Score: " + std::to_string(assembly_order->GetAssemblyScore()->GetScore()) + "\n";
-        }
-
+            add_order("Assembly", assembly_order, assembly_completion_time, assembly_order->GetAssemblyScore()->GetScore());
         if (combined_order != nullptr)
-        {
-            output += "========================================\n";
-            output += "Combined: " + combined_order->GetId() + "\n";
-            output += "Announcement time: " + std::to_string(combined_order->GetAnnouncedTime()) + "\n";
-            output += "Submission time: " + std::to_string(combined_order->GetSubmittedTime()) + "\n";
-            output += "Completion time: " + std::to_string(combined_completion_time) + "\n";
-            output += "Score: " + std::to_string(combined_order->GetCombinedScore()->GetScore()) + "\n";
-        }
+            add_order("Combined", combined_order, combined_completion_time, combined_order->GetCombinedScore()->GetScore());
+
+        RCLCPP_INFO_STREAM(ros_node_->get_logger(), "\n\n\n" << record.ToText());
+        score_log_.Write(std::move(record));
 
-        RCLCPP_INFO_STREAM(ros_node_->get_logger(), output);
-        log_message_ += output;
-        WriteToLog();
+        // The trial is over, flush what is left of the log
+        WriteSnapshot();
+        score_log_.Close();
     }
 
     //==============================================================================
-    void TaskManagerPlugin::ProcessEndSafeZonePenalty()
+    void TaskManagerPlugin::EndSafeZonePenalty()
     {
-        if (impl_->safe_zone_penalty_started_)
-        {
-            // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Elapsed time: " << impl_->elapsed_time_);
-            // RCLCPP_INFO_STREAM(impl_->ros_node_->get_logger(), "Penalty time: " << impl_->safe_zone_penalty_start_time_ + impl_->safe_zone_penalty_duration_);
-            if (impl_->elapsed_time_ >= impl_->safe_zone_penalty_start_time_ + impl_->safe_zone_penalty_duration_)
-            {
-                impl_->safe_zone_penalty_started_ = false;
-                impl_->ceiling_robot_health_ = true;
-                // Track the end time of the safe zone penalty
-                impl_->safe_zone_penalty_end_time_ = impl_->elapsed_time_;
-            }
-        }
+        // The penalty may have been restarted since this event was scheduled,
+        // in which case a later event ends it
+        if (!impl_->safe_zone_penalty_started_ ||
+            impl_->elapsed_time_ < impl_->safe_zone_penalty_start_time_ + impl_->safe_zone_penalty_duration_)
+            return;
+
+        impl_->safe_zone_penalty_started_ = false;
+        impl_->ceiling_robot_health_ = true;
+        // Track the end time of the safe zone penalty
+        impl_->safe_zone_penalty_end_time_ = impl_->elapsed_time_;
     }
 
     //==============================================================================
@@ -2774,6 +2208,9 @@ namespace ariac_plugins
         impl_->ceiling_robot_health_ = false;
         impl_->safe_zone_penalty_start_time_ = impl_->elapsed_time_;
         impl_->safe_zone_penalty_started_ = true;
+        ScheduleTimedEvent(impl_->safe_zone_penalty_start_time_ + impl_->safe_zone_penalty_duration_,
+                           [this]()
+                           { EndSafeZonePenalty(); });
     }
 
     //==============================================================================
@@ -2781,8 +2218,6 @@ namespace ariac_plugins
         const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
         std::shared_ptr<std_srvs::srv::Trigger::Response> response)
     {
-        std::lock_guard<std::mutex> lock(this->impl_->lock_);
-
         (void)request;
 
         response->success = true;
@@ -2798,8 +2233,6 @@ namespace ariac_plugins
         const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
         std::shared_ptr<std_srvs::srv::Trigger::Response> response)
     {
-        std::lock_guard<std::mutex> lock(this->impl_->lock_);
-
         (void)request;
 
         this->impl_->current_state_ = ariac_msgs::msg::CompetitionState::ENDED;
@@ -2819,32 +2252,33 @@ namespace ariac_plugins
         ariac_msgs::srv::PerformQualityCheck::Response::SharedPtr response)
     {
         response->valid_id = false;
-        int idx;
 
-        // Check if order id matches any of the orders
-        for (int i = 0; i < all_orders_.size(); i++)
-        {
-            if (request->order_id == all_orders_.at(i)->GetId())
-            {
-                // Check if that order is kitting
-                if (all_orders_.at(i)->GetType() == ariac_msgs::msg::Order::KITTING)
-                {
-                    // Retrieve the kitting task
-                    idx = i;
-                    response->valid_id = true;
-                    break;
-                }
-            }
-        }
+        if (capture_)
+            capture_->WriteQualityCheck(elapsed_time_, request->order_id);
+
+        // Check if order id matches a kitting order
+        auto order = FindOrder(request->order_id);
+        if (order && order->GetType() == ariac_msgs::msg::Order::KITTING)
+            response->valid_id = true;
 
         if (!response->valid_id)
             return;
 
-        auto task = all_orders_.at(idx)->GetKittingTask();
+        auto task = order->GetKittingTask();
+        int agv = task->GetAgvNumber();
+
+        // The response only depends on the order and the shipment, so checks of an unchanged tray are a lookup
+        std::uint64_t generation = 0;
+        auto tray_shipment = TrayShipment(agv, generation);
+
+        auto cached = quality_checks_.find(request->order_id);
+        if (cached != quality_checks_.end() && cached->second.agv == agv && cached->second.generation == generation)
+        {
+            *response = cached->second.response;
+            return;
+        }
 
-        // Instantiate a KittingShipment from the agv_tray_sensor data
-        auto shipment = ParseAGVTraySensorImage(agv_tray_images_[task->GetAgvNumber()]);
-        // RCLCPP_INFO(ros_node_->get_logger(), shipment.DebugString().c_str());
+        const auto &shipment = *tray_shipment;
 
         if (task->GetTrayId() != shipment.GetTrayId())
             response->incorrect_tray = true;
@@ -2901,6 +2335,47 @@ namespace ariac_plugins
 
             response->all_passed = true;
         }
+
+        quality_checks_[request->order_id] = {agv, generation, *response};
+    }
+
+    //==============================================================================
+    std::shared_ptr<const ariac_common::KittingShipment> TaskManagerPluginPrivate::TrayShipment(int _agv_id, std::uint64_t &_generation)
+    {
+        auto image = LatestTrayImage(_agv_id);
+        auto agv = FindAGV(_agv_id);
+        if (!agv)
+        {
+            _generation = 0;
+            return std::make_shared<const ariac_common::KittingShipment>(ParseAGVTraySensorImage(*image));
+        }
+
+        if (agv->quality_image != image)
+        {
+            auto shipment = std::make_shared<const ariac_common::KittingShipment>(ParseAGVTraySensorImage(*image));
+
+            // Everything a quality check reads from the shipment is compared with the previous one
+            std::vector<TrayPartKey> parts;
+            parts.reserve(shipment->GetTrayParts().size());
+            for (const auto &tray_part : shipment->GetTrayParts())
+            {
+                parts.emplace_back(tray_part.GetModelName(), tray_part.GetQuadrant(),
+                                   tray_part.GetPart().GetType(), tray_part.GetPart().GetColor(),
+                                   tray_part.isFlipped());
+            }
+
+            if (!agv->quality_shipment || shipment->GetTrayId() != agv->quality_tray_id || parts != agv->quality_parts)
+            {
+                agv->quality_tray_id = shipment->GetTrayId();
+                agv->quality_parts = std::move(parts);
+                agv->quality_generation++;
+            }
+            agv->quality_shipment = shipment;
+            agv->quality_image = image;
+        }
+
+        _generation = agv->quality_generation;
+        return agv->quality_shipment;
     }
 
     //==============================================================================
@@ -2911,31 +2386,19 @@ namespace ariac_plugins
         // Check if service has already been checked for requested order
         response->valid_id = false;
 
-        std::shared_ptr<ariac_common::Order> order = nullptr;
-
-        // Check if order id matches any of the orders
-        for (int i = 0; i < all_orders_.size(); i++)
+        // Check if order id matches an assembly or combined order
+        auto order = FindOrder(request->order_id);
+        if (order && (order->GetType() == ariac_msgs::msg::Order::ASSEMBLY ||
+                      order->GetType() == ariac_msgs::msg::Order::COMBINED))
         {
-            if (request->order_id == all_orders_.at(i)->GetId())
+            if (order->WasPreAssemblyServiceCalled())
             {
-                // Check if that order is assembly or combined
-                if (all_orders_.at(i)->GetType() == ariac_msgs::msg::Order::ASSEMBLY ||
-                    all_orders_.at(i)->GetType() == ariac_msgs::msg::Order::COMBINED)
-                {
-                    // Retrieve the kitting task
-                    order = all_orders_.at(i);
-
-                    if (order->WasPreAssemblyServiceCalled())
-                    {
-                        RCLCPP_WARN(ros_node_->get_logger(), "Cannot call service twice for the same order");
-                        response->valid_id = false;
-                        return;
-                    }
-
-                    response->valid_id = true;
-                    break;
-                }
+                RCLCPP_WARN(ros_node_->get_logger(), "Cannot call service twice for the same order");
+                response->valid_id = false;
+                return;
             }
+
+            response->valid_id = true;
         }
 
         if (!response->valid_id)
@@ -2952,34 +2415,19 @@ namespace ariac_plugins
             order_station = order->GetCombinedTask()->GetStation();
         }
 
+        // Each pair of AGVs serves two stations, AS1 and AS2 for AGVs 1 and 2, AS3 and AS4 for AGVs 3 and 4, and so on.
+        // The odd station of the pair is at the front location and the even one at the back location.
         std::vector<int> agvs_to_check;
-        if (order_station == ariac_msgs::msg::AssemblyTask::AS1)
-        {
-            if (agv1_location_ == ariac_msgs::msg::AGVStatus::ASSEMBLY_FRONT)
-                agvs_to_check.push_back(1);
-            if (agv2_location_ == ariac_msgs::msg::AGVStatus::ASSEMBLY_FRONT)
-                agvs_to_check.push_back(2);
-        }
-        else if (order_station == ariac_msgs::msg::AssemblyTask::AS2)
+        if (order_station >= 1)
         {
-            if (agv1_location_ == ariac_msgs::msg::AGVStatus::ASSEMBLY_BACK)
-                agvs_to_check.push_back(1);
-            if (agv2_location_ == ariac_msgs::msg::AGVStatus::ASSEMBLY_BACK)
-                agvs_to_check.push_back(2);
-        }
-        else if (order_station == ariac_msgs::msg::AssemblyTask::AS3)
-        {
-            if (agv3_location_ == ariac_msgs::msg::AGVStatus::ASSEMBLY_FRONT)
-                agvs_to_check.push_back(3);
-            if (agv4_location_ == ariac_msgs::msg::AGVStatus::ASSEMBLY_FRONT)
-                agvs_to_check.push_back(4);
-        }
-        else if (order_station == ariac_msgs::msg::AssemblyTask::AS4)
-        {
-            if (agv3_location_ == ariac_msgs::msg::AGVStatus::ASSEMBLY_BACK)
-                agvs_to_check.push_back(3);
-            if (agv4_location_ == ariac_msgs::msg::AGVStatus::ASSEMBLY_BACK)
-                agvs_to_check.push_back(4);
+            int first_agv = 2 * ((order_station - 1) / 2) + 1;
+            int station_location = order_station % 2 == 1 ? ariac_msgs::msg::AGVStatus::ASSEMBLY_FRONT
+                                                           : ariac_msgs::msg::AGVStatus::ASSEMBLY_BACK;
+            for (int agv = first_agv; agv <= first_agv + 1; agv++)
+            {
+                if (AGVLocation(agv) == station_location)
+                    agvs_to_check.push_back(agv);
+            }
         }
 
         if (agvs_to_check.size() == 0)
@@ -2996,47 +2444,32 @@ namespace ariac_plugins
         // Get part poses on AGVs to check
         for (auto agv : agvs_to_check)
         {
+            auto image = LatestTrayImage(agv);
+
             KDL::Frame world_to_sensor;
             tf2::fromMsg(gazebo_ros::Convert<geometry_msgs::msg::Pose>(
-                             gazebo::msgs::ConvertIgn(agv_tray_images_[agv].pose())),
+                             gazebo::msgs::ConvertIgn(image->pose())),
                          world_to_sensor);
 
-            for (int i = 0; i < agv_tray_images_[agv].model_size(); i++)
+            for (int i = 0; i < image->model_size(); i++)
             {
-                const auto &lc_model = agv_tray_images_[agv].model(i);
-                std::string model_name = lc_model.name();
+                const auto &lc_model = image->model(i);
+                const auto info = ariac_common::ClassifyModelName(lc_model.name());
+                if (!info.IsPart())
+                    continue;
 
-                bool classified_part = false;
-                // Determine part type
-                for (const auto &part_type : part_types_)
-                {
-                    if (model_name.find(part_type.first) != std::string::npos)
-                    {
-                        // Determine part color
-                        for (const auto &color : part_colors_)
-                        {
-                            if (model_name.find(color.first) != std::string::npos)
-                            {
-                                ariac_msgs::msg::PartPose part_pose;
-                                part_pose.part.type = part_type.second;
-                                part_pose.part.color = color.second;
-
-                                KDL::Frame sensor_to_part;
-                                tf2::fromMsg(gazebo_ros::Convert<geometry_msgs::msg::Pose>(
-                                                 gazebo::msgs::ConvertIgn(lc_model.pose())),
-                                             sensor_to_part);
-
-                                part_pose.pose = tf2::toMsg(world_to_sensor * sensor_to_part);
-
-                                response->parts.push_back(part_pose);
-                                classified_part = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (classified_part)
-                        break;
-                }
+                ariac_msgs::msg::PartPose part_pose;
+                part_pose.part.type = info.type;
+                part_pose.part.color = info.color;
+
+                KDL::Frame sensor_to_part;
+                tf2::fromMsg(gazebo_ros::Convert<geometry_msgs::msg::Pose>(
+                                 gazebo::msgs::ConvertIgn(lc_model.pose())),
+                             sensor_to_part);
+
+                part_pose.pose = tf2::toMsg(world_to_sensor * sensor_to_part);
+
+                response->parts.push_back(part_pose);
             }
         }
     }
@@ -3044,172 +2477,82 @@ namespace ariac_plugins
     //==============================================================================
     std::array<bool, 4> TaskManagerPluginPrivate::HandleFaultyParts(std::shared_ptr<ariac_common::FaultyPartChallenge> _challenge, ariac_common::KittingTask _task, ariac_common::KittingShipment _shipment)
     {
-        // quadrant1, quadrant2, quadrant3, quadrant4
-        std::array<bool, 4> faulty_parts = {false, false, false, false};
+        std::vector<std::pair<int, std::string>> newly_faulty;
+        auto faulty_parts = ariac_scoring::FindFaultyParts(*_challenge, _task, _shipment, newly_faulty);
 
-        for (int i = 1; i < 5; i++)
+        // Rename parts in gazebo so they are reported as faulty from now on
+        for (const auto &faulty : newly_faulty)
         {
-            if (_challenge->IsQuadrantFaulty(i))
-            {
-                // RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Quadrant " + std::to_string(i) + " is faulty");
-                if (!_challenge->WasQuadrantChecked(i))
-                {
-                    // RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Quadrant was not checked");
-                    // Rename part in gazebo
-                    for (auto &product : _task.GetProducts())
-                    {
-                        if (product.GetQuadrant() == i)
-                        {
-                            // RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Quadrant: " << product.GetQuadrant());
-                            for (auto tray_part : _shipment.GetTrayParts())
-                            {
-                                if (tray_part.GetQuadrant() == i)
-                                {
-                                    // RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Quadrant " << i);
-                                    if (tray_part.isCorrectType(product.GetPart().GetType()) &&
-                                        tray_part.isCorrectColor(product.GetPart().GetColor()))
-                                    {
-                                        std::string original_name = tray_part.GetModelName();
-                                        // RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Changing name to (" + original_name + "_faulty)");
-                                        world_->ModelByName(original_name)->SetName(original_name + "_faulty");
-                                        _challenge->SetQuadrantChecked(i);
-
-                                        // Set faulty part for the quadrant
-                                        RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Part in quadrant " << std::to_string(i) << " is faulty");
-                                        faulty_parts[i - 1] = true;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    for (auto tray_part : _shipment.GetTrayParts())
-                    {
-                        if (tray_part.GetQuadrant() == i)
-                        {
-                            faulty_parts[i - 1] = tray_part.isFaulty();
-                        }
-                    }
-                }
-            }
+            auto model = world_->ModelByName(faulty.second);
+            if (model)
+                model->SetName(faulty.second + "_faulty");
+            RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Part in quadrant " << std::to_string(faulty.first) << " is faulty");
         }
+
         return faulty_parts;
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::StoreStationParts(int station, gazebo::msgs::LogicalCameraImage &_msg)
+    void TaskManagerPluginPrivate::StoreStationParts(int station, const gazebo::msgs::LogicalCameraImage &_msg)
     {
-        insert_parts_.find(station)->second.clear();
         int assembly_insert = -1;
         std::vector<ariac_common::Part> insert_parts;
 
         for (int i = 0; i < _msg.model_size(); i++)
         {
-            const auto &lc_model = _msg.model(i);
-            std::string model_name = lc_model.name();
+            const auto info = ariac_common::ClassifyModelName(_msg.model(i).name());
 
-            // name of the insert is "assembly_insert_XX" where XX indicates the id of the insert
-            if (model_name.find("assembly_insert") != std::string::npos)
-            {
-                std::string id_string = model_name.substr(16, 1);
-                assembly_insert = std::stoi(id_string);
-                // RCLCPP_INFO_STREAM(ros_node_->get_logger(), "Assembly insert: " << id_string);
-            }
+            if (info.IsInsert())
+                assembly_insert = info.insert_id;
+            else if (info.IsPart())
+                insert_parts.push_back(ariac_common::Part(info.color, info.type));
         }
-        // If no insert is detected, return
-        if (assembly_insert == -1)
-            return;
 
-        // Fill vector of AssemblyParts
-        for (int i = 0; i < _msg.model_size(); i++)
-        {
-            const auto &lc_model = _msg.model(i);
-            std::string model_name = lc_model.name();
-
-            bool classified_part = false;
-            // Determine part type
-            for (const auto &type : part_types_)
+        // The image is parsed on the transport thread, the parts are stored by OnUpdate without blocking it
+        commands_.Push(
+            [this, station, assembly_insert, insert_parts]()
             {
-                if (model_name.find(type.first) != std::string::npos)
-                {
-                    // Determine part color
-                    for (const auto &color : part_colors_)
-                    {
-                        if (model_name.find(color.first) != std::string::npos)
-                        {
-                            ariac_common::Part part(color.second, type.second);
-                            insert_parts.push_back(part);
+                insert_parts_[station].clear();
 
-                            classified_part = true;
-                            break;
-                        }
-                    }
-                }
-                if (classified_part)
-                    break;
-            }
-        }
-        insert_parts_[assembly_insert] = insert_parts;
+                // If no insert is detected, return
+                if (assembly_insert == -1)
+                    return;
+
+                insert_parts_[assembly_insert] = insert_parts;
+            });
     }
 
     //==============================================================================
-    void TaskManagerPluginPrivate::StoreAGVParts(int agv_id, gazebo::msgs::LogicalCameraImage &_msg)
+    void TaskManagerPluginPrivate::StoreAGVParts(int agv_id, const gazebo::msgs::LogicalCameraImage &_msg)
     {
-        agv_parts_.find(agv_id)->second.clear();
+        ariac_common::ScopedTimer timer(store_agv_parts_timing_);
         std::vector<ariac_common::Part> kit_tray_parts;
 
         int kit_tray_id = -1;
 
         for (int i = 0; i < _msg.model_size(); i++)
         {
-            const auto &lc_model = _msg.model(i);
+            const auto info = ariac_common::ClassifyModelName(_msg.model(i).name());
 
-            std::string model_name = lc_model.name();
-            // name of kit tray model is "kit_tray_XX_YY" where XX indicates
-            // the marker_id for the tray
-            if (model_name.find("kit_tray") != std::string::npos)
-            {
-                std::string id_string = model_name.substr(9, 2);
-                kit_tray_id = std::stoi(id_string);
-            }
+            if (info.IsKitTray())
+                kit_tray_id = info.tray_id;
+            else if (info.IsPart())
+                kit_tray_parts.push_back(ariac_common::Part(info.color, info.type));
         }
 
-        // If no kit tray is detected return
+        // If no kit tray is detected the AGV has no parts
         if (kit_tray_id == -1)
-            return;
-
-        // Fill vector of KitTrayParts
-        for (int i = 0; i < _msg.model_size(); i++)
-        {
-            const auto &lc_model = _msg.model(i);
-            std::string model_name = lc_model.name();
+            kit_tray_parts.clear();
 
-            bool classified_part = false;
-            // Determine part type
-            for (const auto &type : part_types_)
+        // The image is parsed on the transport thread, OnUpdate stores the parts and fires the
+        // part placement triggers without blocking it
+        commands_.Push(
+            [this, agv_id, kit_tray_parts]()
             {
-                if (model_name.find(type.first) != std::string::npos)
-                {
-                    // Determine part color
-                    for (const auto &color : part_colors_)
-                    {
-                        if (model_name.find(color.first) != std::string::npos)
-                        {
-                            ariac_common::Part part(color.second, type.second);
-                            kit_tray_parts.push_back(part);
-
-                            classified_part = true;
-                            break;
-                        }
-                    }
-                }
-                if (classified_part)
-                    break;
-            }
-        }
-        agv_parts_[agv_id] = kit_tray_parts;
+                auto &agv_parts = agvs_[agv_id - 1].parts;
+                QueueAddedAGVParts(agv_id, agv_parts, kit_tray_parts);
+                agv_parts = kit_tray_parts;
+            });
 
         // if (agv_id == 4)
         // {
@@ -3225,178 +2568,36 @@ namespace ariac_plugins
     }
 
     //==============================================================================
-    ariac_common::AssemblyShipment TaskManagerPluginPrivate::ParseAssemblyStationImage(gazebo::msgs::LogicalCameraImage &_msg)
+    ariac_common::AssemblyShipment TaskManagerPluginPrivate::ParseAssemblyStationImage(const gazebo::msgs::LogicalCameraImage &_msg)
     {
-        // Create an assembly shipment from data in the msg
-        KDL::Frame sensor_to_insert;
-        int insert_id = -1;
-        geometry_msgs::msg::Pose insert_pose;
-        std::vector<ariac_common::InsertPart> insert_parts;
-
-        // find insert
-        for (int i = 0; i < _msg.model_size(); i++)
-        {
-            const auto &lc_model = _msg.model(i);
-            std::string model_name = lc_model.name();
-
-            // name of the insert is "assembly_insert_XX" where XX indicates the id of the insert
-            if (model_name.find("assembly_insert") != std::string::npos)
-            {
-                std::string id_string = model_name.substr(16, 1);
-                insert_id = std::stoi(id_string);
-                auto pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
-
-                tf2::fromMsg(pose, sensor_to_insert);
-            }
-        }
-        // If no insert is detected return an empty shipment
-        if (insert_id == -1)
-            return ariac_common::AssemblyShipment(insert_id, insert_parts);
-
-        // Fill vector of ariac_common::AssemblyPart
-        for (int i = 0; i < _msg.model_size(); i++)
-        {
-            const auto &lc_model = _msg.model(i);
-            std::string model_name = lc_model.name();
-
-            bool classified_part = false;
-            // Determine part type
-            for (const auto &type : part_types_)
-            {
-                if (model_name.find(type.first) != std::string::npos)
-                {
-                    // Determine part color
-                    for (const auto &color : part_colors_)
-                    {
-                        if (model_name.find(color.first) != std::string::npos)
-                        {
-                            ariac_common::Part part(color.second, type.second);
-
-                            // Get pose in insert
-                            KDL::Frame sensor_to_part;
-                            tf2::fromMsg(gazebo_ros::Convert<geometry_msgs::msg::Pose>(
-                                             gazebo::msgs::ConvertIgn(lc_model.pose())),
-                                         sensor_to_part);
-
-                            KDL::Frame insert_to_part;
-                            insert_to_part = sensor_to_insert.Inverse() * sensor_to_part;
-
-                            geometry_msgs::msg::Pose pose_in_insert = tf2::toMsg(insert_to_part);
-
-                            // Create AssemblyPart
-                            ariac_common::InsertPart insert_part(part, model_name, pose_in_insert);
-
-                            insert_parts.push_back(insert_part);
-                            classified_part = true;
-                            break;
-                        }
-                    }
-                }
-                if (classified_part)
-                    break;
-            }
-        }
-
-        return ariac_common::AssemblyShipment(insert_id, insert_parts);
+        ariac_common::ScopedTimer timer(parse_station_timing_);
+        return ariac_scoring::ParseAssemblyShipment(ToSensedModels(_msg));
     }
 
     //==============================================================================
     ariac_common::KittingShipment
-    TaskManagerPluginPrivate::ParseAGVTraySensorImage(gazebo::msgs::LogicalCameraImage &_msg)
+    TaskManagerPluginPrivate::ParseAGVTraySensorImage(const gazebo::msgs::LogicalCameraImage &_msg)
     {
-        // Create a kitting shipment from data in the msg
-        KDL::Frame sensor_to_tray;
-        int kit_tray_id = -1;
-        geometry_msgs::msg::Pose kit_tray_pose;
-        std::vector<ariac_common::KitTrayPart> tray_parts;
-
-        // Find Kit Tray
-        for (int i = 0; i < _msg.model_size(); i++)
-        {
-            const auto &lc_model = _msg.model(i);
-
-            std::string model_name = lc_model.name();
-            // name of kit tray model is "kit_tray_XX_YY" where XX indicates
-            // the marker_id for the tray
-            if (model_name.find("kit_tray") != std::string::npos)
-            {
-
-                std::string id_string = model_name.substr(9, 2);
-                kit_tray_id = std::stoi(id_string);
-                auto pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
-
-                tf2::fromMsg(pose, sensor_to_tray);
-            }
-        }
-
-        // If no kit tray is detected return an empty shipment
-        if (kit_tray_id == -1)
-            return ariac_common::KittingShipment(kit_tray_id, tray_parts);
-
-        // Fill vector of KitTrayParts
-        for (int i = 0; i < _msg.model_size(); i++)
-        {
-            const auto &lc_model = _msg.model(i);
-            std::string model_name = lc_model.name();
-
-            bool classified_part = false;
-            // Determine part type
-            for (const auto &type : part_types_)
-            {
-                if (model_name.find(type.first) != std::string::npos)
-                {
-                    // Determine part color
-                    for (const auto &color : part_colors_)
-                    {
-                        if (model_name.find(color.first) != std::string::npos)
-                        {
-                            ariac_common::Part part(color.second, type.second);
-
-                            // Get pose on tray
-                            KDL::Frame sensor_to_part;
-                            tf2::fromMsg(gazebo_ros::Convert<geometry_msgs::msg::Pose>(
-                                             gazebo::msgs::ConvertIgn(lc_model.pose())),
-                                         sensor_to_part);
-
-                            KDL::Frame tray_to_part;
-                            tray_to_part = sensor_to_tray.Inverse() * sensor_to_part;
-
-                            geometry_msgs::msg::Pose pose_on_tray = tf2::toMsg(tray_to_part);
-
-                            // Create KitTrayPart
-                            ariac_common::KitTrayPart tray_part(part, model_name, pose_on_tray);
-
-                            tray_parts.push_back(tray_part);
-                            classified_part = true;
-                            break;
-                        }
-                    }
-                }
-                if (classified_part)
-                    break;
-            }
-        }
-
-        return ariac_common::KittingShipment(kit_tray_id, tray_parts);
+        return ariac_scoring::ParseKittingShipment(ToSensedModels(_msg));
     }
 
     //==============================================================================
     ariac_msgs::msg::QualityIssue TaskManagerPluginPrivate::CheckQuadrantQuality(int quadrant,
-                                                                                 ariac_common::KittingTask task,
-                                                                                 ariac_common::KittingShipment shipment,
-                                                                                 std::string order_id)
+                                                                                 const ariac_common::KittingTask &task,
+                                                                                 const ariac_common::KittingShipment &shipment,
+                                                                                 const std::string &order_id)
     {
         ariac_msgs::msg::QualityIssue issue;
 
         bool task_has_part_in_quadrant = false;
 
-        for (auto product : task.GetProducts())
+        for (const auto &product : task.GetProducts())
         {
             if (product.GetQuadrant() == quadrant)
             {
                 task_has_part_in_quadrant = true;
-                bool shipment_has_part_in_quadrant;
-                for (auto tray_part : shipment.GetTrayParts())
+                bool shipment_has_part_in_quadrant = false;
+                for (const auto &tray_part : shipment.GetTrayParts())
                 {
                     if (tray_part.GetQuadrant() == quadrant)
                     {
@@ -0,0 +1,146 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#include <ariac_plugins/timing_registry.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+#include <diagnostic_msgs/msg/key_value.hpp>
+
+namespace ariac_common
+{
+    //==============================================================================
+    std::size_t LatencyHistogram::BucketIndex(uint64_t _ns)
+    {
+        _ns = std::min<uint64_t>(_ns, (uint64_t(1) << kMaxBits) - 1);
+        if (_ns < kSubBucketCount)
+            return static_cast<std::size_t>(_ns);
+
+        // The top kSubBucketBits + 1 bits select the bucket, the others are dropped
+        int shift = (63 - __builtin_clzll(_ns)) - kSubBucketBits;
+        uint64_t sub_bucket = (_ns >> shift) - kSubBucketCount;
+        return static_cast<std::size_t>((shift + 1) * kSubBucketCount + sub_bucket);
+    }
+
+    //==============================================================================
+    uint64_t LatencyHistogram::BucketValue(std::size_t _index)
+    {
+        if (_index < kSubBucketCount)
+            return _index;
+
+        int shift = static_cast<int>(_index / kSubBucketCount) - 1;
+        uint64_t sub_bucket = _index % kSubBucketCount;
+        return ((kSubBucketCount + sub_bucket + 1) << shift) - 1;
+    }
+
+    //==============================================================================
+    void LatencyHistogram::Record(uint64_t _ns)
+    {
+        counts_[BucketIndex(_ns)].fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = max_ns_.load(std::memory_order_relaxed);
+        while (_ns > max && !max_ns_.compare_exchange_weak(max, _ns, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    //==============================================================================
+    LatencyHistogram::Summary LatencyHistogram::TakeSummary()
+    {
+        std::array<uint64_t, kBucketCount> counts;
+        Summary summary;
+        for (std::size_t i = 0; i < kBucketCount; i++)
+        {
+            counts[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+            summary.count += counts[i];
+        }
+        summary.max_ns = max_ns_.exchange(0, std::memory_order_relaxed);
+
+        if (summary.count == 0)
+            return summary;
+
+        // Rank of each percentile, rounded up so a single sample is its own p50 and p99
+        uint64_t p50_rank = (summary.count * 50 + 99) / 100;
+        uint64_t p99_rank = (summary.count * 99 + 99) / 100;
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount && seen < p99_rank; i++)
+        {
+            if (counts[i] == 0)
+                continue;
+            seen += counts[i];
+            if (summary.p50_ns == 0 && seen >= p50_rank)
+                summary.p50_ns = BucketValue(i);
+            if (seen >= p99_rank)
+                summary.p99_ns = BucketValue(i);
+        }
+
+        // Bucket values round up, they cannot exceed the exact maximum
+        summary.p50_ns = std::min(summary.p50_ns, summary.max_ns);
+        summary.p99_ns = std::min(summary.p99_ns, summary.max_ns);
+        return summary;
+    }
+
+    //==============================================================================
+    TimingRegistry &TimingRegistry::Instance()
+    {
+        // Defined in the shared library so every plugin sees the same instance
+        static TimingRegistry registry;
+        return registry;
+    }
+
+    //==============================================================================
+    LatencyHistogram *TimingRegistry::Histogram(const std::string &_plugin, const std::string &_step)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &histogram = histograms_[_plugin + "/" + _step];
+        if (!histogram)
+            histogram = std::make_unique<LatencyHistogram>();
+        return histogram.get();
+    }
+
+    //==============================================================================
+    diagnostic_msgs::msg::DiagnosticArray TimingRegistry::ToMsg()
+    {
+        auto key_value = [](const std::string &_key, const std::string &_value)
+        {
+            diagnostic_msgs::msg::KeyValue kv;
+            kv.key = _key;
+            kv.value = _value;
+            return kv;
+        };
+        auto to_us = [](uint64_t _ns)
+        {
+            std::ostringstream out;
+            out.setf(std::ios::fixed);
+            out.precision(1);
+            out << _ns / 1000.0;
+            return out.str();
+        };
+
+        diagnostic_msgs::msg::DiagnosticArray msg;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &entry : histograms_)
+        {
+            auto summary = entry.second->TakeSummary();
+
+            diagnostic_msgs::msg::DiagnosticStatus status;
+            status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+            status.name = "ariac_timing: " + entry.first;
+            status.hardware_id = "ariac";
+            status.message = "p50 " + to_us(summary.p50_ns) + " us, p99 " + to_us(summary.p99_ns) +
+                             " us, max " + to_us(summary.max_ns) + " us";
+            status.values.push_back(key_value("count", std::to_string(summary.count)));
+            status.values.push_back(key_value("p50_us", to_us(summary.p50_ns)));
+            status.values.push_back(key_value("p99_us", to_us(summary.p99_ns)));
+            status.values.push_back(key_value("max_us", to_us(summary.max_ns)));
+            msg.status.push_back(status);
+        }
+        return msg;
+    }
+} // namespace ariac_common
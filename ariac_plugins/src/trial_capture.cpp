@@ -0,0 +1,631 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#include <ariac_plugins/trial_capture.hpp>
+
+// C++
+#include <algorithm>
+#include <cstring>
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+// Messages
+#include <ariac_msgs/msg/order.hpp>
+
+namespace ariac_capture
+{
+    namespace
+    {
+        const char kMagic[8] = {'A', 'R', 'I', 'A', 'C', 'C', 'A', 'P'};
+        const std::size_t kFileHeaderSize = 16;
+        const std::size_t kRecordHeaderSize = 16;
+
+        //==============================================================================
+        std::size_t PaddedSize(std::size_t _size)
+        {
+            return (_size + 7) & ~static_cast<std::size_t>(7);
+        }
+
+        //==============================================================================
+        void WriteAssemblyProducts(PayloadWriter &_payload, const std::vector<ariac_common::AssemblyPart> &_products)
+        {
+            _payload.U32(_products.size());
+            for (const auto &product : _products)
+            {
+                auto pose = product.GetPartPose();
+                auto direction = product.GetPartDirection();
+                _payload.U32(product.GetPart().GetType());
+                _payload.U32(product.GetPart().GetColor());
+                _payload.F64(pose.Pos().X());
+                _payload.F64(pose.Pos().Y());
+                _payload.F64(pose.Pos().Z());
+                _payload.F64(pose.Rot().W());
+                _payload.F64(pose.Rot().X());
+                _payload.F64(pose.Rot().Y());
+                _payload.F64(pose.Rot().Z());
+                _payload.F64(direction.X());
+                _payload.F64(direction.Y());
+                _payload.F64(direction.Z());
+            }
+        }
+
+        //==============================================================================
+        bool ReadAssemblyProducts(PayloadReader &_payload, std::vector<ariac_common::AssemblyPart> &_products)
+        {
+            uint32_t count;
+            if (!_payload.U32(count))
+                return false;
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t type, color;
+                double v[10];
+                if (!_payload.U32(type) || !_payload.U32(color))
+                    return false;
+                for (double &value : v)
+                {
+                    if (!_payload.F64(value))
+                        return false;
+                }
+                _products.emplace_back(ariac_common::Part(color, type),
+                                       ignition::math::Pose3d(v[0], v[1], v[2], v[3], v[4], v[5], v[6]),
+                                       ignition::math::Vector3d(v[7], v[8], v[9]));
+            }
+            return true;
+        }
+
+        //==============================================================================
+        void WriteCondition(PayloadWriter &_payload, const ariac_msgs::msg::Condition &_condition)
+        {
+            _payload.U32(_condition.type);
+            if (_condition.type == ariac_msgs::msg::Condition::TIME)
+            {
+                _payload.F64(_condition.time_condition.seconds);
+            }
+            else if (_condition.type == ariac_msgs::msg::Condition::PART_PLACE)
+            {
+                _payload.U32(_condition.part_place_condition.agv);
+                _payload.U32(_condition.part_place_condition.part.type);
+                _payload.U32(_condition.part_place_condition.part.color);
+            }
+            else if (_condition.type == ariac_msgs::msg::Condition::SUBMISSION)
+            {
+                _payload.String(_condition.submission_condition.order_id);
+            }
+        }
+
+        //==============================================================================
+        bool ReadCondition(PayloadReader &_payload, ariac_msgs::msg::Condition &_condition)
+        {
+            uint32_t type;
+            if (!_payload.U32(type))
+                return false;
+            _condition.type = type;
+
+            if (type == ariac_msgs::msg::Condition::TIME)
+                return _payload.F64(_condition.time_condition.seconds);
+
+            if (type == ariac_msgs::msg::Condition::PART_PLACE)
+            {
+                uint32_t agv, part_type, color;
+                if (!_payload.U32(agv) || !_payload.U32(part_type) || !_payload.U32(color))
+                    return false;
+                _condition.part_place_condition.agv = agv;
+                _condition.part_place_condition.part.type = part_type;
+                _condition.part_place_condition.part.color = color;
+                return true;
+            }
+
+            if (type == ariac_msgs::msg::Condition::SUBMISSION)
+                return _payload.String(_condition.submission_condition.order_id);
+
+            return true;
+        }
+
+        //==============================================================================
+        // Announcement condition of a challenge, nullptr for the challenges that have none
+        const ariac_msgs::msg::Condition *ChallengeCondition(const ariac_msgs::msg::Challenge &_challenge)
+        {
+            if (_challenge.type == ariac_msgs::msg::Challenge::SENSOR_BLACKOUT)
+                return &_challenge.sensor_blackout_challenge.condition;
+            if (_challenge.type == ariac_msgs::msg::Challenge::ROBOT_MALFUNCTION)
+                return &_challenge.robot_malfunction_challenge.condition;
+            if (_challenge.type == ariac_msgs::msg::Challenge::HUMAN)
+                return &_challenge.human_challenge.condition;
+            return nullptr;
+        }
+
+        //==============================================================================
+        ariac_msgs::msg::Condition *ChallengeCondition(ariac_msgs::msg::Challenge &_challenge)
+        {
+            return const_cast<ariac_msgs::msg::Condition *>(
+                ChallengeCondition(static_cast<const ariac_msgs::msg::Challenge &>(_challenge)));
+        }
+    } // namespace
+
+    //==============================================================================
+    void PayloadWriter::Append(const void *_data, std::size_t _size)
+    {
+        auto bytes = static_cast<const uint8_t *>(_data);
+        bytes_.insert(bytes_.end(), bytes, bytes + _size);
+    }
+
+    //==============================================================================
+    void PayloadWriter::String(const std::string &_value)
+    {
+        U32(_value.size());
+        Append(_value.data(), _value.size());
+    }
+
+    //==============================================================================
+    void PayloadWriter::Pose(const geometry_msgs::msg::Pose &_pose)
+    {
+        F64(_pose.position.x);
+        F64(_pose.position.y);
+        F64(_pose.position.z);
+        F64(_pose.orientation.x);
+        F64(_pose.orientation.y);
+        F64(_pose.orientation.z);
+        F64(_pose.orientation.w);
+    }
+
+    //==============================================================================
+    void PayloadWriter::Models(const std::vector<ariac_scoring::SensedModel> &_models)
+    {
+        U32(_models.size());
+        for (const auto &model : _models)
+        {
+            String(model.name);
+            Pose(model.pose);
+        }
+    }
+
+    //==============================================================================
+    bool PayloadReader::Take(void *_data, std::size_t _size)
+    {
+        if (size_ - offset_ < _size)
+            return false;
+        std::memcpy(_data, data_ + offset_, _size);
+        offset_ += _size;
+        return true;
+    }
+
+    //==============================================================================
+    bool PayloadReader::String(std::string &_value)
+    {
+        uint32_t length;
+        if (!U32(length) || size_ - offset_ < length)
+            return false;
+        _value.assign(reinterpret_cast<const char *>(data_ + offset_), length);
+        offset_ += length;
+        return true;
+    }
+
+    //==============================================================================
+    bool PayloadReader::Pose(geometry_msgs::msg::Pose &_pose)
+    {
+        return F64(_pose.position.x) && F64(_pose.position.y) && F64(_pose.position.z) &&
+               F64(_pose.orientation.x) && F64(_pose.orientation.y) && F64(_pose.orientation.z) &&
+               F64(_pose.orientation.w);
+    }
+
+    //==============================================================================
+    bool PayloadReader::Models(std::vector<ariac_scoring::SensedModel> &_models)
+    {
+        uint32_t count;
+        if (!U32(count))
+            return false;
+
+        _models.clear();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ariac_scoring::SensedModel model;
+            if (!String(model.name) || !Pose(model.pose))
+                return false;
+            _models.push_back(std::move(model));
+        }
+        return true;
+    }
+
+    //==============================================================================
+    bool CaptureWriter::Open(const std::string &_path)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        file_.open(_path, std::ios::binary | std::ios::trunc);
+        if (!file_)
+            return false;
+
+        uint32_t version = kCaptureVersion;
+        uint32_t reserved = 0;
+        file_.write(kMagic, sizeof(kMagic));
+        file_.write(reinterpret_cast<const char *>(&version), sizeof(version));
+        file_.write(reinterpret_cast<const char *>(&reserved), sizeof(reserved));
+        return static_cast<bool>(file_);
+    }
+
+    //==============================================================================
+    void CaptureWriter::Close()
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (file_.is_open())
+            file_.close();
+    }
+
+    //==============================================================================
+    void CaptureWriter::Write(uint32_t _type, double _sim_time, const PayloadWriter &_payload, uint32_t _source)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (!file_.is_open())
+            return;
+
+        const auto &bytes = _payload.Bytes();
+        if (_source != 0)
+        {
+            auto &last = last_payloads_[{_type, _source}];
+            if (last == bytes)
+                return;
+            last = bytes;
+        }
+
+        uint32_t size = bytes.size();
+        file_.write(reinterpret_cast<const char *>(&_type), sizeof(_type));
+        file_.write(reinterpret_cast<const char *>(&size), sizeof(size));
+        file_.write(reinterpret_cast<const char *>(&_sim_time), sizeof(_sim_time));
+        file_.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+
+        static const char padding[8] = {};
+        file_.write(padding, PaddedSize(bytes.size()) - bytes.size());
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteTrayImage(double _sim_time, unsigned int _agv, const std::vector<ariac_scoring::SensedModel> &_models)
+    {
+        PayloadWriter payload;
+        payload.U32(_agv);
+        payload.Models(_models);
+        Write(TRAY_IMAGE, _sim_time, payload, _agv);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteStationImage(double _sim_time, unsigned int _station, const std::vector<ariac_scoring::SensedModel> &_models)
+    {
+        PayloadWriter payload;
+        payload.U32(_station);
+        payload.Models(_models);
+        Write(STATION_IMAGE, _sim_time, payload, _station);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteAGVStatus(double _sim_time, unsigned int _agv, int _location)
+    {
+        PayloadWriter payload;
+        payload.U32(_agv);
+        payload.I32(_location);
+        Write(AGV_STATUS, _sim_time, payload, _agv);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteOrderAnnounced(double _sim_time, const ariac_common::Order &_order)
+    {
+        PayloadWriter payload;
+        payload.String(_order.GetId());
+        payload.U32(_order.GetType());
+        payload.U32(_order.IsPriority());
+
+        if (auto task = _order.GetKittingTask())
+        {
+            payload.U32(task->GetAgvNumber());
+            payload.U32(task->GetTrayId());
+            payload.U32(task->GetDestination());
+            payload.U32(task->GetProducts().size());
+            for (const auto &product : task->GetProducts())
+            {
+                payload.U32(product.GetQuadrant());
+                payload.U32(product.GetPart().GetType());
+                payload.U32(product.GetPart().GetColor());
+            }
+        }
+        else if (auto task = _order.GetAssemblyTask())
+        {
+            payload.U32(task->GetStation());
+            payload.U32(task->GetAgvNumbers().size());
+            for (auto agv : task->GetAgvNumbers())
+                payload.U32(agv);
+            WriteAssemblyProducts(payload, task->GetProducts());
+        }
+        else if (auto task = _order.GetCombinedTask())
+        {
+            payload.U32(task->GetStation());
+            WriteAssemblyProducts(payload, task->GetProducts());
+        }
+
+        Write(ORDER_ANNOUNCED, _sim_time, payload);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteChallengeStarted(double _sim_time, unsigned int _type, const std::string &_description)
+    {
+        PayloadWriter payload;
+        payload.U32(_type);
+        payload.String(_description);
+        Write(CHALLENGE_STARTED, _sim_time, payload);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteFaultyPartChallenge(double _sim_time, const ariac_msgs::msg::FaultyPartChallenge &_challenge)
+    {
+        PayloadWriter payload;
+        payload.String(_challenge.order_id);
+        payload.U32(_challenge.quadrant1);
+        payload.U32(_challenge.quadrant2);
+        payload.U32(_challenge.quadrant3);
+        payload.U32(_challenge.quadrant4);
+        Write(FAULTY_PART_CHALLENGE, _sim_time, payload);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteSubmitOrder(double _sim_time, const std::string &_order_id)
+    {
+        PayloadWriter payload;
+        payload.String(_order_id);
+        Write(SUBMIT_ORDER, _sim_time, payload);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteQualityCheck(double _sim_time, const std::string &_order_id)
+    {
+        PayloadWriter payload;
+        payload.String(_order_id);
+        Write(QUALITY_CHECK, _sim_time, payload);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteOrderScored(double _sim_time, const std::string &_order_id, int _score)
+    {
+        PayloadWriter payload;
+        payload.String(_order_id);
+        payload.I32(_score);
+        Write(ORDER_SCORED, _sim_time, payload);
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteTrialEnd(double _sim_time, double _trial_score)
+    {
+        PayloadWriter payload;
+        payload.F64(_trial_score);
+        Write(TRIAL_END, _sim_time, payload);
+
+        std::lock_guard<std::mutex> lock(lock_);
+        file_.flush();
+    }
+
+    //==============================================================================
+    void CaptureWriter::WriteTrialConfig(double _sim_time, const ariac_msgs::msg::Trial &_trial)
+    {
+        PayloadWriter payload;
+        payload.U32(_trial.order_conditions.size());
+        for (const auto &order : _trial.order_conditions)
+        {
+            payload.String(order.id);
+            payload.U32(order.type);
+            WriteCondition(payload, order.condition);
+        }
+
+        // Faulty and dropped part challenges are not announced, they have no condition
+        uint32_t announced = 0;
+        for (const auto &challenge : _trial.challenges)
+        {
+            if (ChallengeCondition(challenge))
+                announced++;
+        }
+        payload.U32(announced);
+        for (const auto &challenge : _trial.challenges)
+        {
+            auto condition = ChallengeCondition(challenge);
+            if (!condition)
+                continue;
+            payload.U32(challenge.type);
+            WriteCondition(payload, *condition);
+        }
+
+        Write(TRIAL_CONFIG, _sim_time, payload);
+    }
+
+    //==============================================================================
+    CaptureReader::~CaptureReader()
+    {
+        if (data_ != nullptr)
+            munmap(const_cast<uint8_t *>(data_), size_);
+    }
+
+    //==============================================================================
+    bool CaptureReader::Open(const std::string &_path, std::string &_error)
+    {
+        int fd = open(_path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            _error = "cannot open file";
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < kFileHeaderSize)
+        {
+            close(fd);
+            _error = "not a capture file";
+            return false;
+        }
+
+        void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+            _error = "cannot map file";
+            return false;
+        }
+
+        data_ = static_cast<const uint8_t *>(data);
+        size_ = info.st_size;
+        madvise(data, size_, MADV_SEQUENTIAL);
+
+        uint32_t version;
+        std::memcpy(&version, data_ + sizeof(kMagic), sizeof(version));
+        if (std::memcmp(data_, kMagic, sizeof(kMagic)) != 0)
+        {
+            _error = "not a capture file";
+            return false;
+        }
+        if (version != kCaptureVersion)
+        {
+            _error = "unsupported capture version " + std::to_string(version);
+            return false;
+        }
+
+        offset_ = kFileHeaderSize;
+        return true;
+    }
+
+    //==============================================================================
+    bool CaptureReader::Next(Record &_record)
+    {
+        if (data_ == nullptr || offset_ >= size_)
+            return false;
+
+        uint32_t size;
+        if (size_ - offset_ < kRecordHeaderSize)
+        {
+            truncated_ = true;
+            return false;
+        }
+        std::memcpy(&_record.type, data_ + offset_, sizeof(_record.type));
+        std::memcpy(&size, data_ + offset_ + 4, sizeof(size));
+        std::memcpy(&_record.sim_time, data_ + offset_ + 8, sizeof(_record.sim_time));
+
+        // A capture cut short by a crash ends with a partial record
+        if (size_ - offset_ - kRecordHeaderSize < size)
+        {
+            truncated_ = true;
+            return false;
+        }
+
+        _record.payload = PayloadReader(data_ + offset_ + kRecordHeaderSize, size);
+        offset_ = std::min(size_, offset_ + kRecordHeaderSize + PaddedSize(size));
+        return true;
+    }
+
+    //==============================================================================
+    std::shared_ptr<ariac_common::Order> ReadOrder(PayloadReader &_payload)
+    {
+        std::string id;
+        uint32_t type, priority;
+        if (!_payload.String(id) || !_payload.U32(type) || !_payload.U32(priority))
+            return nullptr;
+
+        // The time limit is not used to score orders
+        auto order = std::make_shared<ariac_common::Order>(id, type, priority != 0, -1);
+
+        if (type == ariac_msgs::msg::Order::KITTING)
+        {
+            uint32_t agv, tray_id, destination, count;
+            if (!_payload.U32(agv) || !_payload.U32(tray_id) || !_payload.U32(destination) || !_payload.U32(count))
+                return nullptr;
+
+            std::vector<ariac_common::KittingPart> products;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t quadrant, part_type, color;
+                if (!_payload.U32(quadrant) || !_payload.U32(part_type) || !_payload.U32(color))
+                    return nullptr;
+                products.emplace_back(quadrant, ariac_common::Part(color, part_type));
+            }
+            order->SetKittingTask(std::make_shared<ariac_common::KittingTask>(agv, tray_id, destination, products));
+        }
+        else if (type == ariac_msgs::msg::Order::ASSEMBLY)
+        {
+            uint32_t station, count;
+            if (!_payload.U32(station) || !_payload.U32(count))
+                return nullptr;
+
+            std::vector<unsigned int> agvs;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t agv;
+                if (!_payload.U32(agv))
+                    return nullptr;
+                agvs.push_back(agv);
+            }
+
+            std::vector<ariac_common::AssemblyPart> products;
+            if (!ReadAssemblyProducts(_payload, products))
+                return nullptr;
+            order->SetAssemblyTask(std::make_shared<ariac_common::AssemblyTask>(agvs, station, products));
+        }
+        else if (type == ariac_msgs::msg::Order::COMBINED)
+        {
+            uint32_t station;
+            std::vector<ariac_common::AssemblyPart> products;
+            if (!_payload.U32(station) || !ReadAssemblyProducts(_payload, products))
+                return nullptr;
+            order->SetCombinedTask(std::make_shared<ariac_common::CombinedTask>(station, products));
+        }
+
+        return order;
+    }
+
+    //==============================================================================
+    bool ReadFaultyPartChallenge(PayloadReader &_payload, ariac_msgs::msg::FaultyPartChallenge &_challenge)
+    {
+        uint32_t q1, q2, q3, q4;
+        if (!_payload.String(_challenge.order_id) || !_payload.U32(q1) || !_payload.U32(q2) ||
+            !_payload.U32(q3) || !_payload.U32(q4))
+            return false;
+
+        _challenge.quadrant1 = q1 != 0;
+        _challenge.quadrant2 = q2 != 0;
+        _challenge.quadrant3 = q3 != 0;
+        _challenge.quadrant4 = q4 != 0;
+        return true;
+    }
+
+    //==============================================================================
+    bool ReadTrialConfig(PayloadReader &_payload, ariac_msgs::msg::Trial &_trial)
+    {
+        uint32_t count;
+        if (!_payload.U32(count))
+            return false;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ariac_msgs::msg::OrderCondition order;
+            uint32_t type;
+            if (!_payload.String(order.id) || !_payload.U32(type) || !ReadCondition(_payload, order.condition))
+                return false;
+            order.type = type;
+            _trial.order_conditions.push_back(order);
+        }
+
+        if (!_payload.U32(count))
+            return false;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ariac_msgs::msg::Challenge challenge;
+            uint32_t type;
+            if (!_payload.U32(type))
+                return false;
+            challenge.type = type;
+
+            auto condition = ChallengeCondition(challenge);
+            if (!condition || !ReadCondition(_payload, *condition))
+                return false;
+            _trial.challenges.push_back(challenge);
+        }
+        return true;
+    }
+
+} // namespace ariac_capture
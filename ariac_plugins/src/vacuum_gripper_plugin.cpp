@@ -19,6 +19,8 @@
 #include <ariac_msgs/msg/trial.hpp>
 
 #include <ariac_plugins/ariac_common.hpp>
+#include <ariac_plugins/model_name_classifier.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 
 #include <geometry_msgs/msg/point.hpp>
 #include <std_srvs/srv/trigger.hpp>
@@ -64,9 +66,6 @@ namespace ariac_plugins
     gazebo::physics::CollisionPtr model_collision_;
     std::map<std::string, gazebo::physics::CollisionPtr> collisions_;
 
-    std::vector<std::string> pickable_part_types_ = {"battery", "regulator", "pump", "sensor"};
-    std::vector<std::string> pickable_part_colors_ = {"red", "orange", "green", "blue", "purple"};
-
     rclcpp::Time last_publish_time_;
     int update_ns_;
     bool first_publish_;
@@ -82,6 +81,9 @@ namespace ariac_plugins
     // Subscriptions
     rclcpp::Subscription<ariac_msgs::msg::Trial>::SharedPtr trial_config_sub_;
 
+    /// Latency of OnUpdate, shared by all the grippers
+    ariac_common::LatencyHistogram *update_timing_{nullptr};
+
     void OnUpdate();
 
     void OnTrialCallback(const ariac_msgs::msg::Trial::SharedPtr _msg);
@@ -173,6 +175,7 @@ namespace ariac_plugins
             &VacuumGripperPluginPrivate::ChangeGripper, impl_.get(),
             std::placeholders::_1, std::placeholders::_2));
 
+    impl_->update_timing_ = ariac_common::TimingRegistry::Instance().Histogram("VacuumGripperPlugin", "OnUpdate");
     impl_->update_connection_ = gazebo::event::Events::ConnectWorldUpdateBegin(
         std::bind(&VacuumGripperPluginPrivate::OnUpdate, impl_.get()));
   }
@@ -193,6 +196,7 @@ namespace ariac_plugins
 
   void VacuumGripperPluginPrivate::OnUpdate()
   {
+    ariac_common::ScopedTimer timer(update_timing_);
     if (current_gripper_type_ == ariac_msgs::srv::ChangeGripper::Request::PART_GRIPPER)
     {
       // If gripper is enabled and in contact with gripable model attach joint
@@ -332,33 +336,18 @@ namespace ariac_plugins
 
       if (contact_type == "part")
       {
-        // Check if part is in the pickable_list
-        bool is_part = false;
-
-        for (auto &type : pickable_part_types_)
-        {
-          if (model_in_contact.find(type) != std::string::npos)
-          {
-            for (auto &color : pickable_part_colors_)
-            {
-              if (model_in_contact.find(color) != std::string::npos)
-              {
-                is_part = true;
-                part_in_contact_ = color + "_" + type;
-                break;
-              }
-            }
-          }
-        }
-        // Ignore contact otherwise
-        if (!is_part)
+        // Check if the model is a pickable part, ignore contact otherwise
+        const auto info = ariac_common::ClassifyModelName(model_in_contact);
+        if (!info.IsPart())
         {
           continue;
         }
+        part_in_contact_ = ariac_common::ConvertPartColorToString(info.color) + "_" +
+                           ariac_common::ConvertPartTypeToString(info.type);
       }
       else if (contact_type == "tray")
       {
-        if (model_in_contact.find("kit_tray") == std::string::npos)
+        if (!ariac_common::ClassifyModelName(model_in_contact).IsKitTray())
         {
           continue;
         }
@@ -0,0 +1,79 @@
+/*
+This software was developed by employees of the National Institute of Standards and Technology (NIST), an agency of the Federal Government. Pursuant to title 17 United States Code Section 105, works of NIST employees are not subject to copyright protection in the United States and are considered to be in the public domain. Permission to freely use, copy, modify, and distribute this software and its documentation without fee is hereby granted, provided that this notice and disclaimer of warranty appears in all copies.
+
+The software is provided 'as is' without any warranty of any kind, either expressed, implied, or statutory, including, but not limited to, any warranty that the software will conform to specifications, any implied warranties of merchantability, fitness for a particular purpose, and freedom from infringement, and any warranty that the documentation will conform to the software, or any warranty that the software will be error free. In no event shall NIST be liable for any damages, including, but not limited to, direct, indirect, special or consequential damages, arising out of, resulting from, or in any way connected with this software, whether or not based upon warranty, contract, tort, or otherwise, whether or not injury was sustained by persons or property or otherwise, and whether or not loss was sustained from, or arose out of the results of, or use of, the software or services provided hereunder.
+
+Distributions of NIST software should also include copyright and licensing statements of any third-party software that are legally bundled with the code in compliance with the conditions of those licenses.
+*/
+
+#include <ariac_plugins/worker_pool.hpp>
+
+// C++
+#include <algorithm>
+
+namespace ariac_scoring
+{
+    //==============================================================================
+    WorkerPool::WorkerPool(unsigned int _threads)
+    {
+        for (unsigned int i = 0; i < std::max(_threads, 1u); i++)
+            threads_.emplace_back(&WorkerPool::Run, this);
+    }
+
+    //==============================================================================
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto &thread : threads_)
+            thread.join();
+    }
+
+    //==============================================================================
+    void WorkerPool::Post(std::function<void()> _task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            tasks_.push_back(std::move(_task));
+        }
+        wake_.notify_one();
+    }
+
+    //==============================================================================
+    void WorkerPool::Wait()
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        idle_.wait(lock, [this]
+                   { return tasks_.empty() && busy_ == 0; });
+    }
+
+    //==============================================================================
+    void WorkerPool::Run()
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        while (true)
+        {
+            wake_.wait(lock, [this]
+                       { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty())
+                return;
+
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            busy_++;
+
+            lock.unlock();
+            task();
+            lock.lock();
+
+            busy_--;
+            if (tasks_.empty() && busy_ == 0)
+                idle_.notify_all();
+        }
+    }
+
+} // namespace ariac_scoring
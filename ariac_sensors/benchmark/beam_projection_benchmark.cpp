@@ -0,0 +1,126 @@
+// Compares the beam projection kernels used by AriacRayPlugin for PointCloud2
+// output against a per-scan conversion like the one behind PointCloud output.
+//
+// Usage: beam_projection_benchmark [iterations]
+
+#include <ariac_sensors/beam_projection.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr float kMinRange = 0.2f;
+constexpr float kMaxRange = 1.8f;
+
+struct Point32
+{
+  float x;
+  float y;
+  float z;
+};
+
+// Trigonometry per beam and a new point vector per scan, skipping invalid ranges
+std::vector<Point32> ConvertPerScan(
+  const std::vector<double> & _ranges, uint32_t _width, uint32_t _height,
+  double _angle_min, double _angle_max, double _vertical_min, double _vertical_max)
+{
+  std::vector<Point32> points;
+  double yaw_step = (_angle_max - _angle_min) / (_width - 1);
+  double pitch_step = (_vertical_max - _vertical_min) / (_height - 1);
+
+  for (uint32_t j = 0; j < _height; j++) {
+    double pitch = _vertical_min + j * pitch_step;
+    for (uint32_t i = 0; i < _width; i++) {
+      double yaw = _angle_min + i * yaw_step;
+      double r = _ranges[i + j * _width];
+      if (kMinRange < r && r < kMaxRange) {
+        points.push_back({
+          static_cast<float>(r * std::cos(pitch) * std::cos(yaw)),
+          static_cast<float>(r * std::cos(pitch) * std::sin(yaw)),
+          static_cast<float>(r * std::sin(pitch))});
+      }
+    }
+  }
+  return points;
+}
+
+double TimeMicroseconds(int _iterations, const std::function<void()> & _run)
+{
+  _run();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < _iterations; i++) {
+    _run();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() / _iterations;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+  if (iterations <= 0) {
+    iterations = 200;
+  }
+
+  std::printf("dispatch: %s, iterations: %d\n", ariac_sensors::ProjectRangesImplementation(), iterations);
+  std::printf("%-10s %12s %12s %12s\n", "scan", "convert [us]", "scalar [us]", "dispatch [us]");
+
+  // The shipped lidar model, then denser scans
+  const uint32_t resolutions[][2] = {{50, 50}, {360, 16}, {1024, 64}};
+  bool all_match = true;
+
+  for (const auto & resolution : resolutions) {
+    const uint32_t width = resolution[0];
+    const uint32_t height = resolution[1];
+    const std::size_t count = static_cast<std::size_t>(width) * height;
+
+    auto beams = ariac_sensors::ComputeBeamDirections(-0.75, 0.75, width, -0.55, 0.55, height);
+
+    // Mix of hits, too close returns and misses
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> distribution(0.0, 2.0);
+    std::vector<double> ranges(count);
+    std::vector<double> intensities(count);
+    for (std::size_t i = 0; i < count; i++) {
+      ranges[i] = (i % 13 == 0) ? std::numeric_limits<double>::infinity() : distribution(rng);
+      intensities[i] = distribution(rng);
+    }
+
+    std::vector<float> scalar(4 * count);
+    std::vector<float> dispatched(4 * count);
+
+    double convert_us = TimeMicroseconds(iterations, [&]() {
+      auto points = ConvertPerScan(ranges, width, height, -0.75, 0.75, -0.55, 0.55);
+      if (points.empty()) {
+        std::abort();
+      }
+    });
+    double scalar_us = TimeMicroseconds(iterations, [&]() {
+      ariac_sensors::ProjectRangesScalar(
+        beams, ranges.data(), intensities.data(), scalar.data(), kMinRange, kMaxRange);
+    });
+    double dispatch_us = TimeMicroseconds(iterations, [&]() {
+      ariac_sensors::ProjectRanges(
+        beams, ranges.data(), intensities.data(), dispatched.data(), kMinRange, kMaxRange);
+    });
+
+    bool match = std::memcmp(scalar.data(), dispatched.data(), scalar.size() * sizeof(float)) == 0;
+    all_match = all_match && match;
+
+    std::printf("%4ux%-5u %12.1f %12.1f %12.1f%s\n", width, height,
+      convert_us, scalar_us, dispatch_us, match ? "" : "  MISMATCH");
+  }
+
+  return all_match ? 0 : 1;
+}
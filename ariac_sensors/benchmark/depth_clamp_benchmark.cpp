@@ -0,0 +1,113 @@
+// Compares the depth clamping kernels used by AriacCameraPlugin::OnNewDepthFrame
+// against the original per-pixel memcpy loop.
+//
+// Usage: depth_clamp_benchmark [iterations]
+
+#include <ariac_sensors/depth_clamp.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr float kMinDepth = 0.4f;
+constexpr float kMaxDepth = 10.0f;
+
+// Loop used by OnNewDepthFrame before the kernels were introduced
+void ClampDepthMemcpy(
+  const float * _src, uint8_t * _dst, uint32_t _width, uint32_t _height,
+  double _min_depth, double _max_depth)
+{
+  float pos_inf = std::numeric_limits<float>::infinity();
+  float neg_inf = -pos_inf;
+
+  for (uint32_t j = 0; j < _height; j++) {
+    for (uint32_t i = 0; i < _width; i++) {
+      int index = i + j * _width;
+      float depth = _src[index];
+      if (_min_depth < depth && depth < _max_depth) {
+        std::memcpy(&_dst[index * sizeof(float)], &depth, sizeof(float));
+      } else if (depth <= _min_depth) {
+        std::memcpy(&_dst[index * sizeof(float)], &neg_inf, sizeof(float));
+      } else {
+        std::memcpy(&_dst[index * sizeof(float)], &pos_inf, sizeof(float));
+      }
+    }
+  }
+}
+
+double TimeMicroseconds(int _iterations, const std::function<void()> & _run)
+{
+  _run();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < _iterations; i++) {
+    _run();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() / _iterations;
+}
+
+bool SameBits(const std::vector<uint8_t> & _a, const std::vector<float> & _b)
+{
+  return std::memcmp(_a.data(), _b.data(), _a.size()) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+  if (iterations <= 0) {
+    iterations = 200;
+  }
+
+  std::printf("dispatch: %s, iterations: %d\n", ariac_sensors::ClampDepthImplementation(), iterations);
+  std::printf("%-10s %12s %12s %12s\n", "frame", "memcpy [us]", "scalar [us]", "dispatch [us]");
+
+  const uint32_t resolutions[][2] = {{640, 480}, {1280, 720}};
+  bool all_match = true;
+
+  for (const auto & resolution : resolutions) {
+    const uint32_t width = resolution[0];
+    const uint32_t height = resolution[1];
+    const std::size_t count = static_cast<std::size_t>(width) * height;
+
+    // Mix of in range, too close, too far and missing returns
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> distribution(0.0f, 12.0f);
+    std::vector<float> src(count);
+    for (std::size_t i = 0; i < count; i++) {
+      src[i] = (i % 97 == 0) ? std::numeric_limits<float>::quiet_NaN() : distribution(rng);
+    }
+
+    std::vector<uint8_t> legacy(count * sizeof(float));
+    std::vector<float> scalar(count);
+    std::vector<float> dispatched(count);
+
+    double legacy_us = TimeMicroseconds(iterations, [&]() {
+      ClampDepthMemcpy(src.data(), legacy.data(), width, height, kMinDepth, kMaxDepth);
+    });
+    double scalar_us = TimeMicroseconds(iterations, [&]() {
+      ariac_sensors::ClampDepthScalar(src.data(), scalar.data(), count, kMinDepth, kMaxDepth);
+    });
+    double dispatch_us = TimeMicroseconds(iterations, [&]() {
+      ariac_sensors::ClampDepth(src.data(), dispatched.data(), count, kMinDepth, kMaxDepth);
+    });
+
+    bool match = SameBits(legacy, scalar) && SameBits(legacy, dispatched);
+    all_match = all_match && match;
+
+    std::printf("%4ux%-5u %12.1f %12.1f %12.1f%s\n", width, height,
+      legacy_us, scalar_us, dispatch_us, match ? "" : "  MISMATCH");
+  }
+
+  return all_match ? 0 : 1;
+}
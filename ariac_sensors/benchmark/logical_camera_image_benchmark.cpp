@@ -0,0 +1,157 @@
+// Counts the allocations and time of one AriacLogicalCameraPlugin update, comparing
+// FillAdvancedImage with the temporary vectors and copies it replaced.
+//
+// Usage: logical_camera_image_benchmark [iterations]
+
+#include <ariac_sensors/logical_camera_image.hpp>
+
+#include <gazebo/msgs/msgs.hh>
+
+#include <gazebo_ros/conversions/geometry_msgs.hpp>
+
+#include <ariac_plugins/model_name_classifier.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::atomic<std::size_t> g_allocations{0};
+
+}  // namespace
+
+void * operator new(std::size_t _size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void * ptr = std::malloc(_size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * _ptr) noexcept
+{
+  std::free(_ptr);
+}
+
+void operator delete(void * _ptr, std::size_t) noexcept
+{
+  std::free(_ptr);
+}
+
+namespace
+{
+
+// Update loop used by OnUpdate before FillAdvancedImage
+void FillWithTemporaries(
+  const gazebo::msgs::LogicalCameraImage & _image,
+  ariac_msgs::msg::AdvancedLogicalCameraImage & _msg)
+{
+  geometry_msgs::msg::Pose sensor_pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(
+    gazebo::msgs::ConvertIgn(_image.pose()));
+
+  std::vector<ariac_msgs::msg::PartPose> parts;
+  std::vector<ariac_msgs::msg::KitTrayPose> trays;
+
+  for (int i = 0; i < _image.model_size(); i++) {
+    const auto & lc_model = _image.model(i);
+    const auto info = ariac_common::ClassifyModelName(lc_model.name());
+
+    if (info.IsKitTray()) {
+      ariac_msgs::msg::KitTrayPose kit_tray;
+      kit_tray.id = info.tray_id;
+      kit_tray.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(
+        gazebo::msgs::ConvertIgn(lc_model.pose()));
+      trays.push_back(kit_tray);
+      continue;
+    }
+
+    if (info.IsPart()) {
+      ariac_msgs::msg::PartPose part;
+      part.part.type = info.type;
+      part.part.color = info.color;
+      part.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(
+        gazebo::msgs::ConvertIgn(lc_model.pose()));
+      parts.push_back(part);
+    }
+  }
+
+  _msg.sensor_pose = sensor_pose;
+  _msg.part_poses = parts;
+  _msg.tray_poses = trays;
+}
+
+gazebo::msgs::LogicalCameraImage MakeImage(int _parts, int _trays)
+{
+  static const char * names[] = {"battery_red", "pump_green", "regulator_blue", "sensor_orange"};
+
+  gazebo::msgs::LogicalCameraImage image;
+  gazebo::msgs::Set(image.mutable_pose(), ignition::math::Pose3d(0, 0, 2, 0, 1.57, 0));
+  for (int i = 0; i < _parts; i++) {
+    auto * model = image.add_model();
+    model->set_name(std::string(names[i % 4]) + "_" + std::to_string(i));
+    gazebo::msgs::Set(model->mutable_pose(), ignition::math::Pose3d(0.1 * i, 0.2, 0.8, 0, 0, 0.3));
+  }
+  for (int i = 0; i < _trays; i++) {
+    auto * model = image.add_model();
+    model->set_name("kit_tray_0" + std::to_string(i) + "_" + std::to_string(i));
+    gazebo::msgs::Set(model->mutable_pose(), ignition::math::Pose3d(1.0, 0.1 * i, 0.7, 0, 0, 0));
+  }
+  return image;
+}
+
+// Allocations of one steady state update and its time in microseconds
+void Measure(
+  int _iterations, const std::function<void()> & _run,
+  double & _allocations, double & _microseconds)
+{
+  _run();
+  std::size_t before = g_allocations.load();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < _iterations; i++) {
+    _run();
+  }
+  auto end = std::chrono::steady_clock::now();
+  _allocations = static_cast<double>(g_allocations.load() - before) / _iterations;
+  _microseconds = std::chrono::duration<double, std::micro>(end - start).count() / _iterations;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 10000;
+  if (iterations <= 0) {
+    iterations = 10000;
+  }
+
+  std::printf("iterations: %d\n", iterations);
+  std::printf("%-8s %14s %14s %14s %14s\n",
+    "models", "old [allocs]", "old [us]", "fill [allocs]", "fill [us]");
+
+  bool steady_state_allocates = false;
+  const int sizes[][2] = {{4, 1}, {18, 2}, {72, 4}};
+
+  for (const auto & size : sizes) {
+    auto image = MakeImage(size[0], size[1]);
+    ariac_msgs::msg::AdvancedLogicalCameraImage legacy_msg;
+    ariac_msgs::msg::AdvancedLogicalCameraImage msg;
+
+    double legacy_allocations, legacy_us, allocations, us;
+    Measure(iterations, [&]() {FillWithTemporaries(image, legacy_msg);}, legacy_allocations, legacy_us);
+    Measure(iterations, [&]() {ariac_sensors::FillAdvancedImage(image, msg);}, allocations, us);
+
+    steady_state_allocates = steady_state_allocates || allocations > 0.0;
+    std::printf("%-8d %14.1f %14.2f %14.1f %14.2f\n",
+      size[0] + size[1], legacy_allocations, legacy_us, allocations, us);
+  }
+
+  return steady_state_allocates ? 1 : 0;
+}
@@ -2,7 +2,6 @@
 #define ARIAC_LOGICAL_CAMERA_PLUGIN_HPP_
 
 #include <gazebo/common/Plugin.hh>
-#include <ariac_msgs/msg/sensors.hpp>
 
 #include <memory>
 
@@ -23,8 +22,6 @@ public:
   // Documentation Inherited
   void Load(gazebo::sensors::SensorPtr _sensor, sdf::ElementPtr _sdf) override;
 
-  void SensorHealthCallback(const ariac_msgs::msg::Sensors::SharedPtr msg);
-
 private:
   /// Private data pointer
   std::unique_ptr<AriacLogicalCameraPluginPrivate> impl_;
@@ -2,7 +2,6 @@
 #define ARIAC_RAY_PLUGIN_HPP_
 
 #include <gazebo/common/Plugin.hh>
-#include <ariac_msgs/msg/sensors.hpp>
 
 #include <memory>
 
@@ -24,8 +23,6 @@ public:
   // Documentation Inherited
   void Load(gazebo::sensors::SensorPtr _parent, sdf::ElementPtr _sdf);
 
-  void SensorHealthCallback(const ariac_msgs::msg::Sensors::SharedPtr msg);
-
 private:
   std::unique_ptr<AriacRayPluginPrivate> impl_;
 };
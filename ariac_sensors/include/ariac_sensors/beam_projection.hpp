@@ -0,0 +1,60 @@
+#ifndef BEAM_PROJECTION_HPP_
+#define BEAM_PROJECTION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ariac_sensors
+{
+
+/// \brief Unit direction of every beam of a ray sensor, one array per axis
+///
+/// Beams are ordered like the ranges of a gazebo laser scan, horizontal index first.
+struct BeamDirections
+{
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+
+  /// Number of beams in a row, the width of an organized point cloud
+  uint32_t horizontal_count{0};
+
+  /// Number of rows, the height of an organized point cloud
+  uint32_t vertical_count{0};
+
+  std::size_t Size() const {return x.size();}
+};
+
+/// \brief Compute the beam directions of a scan, spacing the beams evenly between the angle limits
+BeamDirections ComputeBeamDirections(
+  double _angle_min, double _angle_max, uint32_t _horizontal_count,
+  double _vertical_angle_min, double _vertical_angle_max, uint32_t _vertical_count);
+
+/// \brief Convert the ranges of a scan to packed XYZI float points
+///
+/// Each point takes four floats (x, y, z, intensity). Ranges strictly between
+/// _min_range and _max_range give the point along their beam, any other range
+/// (including inf and NaN) gives NaN coordinates so the cloud keeps its layout.
+/// Uses AVX2 or SSE2 when the CPU supports it, selected once at runtime.
+/// \param[in] _beams Beam directions, one per range
+/// \param[in] _ranges Ranges from the sensor
+/// \param[in] _intensities Intensities from the sensor, nullptr writes 0
+/// \param[out] _points Output buffer of 4 * _beams.Size() floats
+/// \param[in] _min_range Minimum valid range
+/// \param[in] _max_range Maximum valid range
+void ProjectRanges(
+  const BeamDirections & _beams, const double * _ranges, const double * _intensities,
+  float * _points, float _min_range, float _max_range);
+
+/// \brief Portable version of ProjectRanges, one beam at a time
+void ProjectRangesScalar(
+  const BeamDirections & _beams, const double * _ranges, const double * _intensities,
+  float * _points, float _min_range, float _max_range);
+
+/// \brief Name of the implementation ProjectRanges dispatches to ("avx2", "sse2" or "scalar")
+const char * ProjectRangesImplementation();
+
+}  // namespace ariac_sensors
+
+#endif  // BEAM_PROJECTION_HPP_
@@ -0,0 +1,33 @@
+#ifndef DEPTH_CLAMP_HPP_
+#define DEPTH_CLAMP_HPP_
+
+#include <cstddef>
+
+namespace ariac_sensors
+{
+
+/// \brief Clamp depth values to the sensor range
+///
+/// Values strictly between _min_depth and _max_depth are copied, values at or
+/// below _min_depth become -inf and everything else (including NaN) becomes +inf.
+/// Uses AVX2 or SSE2 when the CPU supports it, selected once at runtime.
+/// \param[in] _src Depth values from the sensor
+/// \param[out] _dst Output buffer, may alias _src
+/// \param[in] _count Number of values
+/// \param[in] _min_depth Minimum valid depth
+/// \param[in] _max_depth Maximum valid depth
+void ClampDepth(
+  const float * _src, float * _dst, std::size_t _count,
+  float _min_depth, float _max_depth);
+
+/// \brief Portable version of ClampDepth, one value at a time
+void ClampDepthScalar(
+  const float * _src, float * _dst, std::size_t _count,
+  float _min_depth, float _max_depth);
+
+/// \brief Name of the implementation ClampDepth dispatches to ("avx2", "sse2" or "scalar")
+const char * ClampDepthImplementation();
+
+}  // namespace ariac_sensors
+
+#endif  // DEPTH_CLAMP_HPP_
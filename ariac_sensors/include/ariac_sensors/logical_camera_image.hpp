@@ -0,0 +1,31 @@
+#ifndef LOGICAL_CAMERA_IMAGE_HPP_
+#define LOGICAL_CAMERA_IMAGE_HPP_
+
+#include <gazebo/msgs/logical_camera_image.pb.h>
+
+#include <ariac_msgs/msg/advanced_logical_camera_image.hpp>
+#include <ariac_msgs/msg/basic_logical_camera_image.hpp>
+
+namespace ariac_sensors
+{
+
+/// \brief Fill an advanced logical camera message from a gazebo logical camera image
+///
+/// The pose arrays are cleared and refilled in place, so once their capacity
+/// covers the number of models in view no memory is allocated.
+/// \param[in] _image Image from the gazebo sensor
+/// \param[out] _msg Message to fill, reused between updates
+void FillAdvancedImage(
+  const gazebo::msgs::LogicalCameraImage & _image,
+  ariac_msgs::msg::AdvancedLogicalCameraImage & _msg);
+
+/// \brief Fill a basic logical camera message from a gazebo logical camera image
+///
+/// Same as FillAdvancedImage, without the part types, colors and tray ids.
+void FillBasicImage(
+  const gazebo::msgs::LogicalCameraImage & _image,
+  ariac_msgs::msg::BasicLogicalCameraImage & _msg);
+
+}  // namespace ariac_sensors
+
+#endif  // LOGICAL_CAMERA_IMAGE_HPP_
@@ -23,12 +23,21 @@
 #include <ariac_msgs/msg/kitting_part.hpp>
 #include <ariac_msgs/msg/parts.hpp>
 
+#include <ariac_plugins/model_name_classifier.hpp>
+#include <ariac_plugins/timing_registry.hpp>
+
 #include <tf2_kdl/tf2_kdl.h>
 #include <tf2/convert.h>
 #include <kdl/frames.hpp>
 
+#include <functional>
+#include <limits>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
 
 namespace ariac_sensors
 {
@@ -36,6 +45,7 @@ namespace ariac_sensors
 struct TrayParts{
   std::map<int, ariac_msgs::msg::PartPose> parts;
   std::map<int, std::string> part_names;
+  std::map<int, bool> flipped;
 };
 
 class AGVTraySensorPluginPrivate
@@ -50,9 +60,6 @@ public:
 
   std::string sensor_num_;
 
-  std::map<std::string, int> part_types_;
-  std::map<std::string, int> part_colors_;
-
   /// Lists of parts and trays
   std::map<std::string, ariac_msgs::msg::PartPose> detected_parts_;
   ariac_msgs::msg::KitTrayPose kit_tray_;
@@ -73,6 +80,28 @@ public:
   // Trial msg subscriber
   rclcpp::Subscription<ariac_msgs::msg::Trial>::SharedPtr trial_sub_;
 
+  /// Latency of OnUpdate, shared by all the tray sensors
+  ariac_common::LatencyHistogram * update_timing_{nullptr};
+
+  /// Guards the image state and the quality check cache, written by OnUpdate and read by the services
+  std::mutex lock_;
+
+  /// Number of images received, the tray layout is computed at most once per image
+  uint64_t image_count_{0};
+  uint64_t layout_image_{std::numeric_limits<uint64_t>::max()};
+  TrayParts tray_layout_;
+
+  /// Incremented when the tray layout differs from the previous one
+  uint64_t layout_generation_{0};
+
+  /// What a quality check read from the previous layout: the tray id, then per part its
+  /// name, quadrant, type, color and whether it is flipped
+  int layout_tray_id_{0};
+  std::vector<std::tuple<std::string, int, int, int, bool>> layout_parts_;
+
+  /// Quality check responses by order id, with the layout generation they were computed for
+  std::map<std::string, std::pair<uint64_t, ariac_msgs::srv::PerformQualityCheck::Response>> quality_checks_;
+
   void TrialConfigCallback(const ariac_msgs::msg::Trial::SharedPtr msg);
 
   /// Publish latest logical camera data to ROS
@@ -83,6 +112,12 @@ public:
     ariac_msgs::srv::PerformQualityCheck::Response::SharedPtr
   );
 
+  /// Quality check of an order against the current tray layout, PerformQualityCheck caches the result
+  void ComputeQualityCheck(
+    ariac_msgs::srv::PerformQualityCheck::Request::SharedPtr,
+    ariac_msgs::srv::PerformQualityCheck::Response::SharedPtr
+  );
+
   void ScoreTask(
     ariac_msgs::srv::ScoreTask::Request::SharedPtr,
     ariac_msgs::srv::ScoreTask::Response::SharedPtr
@@ -90,7 +125,8 @@ public:
 
   ariac_msgs::msg::QualityIssue CheckQuadrantQuality(std::string, ariac_msgs::msg::KittingPart);
 
-  TrayParts LocatePartsOnTray();
+  /// Parts on the tray by quadrant, computed once per image. Requires lock_
+  const TrayParts & LocatePartsOnTray();
   
   bool CheckFlipped(
     ariac_msgs::msg::KitTrayPose tray_pose, 
@@ -117,9 +153,6 @@ void AGVTraySensorPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::ElementP
     impl_->sensor_num_ = _sdf->Get<std::string>("sensor_num");
   }
 
-  impl_->part_types_ = {{"battery", 10}, {"pump", 11}, {"sensor", 12}, {"regulator", 13}}; 
-  impl_->part_colors_ = {{"red", 0}, {"green", 1}, {"blue", 2}, {"orange", 3}, {"purple", 4}};
-
   // Create services
   impl_->quality_check_service_ = impl_->ros_node_->create_service<ariac_msgs::srv::PerformQualityCheck>(
   "/ariac/perform_quality_check_agv" + impl_->sensor_num_, 
@@ -141,14 +174,21 @@ void AGVTraySensorPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::ElementP
   impl_->trial_sub_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::Trial>("/ariac/trial_config", 10, 
     std::bind(&AGVTraySensorPluginPrivate::TrialConfigCallback, this->impl_.get(), std::placeholders::_1));
 
+  impl_->update_timing_ = ariac_common::TimingRegistry::Instance().Histogram(
+    "AGVTraySensorPlugin", "OnUpdate");
   impl_->sensor_update_event_ = impl_->sensor_->ConnectUpdated(
     std::bind(&AGVTraySensorPluginPrivate::OnUpdate, this->impl_.get()));
 }
 
 void AGVTraySensorPluginPrivate::OnUpdate()
 {
+  ariac_common::ScopedTimer timer(update_timing_);
+
   const auto & image = sensor_->Image();
 
+  std::unique_lock<std::mutex> lock(lock_);
+  image_count_++;
+
   sensor_pose_ = gazebo_ros::Convert<geometry_msgs::msg::Pose>(
     gazebo::msgs::ConvertIgn(image.pose()));
 
@@ -158,43 +198,48 @@ void AGVTraySensorPluginPrivate::OnUpdate()
   for (int i = 0; i < image.model_size(); i++) {
     const auto & lc_model = image.model(i);
 
-    std::string model_name = lc_model.name();
+    const auto info = ariac_common::ClassifyModelName(lc_model.name());
 
-    // name of kit tray model is "kit_tray_XX_YY" where XX indicates 
-    // the marker_id for the tray
-    if (model_name.find("kit_tray") != std::string::npos){
-      std::string id_string = model_name.substr(9, 2);
-      kit_tray_.id = std::stoi(id_string);
+    if (info.IsKitTray()){
+      kit_tray_.id = info.tray_id;
       kit_tray_.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
     }
     
     // Check to see if model is a part 
-    for ( const auto &type : part_types_ ) {
+    if (info.IsPart()) {
       ariac_msgs::msg::PartPose part_pose;
-      
-      if (model_name.find(type.first) != std::string::npos) {
-        part_pose.part.type = type.second;
-
-        // Determine part color
-        for ( const auto &color : part_colors_ ) {
-          if (model_name.find(color.first) != std::string::npos) {
-            part_pose.part.color = color.second;
-
-            // Get pose 
-            part_pose.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
+      part_pose.part.type = info.type;
+      part_pose.part.color = info.color;
+      part_pose.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
 
-            detected_parts_.insert({model_name, part_pose});
-            tray_contents_msg_.parts.push_back(part_pose.part);
-          }
-        }
-      }
+      detected_parts_.insert({lc_model.name(), part_pose});
+      tray_contents_msg_.parts.push_back(part_pose.part);
     }
   }
+  lock.unlock();
 
   tray_contents_pub_->publish(tray_contents_msg_);
 }
 
 void AGVTraySensorPluginPrivate::PerformQualityCheck(
+  ariac_msgs::srv::PerformQualityCheck::Request::SharedPtr request,
+  ariac_msgs::srv::PerformQualityCheck::Response::SharedPtr response)
+{
+  std::lock_guard<std::mutex> lock(lock_);
+
+  // The result only depends on the order and the tray layout, so repeated checks are a lookup
+  LocatePartsOnTray();
+  auto cached = quality_checks_.find(request->order_id);
+  if (cached != quality_checks_.end() && cached->second.first == layout_generation_) {
+    *response = cached->second.second;
+    return;
+  }
+
+  ComputeQualityCheck(request, response);
+  quality_checks_[request->order_id] = {layout_generation_, *response};
+}
+
+void AGVTraySensorPluginPrivate::ComputeQualityCheck(
   ariac_msgs::srv::PerformQualityCheck::Request::SharedPtr request,
   ariac_msgs::srv::PerformQualityCheck::Response::SharedPtr response) 
 {
@@ -253,7 +298,9 @@ void AGVTraySensorPluginPrivate::PerformQualityCheck(
 
 void AGVTraySensorPluginPrivate::TrialConfigCallback(const ariac_msgs::msg::Trial::SharedPtr msg)
 {
+  std::lock_guard<std::mutex> lock(lock_);
   orders_ = msg->orders;
+  quality_checks_.clear();
 
   for (auto &challenge : msg->challenges) {
     if (challenge.type == ariac_msgs::msg::Challenge::FAULTY_PART)
@@ -274,10 +321,10 @@ ariac_msgs::msg::QualityIssue AGVTraySensorPluginPrivate::CheckQuadrantQuality(s
   ariac_msgs::msg::QualityIssue issue;
   issue.all_passed = true;
 
-  TrayParts parts_on_tray = LocatePartsOnTray();
+  const TrayParts & parts_on_tray = LocatePartsOnTray();
   
   //  see if a part is present in that quadrant
-  std::map<int, ariac_msgs::msg::PartPose>::iterator it = parts_on_tray.parts.find(part.quadrant);
+  auto it = parts_on_tray.parts.find(part.quadrant);
   if (it == parts_on_tray.parts.end()){
     issue.missing_part = true;
     issue.incorrect_part_type = true;
@@ -299,14 +346,14 @@ ariac_msgs::msg::QualityIssue AGVTraySensorPluginPrivate::CheckQuadrantQuality(s
   }
 
   //  check to see if the part is flipped
-  if (CheckFlipped(kit_tray_, it->second)) {
+  if (parts_on_tray.flipped.at(part.quadrant)) {
     issue.flipped_part = true;
     issue.all_passed = false;  
   }
 
   // Check order to see if the part should be reported faulty
   if (order_faulty_info_.find(order_id) != order_faulty_info_.end()) {
-    std::string part_name = parts_on_tray.part_names[part.quadrant];
+    std::string part_name = parts_on_tray.part_names.at(part.quadrant);
     if (order_faulty_info_[order_id][part.quadrant]){
       issue.faulty_part = true;
       issue.all_passed = false; 
@@ -314,7 +361,7 @@ ariac_msgs::msg::QualityIssue AGVTraySensorPluginPrivate::CheckQuadrantQuality(s
       // Rename part to faulty and set order faulty info to false
       gazebo::physics::get_world(sensor_->WorldName())->ModelByName(part_name)->SetName(part_name + "_faulty");
       order_faulty_info_[order_id][part.quadrant] = false;
-    } else if (part_name.find("faulty") != part_name.npos) {
+    } else if (ariac_common::ClassifyModelName(part_name).faulty) {
       // Part has not been replaced
       issue.faulty_part = true;
       issue.all_passed = false; 
@@ -325,8 +372,13 @@ ariac_msgs::msg::QualityIssue AGVTraySensorPluginPrivate::CheckQuadrantQuality(s
 
 }
 
-TrayParts AGVTraySensorPluginPrivate::LocatePartsOnTray()
-{ 
+const TrayParts & AGVTraySensorPluginPrivate::LocatePartsOnTray()
+{
+  if (layout_image_ == image_count_) {
+    return tray_layout_;
+  }
+  layout_image_ = image_count_;
+
   TrayParts parts_on_tray;
 
   // Convert tray pose to KDL frame
@@ -362,7 +414,26 @@ TrayParts AGVTraySensorPluginPrivate::LocatePartsOnTray()
     }
   }
 
-  return parts_on_tray;
+  // Everything a quality check reads from the layout is compared with the previous one
+  std::vector<std::tuple<std::string, int, int, int, bool>> layout_parts;
+  layout_parts.reserve(parts_on_tray.parts.size());
+  for (const auto & quadrant_part : parts_on_tray.parts) {
+    bool flipped = CheckFlipped(kit_tray_, quadrant_part.second);
+    parts_on_tray.flipped[quadrant_part.first] = flipped;
+
+    layout_parts.emplace_back(
+      parts_on_tray.part_names[quadrant_part.first], quadrant_part.first,
+      quadrant_part.second.part.type, quadrant_part.second.part.color, flipped);
+  }
+
+  tray_layout_ = std::move(parts_on_tray);
+  if (kit_tray_.id != layout_tray_id_ || layout_parts != layout_parts_) {
+    layout_tray_id_ = kit_tray_.id;
+    layout_parts_ = std::move(layout_parts);
+    layout_generation_++;
+  }
+
+  return tray_layout_;
 }
 
 bool AGVTraySensorPluginPrivate::CheckFlipped(
@@ -403,6 +474,8 @@ void AGVTraySensorPluginPrivate::ScoreTask(
   ariac_msgs::srv::ScoreTask::Request::SharedPtr request,
   ariac_msgs::srv::ScoreTask::Response::SharedPtr response)
 {
+  std::lock_guard<std::mutex> lock(lock_);
+
    // Check if order id is valid
 
   bool valid_id = false;
@@ -1,4 +1,7 @@
 #include <ariac_sensors/ariac_camera_plugin.hpp>
+#include <ariac_sensors/depth_clamp.hpp>
+#include <ariac_plugins/sensor_health_registry.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 
 #include <gazebo_ros/node.hpp>
 #include <gazebo_ros/utils.hpp>
@@ -17,9 +20,11 @@
 #include <sensor_msgs/fill_image.hpp>
 #include <sensor_msgs/image_encodings.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
 
 #include <string>
 #include <algorithm>
+#include <chrono>
 #include <limits>
 #include <memory>
 
@@ -36,6 +41,9 @@ public:
 
   std::string camera_type_;
 
+  /// Sensor this plugin is attached to, rendered only while its output is used
+  gazebo::sensors::SensorPtr sensor_;
+
   gazebo::sensors::CameraSensorPtr camera_parent_sensor_;
 
   gazebo::sensors::DepthCameraSensorPtr depth_parent_sensor_;
@@ -59,22 +67,36 @@ public:
   double min_depth_;
   double max_depth_;
 
+  /// Reused for every frame, so the buffers are only allocated when the image size changes
   sensor_msgs::msg::Image image_msg_;
+  sensor_msgs::msg::Image depth_image_msg_;
 
   rclcpp::Publisher<sensor_msgs::msg::CameraInfo>::SharedPtr camera_info_pub_;
 
-  rclcpp::Subscription<ariac_msgs::msg::Sensors>::SharedPtr sensor_health_sub_;
-
   std::shared_ptr<camera_info_manager::CameraInfoManager> camera_info_manager_;
 
   sensor_msgs::msg::CameraInfo camera_info_msg_;
 
   std::mutex image_mutex_;
 
-  bool publish_sensor_data_;
+  /// Periodically re-evaluates whether the sensor has to render
+  rclcpp::TimerBase::SharedPtr activity_timer_;
+
+  /// Latency of OnNewImageFrame and OnNewDepthFrame, shared by all the cameras
+  ariac_common::LatencyHistogram * image_frame_timing_{nullptr};
+  ariac_common::LatencyHistogram * depth_frame_timing_{nullptr};
 
   void FillCameraInfoMsg();
 
+  /// True if the camera sensor health is set
+  bool IsHealthy() const;
+
+  /// True if any of the camera topics has a subscriber
+  bool HasSubscribers() const;
+
+  /// Activate the sensor when it is healthy and has subscribers, deactivate it otherwise
+  void UpdateActivity();
+
 };
 
 AriacCameraPlugin::AriacCameraPlugin()
@@ -99,9 +121,7 @@ void AriacCameraPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::ElementPtr
 
   impl_->frame_name_ = gazebo_ros::SensorFrameID(*_sensor, *_sdf);
 
-  impl_->publish_sensor_data_ = true;
-  impl_->sensor_health_sub_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::Sensors>("/ariac/sensor_health", 10, 
-    std::bind(&AriacCameraPlugin::SensorHealthCallback, this, std::placeholders::_1));
+  impl_->sensor_ = _sensor;
 
   const std::string camera_topic = "ariac/sensors/" + impl_->camera_name_ + "/rgb_image";
 
@@ -124,8 +144,6 @@ void AriacCameraPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::ElementPtr
         std::placeholders::_4, std::placeholders::_5)
     );
 
-    impl_->camera_parent_sensor_->SetActive(true);
-
   } else if (impl_->camera_type_ == "rgbd")
   {
     impl_->depth_parent_sensor_ = std::dynamic_pointer_cast<gazebo::sensors::DepthCameraSensor>(_sensor);
@@ -152,8 +170,6 @@ void AriacCameraPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::ElementPtr
         std::placeholders::_4, std::placeholders::_5)
     );
 
-    impl_->depth_parent_sensor_->SetActive(true);
-
     const std::string depth_image_topic = "ariac/sensors/" + impl_->camera_name_ + "/depth_image";
 
     impl_->depth_image_pub_ = image_transport::create_publisher(
@@ -176,6 +192,15 @@ void AriacCameraPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::ElementPtr
   
   impl_->camera_info_manager_->setCameraInfo(impl_->camera_info_msg_);
 
+  auto & timing = ariac_common::TimingRegistry::Instance();
+  impl_->image_frame_timing_ = timing.Histogram("AriacCameraPlugin", "OnNewImageFrame");
+  impl_->depth_frame_timing_ = timing.Histogram("AriacCameraPlugin", "OnNewDepthFrame");
+
+  // Health changes and subscribers coming and going have no callback, so poll for them
+  impl_->UpdateActivity();
+  impl_->activity_timer_ = impl_->ros_node_->create_wall_timer(
+    std::chrono::milliseconds(500),
+    std::bind(&AriacCameraPluginPrivate::UpdateActivity, impl_.get()));
 }
 
 void AriacCameraPlugin::OnNewImageFrame(
@@ -183,6 +208,13 @@ void AriacCameraPlugin::OnNewImageFrame(
   unsigned int _width, unsigned int _height,
   unsigned int _depth, const std::string &_format)
 {
+  ariac_common::ScopedTimer timer(impl_->image_frame_timing_);
+
+  // Frames rendered before the sensor was deactivated are dropped
+  if (!impl_->IsHealthy()) {
+    return;
+  }
+
   std::lock_guard<std::mutex> image_lock(impl_->image_mutex_);
 
   gazebo::common::Time sensor_update_time;
@@ -192,14 +224,23 @@ void AriacCameraPlugin::OnNewImageFrame(
   } else if (impl_->camera_type_ == "rgbd") {
     sensor_update_time = impl_->depth_parent_sensor_->LastMeasurementTime();
   }
-  
-  auto camera_info_msg = impl_->camera_info_manager_->getCameraInfo();
 
-  camera_info_msg.header.stamp = gazebo_ros::Convert<builtin_interfaces::msg::Time>(sensor_update_time);
+  if (impl_->camera_info_pub_->get_subscription_count() > 0) {
+    auto camera_info_msg = impl_->camera_info_manager_->getCameraInfo();
+
+    camera_info_msg.header.stamp = gazebo_ros::Convert<builtin_interfaces::msg::Time>(sensor_update_time);
 
-  impl_->camera_info_pub_->publish(camera_info_msg);
+    impl_->camera_info_pub_->publish(camera_info_msg);
+  }
+
+  // An rgbd camera may only be rendering for its depth subscribers
+  if (impl_->image_pub_.getNumSubscribers() == 0) {
+    return;
+  }
 
   // Publish image
+  // The subscribers are all outside gzserver, so intra-process unique_ptr publishing would still
+  // serialize the frame, and image_transport only takes const references or shared pointers
   impl_->image_msg_.header.frame_id = impl_->frame_name_;
   impl_->image_msg_.header.stamp = gazebo_ros::Convert<builtin_interfaces::msg::Time>(
     sensor_update_time);
@@ -212,9 +253,7 @@ void AriacCameraPlugin::OnNewImageFrame(
     impl_->image_msg_, img_encoding_, _height, _width,
     img_step_ * _width, reinterpret_cast<const void *>(_image));
 
-  if (impl_->publish_sensor_data_) {
-    impl_->image_pub_.publish(impl_->image_msg_);
-  }
+  impl_->image_pub_.publish(impl_->image_msg_);
 }
 
 void AriacCameraPlugin::OnNewDepthFrame(
@@ -222,50 +261,64 @@ void AriacCameraPlugin::OnNewDepthFrame(
   unsigned int _width, unsigned int _height,
   unsigned int _depth, const std::string &_format)
 {
+  ariac_common::ScopedTimer timer(impl_->depth_frame_timing_);
+
+  if (!impl_->IsHealthy() || impl_->depth_image_pub_.getNumSubscribers() == 0) {
+    return;
+  }
+
   std::lock_guard<std::mutex> image_lock(impl_->image_mutex_);
 
   gazebo::common::Time sensor_update_time;
 
   sensor_update_time = impl_->depth_parent_sensor_->LastMeasurementTime();
 
-  sensor_msgs::msg::Image image_msg;
+  auto & image_msg = impl_->depth_image_msg_;
   image_msg.encoding = sensor_msgs::image_encodings::TYPE_32FC1;
   image_msg.header.frame_id = impl_->frame_name_;
   image_msg.header.stamp = gazebo_ros::Convert<builtin_interfaces::msg::Time>(sensor_update_time);
   image_msg.width = _width;
   image_msg.height = _height;
   image_msg.step = FLOAT_SIZE * _width;
+  // Only zero fills when the frame size changes, every pixel is overwritten below
   image_msg.data.resize(_width * _height * FLOAT_SIZE);
   image_msg.is_bigendian = 0;
 
-  int index = 0;
+  // Rows are contiguous, so the whole frame is clamped in one pass straight into the message buffer
+  ClampDepth(
+    _image, reinterpret_cast<float *>(image_msg.data.data()),
+    static_cast<size_t>(_width) * _height,
+    static_cast<float>(impl_->min_depth_), static_cast<float>(impl_->max_depth_));
 
-  float pos_inf = std::numeric_limits<float>::infinity();
-  float neg_inf = -pos_inf;
+  impl_->depth_image_pub_.publish(image_msg);
+}
 
-  // Copy from src to image_msg
-  for (uint32_t j = 0; j < _height; j++) {
-    for (uint32_t i = 0; i < _width; i++) {
-      index = i + j * _width;
-      float depth = _image[index];
-      if (impl_->min_depth_ < depth && depth < impl_->max_depth_) {
-        std::memcpy(&image_msg.data[index * FLOAT_SIZE], &depth, FLOAT_SIZE);
-      } else if (depth <= impl_->min_depth_) {
-        std::memcpy(&image_msg.data[index * FLOAT_SIZE], &neg_inf, FLOAT_SIZE);
-      } else {
-        std::memcpy(&image_msg.data[index * FLOAT_SIZE], &pos_inf, FLOAT_SIZE);
-      }
-    }
-  }
-  
-  if (impl_->publish_sensor_data_) {
-    impl_->depth_image_pub_.publish(image_msg);
+bool AriacCameraPluginPrivate::IsHealthy() const
+{
+  return ariac_common::SensorHealthRegistry::Instance().IsHealthy(
+    ariac_common::SensorHealthRegistry::CAMERA);
+}
+
+bool AriacCameraPluginPrivate::HasSubscribers() const
+{
+  if (image_pub_.getNumSubscribers() > 0 || camera_info_pub_->get_subscription_count() > 0) {
+    return true;
   }
-  
+
+  return camera_type_ == "rgbd" && depth_image_pub_.getNumSubscribers() > 0;
 }
 
-void AriacCameraPlugin::SensorHealthCallback(const ariac_msgs::msg::Sensors::SharedPtr msg){
-  impl_->publish_sensor_data_ = msg->camera;
+void AriacCameraPluginPrivate::UpdateActivity()
+{
+  // Load returned before the publishers were created
+  if (!camera_info_pub_) {
+    return;
+  }
+
+  bool active = IsHealthy() && HasSubscribers();
+  if (sensor_->IsActive() != active) {
+    sensor_->SetActive(active);
+  }
 }
 
 void AriacCameraPluginPrivate::FillCameraInfoMsg(){
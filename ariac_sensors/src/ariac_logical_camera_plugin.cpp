@@ -1,9 +1,9 @@
 #include <ariac_sensors/ariac_logical_camera_plugin.hpp>
+#include <ariac_sensors/logical_camera_image.hpp>
 
 #include <gazebo/sensors/LogicalCameraSensor.hh>
 
 #include <gazebo_ros/conversions/builtin_interfaces.hpp>
-#include <gazebo_ros/conversions/geometry_msgs.hpp>
 #include <gazebo_ros/node.hpp>
 #include <gazebo_ros/utils.hpp>
 
@@ -11,8 +11,20 @@
 #include <ariac_msgs/msg/advanced_logical_camera_image.hpp>
 #include <ariac_msgs/msg/part_pose.hpp>
 #include <ariac_msgs/msg/kit_tray_pose.hpp>
+#include <ariac_msgs/msg/logical_camera_delta.hpp>
 
+#include <ariac_plugins/model_name_classifier.hpp>
+#include <ariac_plugins/sensor_health_registry.hpp>
+#include <ariac_plugins/timing_registry.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ariac_sensors
 {
@@ -36,23 +48,74 @@ public:
   
   /// Event triggered when sensor updates
   gazebo::event::ConnectionPtr sensor_update_event_;
-  
-  /// List of models that the logical camera will publish
-  std::vector<std::string> parts_to_publish_;
-  std::vector<std::string> colors_;
 
   std::string camera_name_;
   std::string sensor_type_;
 
-  std::map<std::string, int> part_types_;
-  std::map<std::string, int> part_colors_;
+  /// TF frame the delta output is published in
+  std::string frame_name_;
+
+  /// Periodically re-evaluates whether the sensor has to update
+  rclcpp::TimerBase::SharedPtr activity_timer_;
+
+  /// Latency of OnUpdate, shared by all the logical cameras
+  ariac_common::LatencyHistogram * update_timing_{nullptr};
+
+  /// Publishes only the changes of the advanced image
+  rclcpp::Publisher<ariac_msgs::msg::LogicalCameraDelta>::SharedPtr delta_pub_;
+
+  /// Skip publishing images identical to the previous one, apart from the heartbeat
+  bool publish_on_change_{false};
+
+  /// Sim time period of the full image when nothing changes
+  double heartbeat_period_{1.0};
+  double next_heartbeat_time_{0.0};
+
+  /// Pose changes below these steps do not count as a change
+  double position_resolution_{0.001};
+  double orientation_resolution_{0.001};
 
-  /// Sensor Health Subscription
-  ariac_msgs::msg::Sensors sensor_health_;
-  rclcpp::Subscription<ariac_msgs::msg::Sensors>::SharedPtr sensor_health_sub_;
+  /// Model name and quantized pose hashes of the latest image, reused between updates
+  struct ModelKey
+  {
+    size_t name;
+    size_t pose;
+  };
+  std::vector<ModelKey> image_keys_;
+  size_t image_hash_{0};
+  bool has_image_hash_{false};
+
+  /// Parts and trays of the last published change, by model name
+  struct TrackedModel
+  {
+    size_t pose_key;
+    bool is_tray;
+    ariac_msgs::msg::PartPose part;
+    ariac_msgs::msg::KitTrayPose tray;
+  };
+  std::unordered_map<std::string, TrackedModel> tracked_models_;
+
+  /// Set when the sensor stops being used, the next update compares against an empty image
+  std::atomic<bool> reset_tracking_{false};
 
   /// Publish latest logical camera data to ROS
   void OnUpdate();
+
+  /// Hash the models and quantized poses of the image, true if they differ from the previous image
+  bool UpdateImageKeys(const gazebo::msgs::LogicalCameraImage & _image);
+
+  /// Publish the parts and trays added, moved or removed since the last change
+  void PublishDelta(
+    const gazebo::msgs::LogicalCameraImage & _image, const builtin_interfaces::msg::Time & _stamp);
+
+  /// True if the logical camera sensor health is set
+  bool IsHealthy() const;
+
+  /// True if the image topic has a subscriber
+  bool HasSubscribers() const;
+
+  /// Activate the sensor when it is healthy and has subscribers, deactivate it otherwise
+  void UpdateActivity();
 };
 
 AriacLogicalCameraPlugin::AriacLogicalCameraPlugin()
@@ -69,27 +132,9 @@ void AriacLogicalCameraPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::Ele
   impl_->sensor_ = std::dynamic_pointer_cast<gazebo::sensors::LogicalCameraSensor>(_sensor);
   impl_->ros_node_ = gazebo_ros::Node::Get(_sdf);
 
-   // Set list of models to publish
-  impl_->parts_to_publish_ = {"pump", "battery", "regulator", "sensor"};
-  impl_->colors_ = {"red", "green", "blue", "orange", "purple"};
-
-  impl_->part_types_ = {
-    {"battery", ariac_msgs::msg::Part::BATTERY},
-    {"pump", ariac_msgs::msg::Part::PUMP},
-    {"regulator", ariac_msgs::msg::Part::REGULATOR},
-    {"sensor", ariac_msgs::msg::Part::SENSOR},
-  };
-
-  impl_->part_colors_ = {
-    {"red", ariac_msgs::msg::Part::RED},
-    {"green", ariac_msgs::msg::Part::GREEN},
-    {"blue", ariac_msgs::msg::Part::BLUE},
-    {"purple", ariac_msgs::msg::Part::PURPLE},
-    {"orange", ariac_msgs::msg::Part::ORANGE},
-  };
-
   impl_->camera_name_ = _sdf->Get<std::string>("camera_name");
   impl_->sensor_type_ = _sdf->Get<std::string>("sensor_type");
+  impl_->frame_name_ = gazebo_ros::SensorFrameID(*_sensor, *_sdf);
 
   if (impl_->sensor_type_ == "basic") {
     impl_->basic_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::BasicLogicalCameraImage>(
@@ -102,95 +147,208 @@ void AriacLogicalCameraPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::Ele
       "ariac/sensors/" + impl_->camera_name_ + "/image", rclcpp::SensorDataQoS());
 
     impl_->advanced_image_msg_ = std::make_shared<ariac_msgs::msg::AdvancedLogicalCameraImage>();
+
+    // Basic cameras do not report part identities, so only advanced ones can describe changes
+    if (_sdf->Get<bool>("publish_delta", false).first) {
+      impl_->delta_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::LogicalCameraDelta>(
+        "ariac/sensors/" + impl_->camera_name_ + "/delta", rclcpp::SensorDataQoS());
+    }
   }
 
-  // Subscribe to sensor health topic
-  impl_->sensor_health_sub_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::Sensors>("/ariac/sensor_health", 10, 
-    std::bind(&AriacLogicalCameraPlugin::SensorHealthCallback, this, std::placeholders::_1));
+  impl_->publish_on_change_ = _sdf->Get<bool>("publish_on_change", false).first;
+  double heartbeat_rate = _sdf->Get<double>("heartbeat_rate", 1.0).first;
+  if (heartbeat_rate > 0.0) {
+    impl_->heartbeat_period_ = 1.0 / heartbeat_rate;
+  }
+  impl_->position_resolution_ = _sdf->Get<double>("position_resolution", 0.001).first;
+  impl_->orientation_resolution_ = _sdf->Get<double>("orientation_resolution", 0.001).first;
 
+  impl_->update_timing_ = ariac_common::TimingRegistry::Instance().Histogram(
+    "AriacLogicalCameraPlugin", "OnUpdate");
   impl_->sensor_update_event_ = impl_->sensor_->ConnectUpdated(
     std::bind(&AriacLogicalCameraPluginPrivate::OnUpdate, impl_.get()));
+
+  // Health changes and subscribers coming and going have no callback, so poll for them
+  impl_->UpdateActivity();
+  impl_->activity_timer_ = impl_->ros_node_->create_wall_timer(
+    std::chrono::milliseconds(500),
+    std::bind(&AriacLogicalCameraPluginPrivate::UpdateActivity, impl_.get()));
 }
 
 void AriacLogicalCameraPluginPrivate::OnUpdate()
 {
-  if (!sensor_health_.logical_camera) {
+  ariac_common::ScopedTimer timer(update_timing_);
+
+  if (!IsHealthy() || !HasSubscribers()) {
+    reset_tracking_ = true;
     return;
   }
 
-  const auto & image = this->sensor_->Image();
+  // Whatever changed while nobody was listening is reported as added, not as moved or removed
+  if (reset_tracking_.exchange(false)) {
+    tracked_models_.clear();
+    has_image_hash_ = false;
+  }
 
-  geometry_msgs::msg::Pose sensor_pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(
-    gazebo::msgs::ConvertIgn(image.pose()));
+  const auto & image = this->sensor_->Image();
 
-  std::vector<ariac_msgs::msg::PartPose> parts;
-  std::vector<ariac_msgs::msg::KitTrayPose> trays;
+  bool changed = true;
+  if (publish_on_change_ || delta_pub_) {
+    changed = UpdateImageKeys(image);
+  }
 
-  for (int i = 0; i < image.model_size(); i++) {
+  if (publish_on_change_) {
+    // Sim time going backwards after a world reset makes the heartbeat due right away
+    double now = sensor_->LastMeasurementTime().Double();
+    bool heartbeat_due = now >= next_heartbeat_time_ ||
+      next_heartbeat_time_ - now > heartbeat_period_;
 
-    const auto & lc_model = image.model(i);
-    std::string name = lc_model.name();
+    if (!changed && !heartbeat_due) {
+      return;
+    }
+    next_heartbeat_time_ = now + heartbeat_period_;
+  }
 
-    if (name.find("kit_tray") != std::string::npos) {
-        ariac_msgs::msg::KitTrayPose kit_tray;
+  // Messages are filled in place and published by reference, steady state updates do not allocate
+  if (sensor_type_ == "basic") {
+    FillBasicImage(image, *basic_image_msg_);
+    basic_pub_->publish(*basic_image_msg_);
 
-        std::string id_string = name.substr(9, 2);
-        kit_tray.id = std::stoi(id_string);
-        kit_tray.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
+  } else if (sensor_type_ == "advanced") {
+    FillAdvancedImage(image, *advanced_image_msg_);
+    advanced_pub_->publish(*advanced_image_msg_);
 
-        trays.push_back(kit_tray);
-        continue;
+    if (delta_pub_ && changed) {
+      PublishDelta(
+        image, gazebo_ros::Convert<builtin_interfaces::msg::Time>(sensor_->LastMeasurementTime()));
     }
+  }
+}
 
-    for(std::string part_type : parts_to_publish_){
-      if (name.find(part_type) != std::string::npos) {
-        ariac_msgs::msg::PartPose part;
-
-        part.part.type = part_types_[part_type];
-        
-        for(std::string color : colors_){
-          if (name.find(color) != std::string::npos) {
-            part.part.color = part_colors_[color];
-          }
-        }
-
-        part.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
+bool AriacLogicalCameraPluginPrivate::UpdateImageKeys(const gazebo::msgs::LogicalCameraImage & _image)
+{
+  auto mix = [](size_t _seed, size_t _value) {
+      return _seed ^ (_value + 0x9e3779b97f4a7c15ULL + (_seed << 6) + (_seed >> 2));
+    };
+  auto pose_key = [&](const gazebo::msgs::Pose & _pose) {
+      size_t key = 0;
+      key = mix(key, std::llround(_pose.position().x() / position_resolution_));
+      key = mix(key, std::llround(_pose.position().y() / position_resolution_));
+      key = mix(key, std::llround(_pose.position().z() / position_resolution_));
+      key = mix(key, std::llround(_pose.orientation().x() / orientation_resolution_));
+      key = mix(key, std::llround(_pose.orientation().y() / orientation_resolution_));
+      key = mix(key, std::llround(_pose.orientation().z() / orientation_resolution_));
+      key = mix(key, std::llround(_pose.orientation().w() / orientation_resolution_));
+      return key;
+    };
+
+  image_keys_.resize(_image.model_size());
+
+  // Summing the model hashes makes the image hash independent of the model order
+  size_t hash = pose_key(_image.pose());
+  for (int i = 0; i < _image.model_size(); i++) {
+    const auto & model = _image.model(i);
+    image_keys_[i].name = std::hash<std::string>()(model.name());
+    image_keys_[i].pose = pose_key(model.pose());
+    hash += mix(image_keys_[i].name, image_keys_[i].pose);
+  }
 
-        parts.push_back(part);
+  bool changed = !has_image_hash_ || hash != image_hash_;
+  image_hash_ = hash;
+  has_image_hash_ = true;
+  return changed;
+}
 
-        break;
-      }
+void AriacLogicalCameraPluginPrivate::PublishDelta(
+  const gazebo::msgs::LogicalCameraImage & _image, const builtin_interfaces::msg::Time & _stamp)
+{
+  // Pair the models of the image with the poses FillAdvancedImage wrote, which keep the image order
+  std::unordered_map<std::string, TrackedModel> models;
+  size_t part_index = 0;
+  size_t tray_index = 0;
+  for (int i = 0; i < _image.model_size(); i++) {
+    const auto & name = _image.model(i).name();
+    const auto info = ariac_common::ClassifyModelName(name);
+    if (info.IsKitTray()) {
+      models[name] =
+        {image_keys_[i].pose, true, {}, advanced_image_msg_->tray_poses[tray_index++]};
+    } else if (info.IsPart()) {
+      models[name] =
+        {image_keys_[i].pose, false, advanced_image_msg_->part_poses[part_index++], {}};
     }
   }
 
-  if (sensor_type_ == "basic") {
-    basic_image_msg_->sensor_pose = sensor_pose;
+  ariac_msgs::msg::LogicalCameraDelta delta;
+  delta.header.stamp = _stamp;
+  delta.header.frame_id = frame_name_;
 
-    basic_image_msg_->part_poses.clear();
-    basic_image_msg_->tray_poses.clear();
+  for (const auto & entry : models) {
+    const auto & model = entry.second;
+    auto previous = tracked_models_.find(entry.first);
+    bool added = previous == tracked_models_.end();
+    if (!added && previous->second.pose_key == model.pose_key) {
+      continue;
+    }
 
-    for (ariac_msgs::msg::PartPose &part : parts) {
-      basic_image_msg_->part_poses.push_back(part.pose);
+    if (model.is_tray) {
+      (added ? delta.added_trays : delta.moved_trays).push_back(model.tray);
+    } else {
+      (added ? delta.added_parts : delta.moved_parts).push_back(model.part);
     }
+  }
 
-    for (ariac_msgs::msg::KitTrayPose &tray : trays) {
-      basic_image_msg_->tray_poses.push_back(tray.pose);
+  for (const auto & entry : tracked_models_) {
+    const auto & model = entry.second;
+    if (models.count(entry.first) > 0) {
+      continue;
     }
 
-    basic_pub_->publish(*basic_image_msg_);
+    if (model.is_tray) {
+      delta.removed_trays.push_back(model.tray);
+    } else {
+      delta.removed_parts.push_back(model.part);
+    }
+  }
 
-  } else if (sensor_type_ == "advanced") {
-    advanced_image_msg_->sensor_pose = sensor_pose;
+  tracked_models_ = std::move(models);
+
+  // A change of the sensor pose alone leaves nothing to report
+  if (delta.added_parts.empty() && delta.moved_parts.empty() && delta.removed_parts.empty() &&
+    delta.added_trays.empty() && delta.moved_trays.empty() && delta.removed_trays.empty())
+  {
+    return;
+  }
 
-    advanced_image_msg_->part_poses = parts;
-    advanced_image_msg_->tray_poses = trays;
+  delta_pub_->publish(delta);
+}
 
-    advanced_pub_->publish(*advanced_image_msg_);
+bool AriacLogicalCameraPluginPrivate::IsHealthy() const
+{
+  return ariac_common::SensorHealthRegistry::Instance().IsHealthy(
+    ariac_common::SensorHealthRegistry::LOGICAL_CAMERA);
+}
+
+bool AriacLogicalCameraPluginPrivate::HasSubscribers() const
+{
+  if (delta_pub_ && delta_pub_->get_subscription_count() > 0) {
+    return true;
   }
+  if (basic_pub_) {
+    return basic_pub_->get_subscription_count() > 0;
+  }
+  return advanced_pub_ && advanced_pub_->get_subscription_count() > 0;
 }
 
-void AriacLogicalCameraPlugin::SensorHealthCallback(const ariac_msgs::msg::Sensors::SharedPtr msg){
-  impl_->sensor_health_ = *msg;
+void AriacLogicalCameraPluginPrivate::UpdateActivity()
+{
+  bool active = IsHealthy() && HasSubscribers();
+  if (sensor_->IsActive() != active) {
+    // A deactivated sensor stops calling OnUpdate, so it cannot notice the gap itself
+    if (!active) {
+      reset_tracking_ = true;
+    }
+    sensor_->SetActive(active);
+  }
 }
 
 GZ_REGISTER_SENSOR_PLUGIN(AriacLogicalCameraPlugin)
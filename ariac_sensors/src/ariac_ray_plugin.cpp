@@ -1,8 +1,11 @@
 #include <ariac_sensors/ariac_ray_plugin.hpp>
+#include <ariac_sensors/beam_projection.hpp>
 
 #include <boost/make_shared.hpp>
+#include <gazebo/sensors/RaySensor.hh>
 #include <gazebo/transport/transport.hh>
 
+#include <gazebo_ros/conversions/builtin_interfaces.hpp>
 #include <gazebo_ros/conversions/sensor_msgs.hpp>
 #include <gazebo_ros/node.hpp>
 #include <gazebo_ros/utils.hpp>
@@ -10,10 +13,15 @@
 #include <rclcpp/rclcpp.hpp>
 
 #include <ariac_msgs/msg/break_beam_status.hpp>
-#include <ariac_msgs/msg/sensors.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <sensor_msgs/msg/point_field.hpp>
+
+#include <ariac_plugins/sensor_health_registry.hpp>
+#include <ariac_plugins/timing_registry.hpp>
 
 #include <string>
 #include <algorithm>
+#include <chrono>
 #include <limits>
 #include <memory>
 
@@ -30,12 +38,38 @@ public:
   rclcpp::Publisher<ariac_msgs::msg::BreakBeamStatus>::SharedPtr status_pub_;
   rclcpp::Publisher<ariac_msgs::msg::BreakBeamStatus>::SharedPtr change_pub_;
 
+  /// Sim time period between two status messages, 0 publishes the status of every scan
+  double status_period_{0.0};
+
+  /// Sim time at which the next status message is due
+  double next_status_time_{0.0};
+
   rclcpp::Publisher<sensor_msgs::msg::Range>::SharedPtr range_pub_;
   rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr laser_scan_pub_;
   rclcpp::Publisher<sensor_msgs::msg::PointCloud>::SharedPtr point_cloud_pub_;
+  rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr point_cloud2_pub_;
+
+  /// PointCloud2 message reused for every scan, its data buffer only grows
+  sensor_msgs::msg::PointCloud2 point_cloud2_msg_;
+
+  /// Direction of each lidar beam, computed once instead of per point and scan
+  BeamDirections beams_;
+
+  /// Valid range of the lidar, returns outside of it become NaN points
+  float min_range_{0.0f};
+  float max_range_{0.0f};
 
   std::string sensor_name_;
 
+  /// Sensor this plugin is attached to, ray casts only run while its output is used
+  gazebo::sensors::SensorPtr sensor_;
+
+  /// Periodically re-evaluates whether the sensor has to update
+  rclcpp::TimerBase::SharedPtr activity_timer_;
+
+  /// Latency of ReadLaserScan, shared by all the sensors of the same type
+  ariac_common::LatencyHistogram * scan_timing_{nullptr};
+
   /// TF frame output is published in
   std::string frame_name_;
 
@@ -50,7 +84,8 @@ public:
 
   std::string sensor_type_;
 
-  ariac_msgs::msg::Sensors sensor_health_;
+  /// Bit of this sensor type in the shared sensor health
+  ariac_common::SensorHealthRegistry::Sensor health_bit_;
 
   /// Gazebo node used to subscribe to laser scan
   gazebo::transport::NodePtr gazebo_node_;
@@ -58,10 +93,7 @@ public:
   /// Gazebo subscribe to parent sensor's laser scan
   gazebo::transport::SubscriberPtr laser_scan_sub_;
 
-  /// Sensor Health Subscription
-  rclcpp::Subscription<ariac_msgs::msg::Sensors>::SharedPtr sensor_health_sub_;
-
-  /// Publish a sensor_msgs/Range message from a gazebo laser scan
+  /// Publish the break beam status from the raw ranges of a gazebo laser scan
   void PublishBreakBeamStatus(ConstLaserScanStampedPtr & _msg);
 
   /// Publish a sensor_msgs/Range message from a gazebo laser scan
@@ -72,6 +104,24 @@ public:
 
   /// Publish a sensor_msgs/PointCloud message from a gazebo laser scan
   void PublishPointCloud(ConstLaserScanStampedPtr & _msg);
+
+  /// Publish an organized sensor_msgs/PointCloud2 message from a gazebo laser scan
+  void PublishPointCloud2(ConstLaserScanStampedPtr & _msg);
+
+  /// Set up the beam directions and the PointCloud2 layout for a scan geometry
+  void InitPointCloud2(
+    double _angle_min, double _angle_max, uint32_t _count,
+    double _vertical_angle_min, double _vertical_angle_max, uint32_t _vertical_count,
+    double _range_min, double _range_max);
+
+  /// True if the health of this sensor type is set
+  bool IsHealthy() const;
+
+  /// True if any of the output topics has a subscriber
+  bool HasSubscribers() const;
+
+  /// Activate the sensor when it is healthy and has subscribers, deactivate it otherwise
+  void UpdateActivity();
 };
 
 AriacRayPlugin::AriacRayPlugin()
@@ -99,43 +149,83 @@ void AriacRayPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::ElementPtr _s
 
   impl_->frame_name_ = gazebo_ros::SensorFrameID(*_sensor, *_sdf);
 
+  impl_->sensor_ = _sensor;
+
   if (impl_->sensor_type_ == "break_beam") {
 
+    impl_->health_bit_ = ariac_common::SensorHealthRegistry::BREAK_BEAM;
     impl_->status_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::BreakBeamStatus>(
       "ariac/sensors/" + impl_->sensor_name_ + "/status", rclcpp::SensorDataQoS());
     impl_->change_pub_ = impl_->ros_node_->create_publisher<ariac_msgs::msg::BreakBeamStatus>(
       "ariac/sensors/" + impl_->sensor_name_ + "/change", rclcpp::SensorDataQoS());
 
+    // Changes are always published, the status stream can run slower than the ray sensor
+    double status_rate = _sdf->Get<double>("status_rate", 0.0).first;
+    if (status_rate > 0.0) {
+      impl_->status_period_ = 1.0 / status_rate;
+    }
+
   } else if (impl_->sensor_type_ == "proximity") {
     
+    impl_->health_bit_ = ariac_common::SensorHealthRegistry::PROXIMITY;
     impl_->range_pub_ = impl_->ros_node_->create_publisher<sensor_msgs::msg::Range>(
       "ariac/sensors/" + impl_->sensor_name_ + "/scan", rclcpp::SensorDataQoS());
 
   } else if (impl_->sensor_type_ == "laser_profiler") {
     
+    impl_->health_bit_ = ariac_common::SensorHealthRegistry::LASER_PROFILER;
     impl_->laser_scan_pub_ = impl_->ros_node_->create_publisher<sensor_msgs::msg::LaserScan>(
       "ariac/sensors/" + impl_->sensor_name_ + "/scan", rclcpp::SensorDataQoS());
 
   } else if (impl_->sensor_type_ == "lidar") {
     
-    impl_->point_cloud_pub_ = impl_->ros_node_->create_publisher<sensor_msgs::msg::PointCloud>(
-      "ariac/sensors/" + impl_->sensor_name_ + "/scan", rclcpp::SensorDataQoS());
+    impl_->health_bit_ = ariac_common::SensorHealthRegistry::LIDAR;
+
+    auto output_type = _sdf->Get<std::string>("output_type", "sensor_msgs/PointCloud").first;
+    auto ray_sensor = std::dynamic_pointer_cast<gazebo::sensors::RaySensor>(_sensor);
+    if (output_type == "sensor_msgs/PointCloud2" && !ray_sensor) {
+      // The beam layout is read from the sensor, a gpu_ray sensor is not a RaySensor
+      RCLCPP_ERROR(impl_->ros_node_->get_logger(),
+        "sensor_msgs/PointCloud2 output needs a ray sensor, publishing sensor_msgs/PointCloud");
+      output_type = "sensor_msgs/PointCloud";
+    } else if (output_type != "sensor_msgs/PointCloud2" && output_type != "sensor_msgs/PointCloud") {
+      RCLCPP_WARN(impl_->ros_node_->get_logger(),
+        "Lidar output type %s not recognized, publishing sensor_msgs/PointCloud", output_type.c_str());
+    }
+
+    if (output_type == "sensor_msgs/PointCloud2") {
+      impl_->point_cloud2_pub_ = impl_->ros_node_->create_publisher<sensor_msgs::msg::PointCloud2>(
+        "ariac/sensors/" + impl_->sensor_name_ + "/scan", rclcpp::SensorDataQoS());
+
+      impl_->InitPointCloud2(
+        ray_sensor->AngleMin().Radian(), ray_sensor->AngleMax().Radian(), ray_sensor->RangeCount(),
+        ray_sensor->VerticalAngleMin().Radian(), ray_sensor->VerticalAngleMax().Radian(),
+        ray_sensor->VerticalRangeCount(), ray_sensor->RangeMin(), ray_sensor->RangeMax());
+    } else {
+      impl_->point_cloud_pub_ = impl_->ros_node_->create_publisher<sensor_msgs::msg::PointCloud>(
+        "ariac/sensors/" + impl_->sensor_name_ + "/scan", rclcpp::SensorDataQoS());
+    }
 
   } else {
     RCLCPP_ERROR(impl_->ros_node_->get_logger(), "Sensor type not valid");
     return;
   }
 
-  // Subscribe to sensor health topic
-  impl_->sensor_health_sub_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::Sensors>("/ariac/sensor_health", 10, 
-    std::bind(&AriacRayPlugin::SensorHealthCallback, this, std::placeholders::_1));
-
   // Create gazebo transport node and subscribe to sensor's laser scan
   impl_->gazebo_node_ = boost::make_shared<gazebo::transport::Node>();
   impl_->gazebo_node_->Init(_sensor->WorldName());
 
+  impl_->scan_timing_ = ariac_common::TimingRegistry::Instance().Histogram(
+    "AriacRayPlugin", impl_->sensor_type_);
+
   impl_->sensor_topic_ = _sensor->Topic();
   impl_->SubscribeGazeboLaserScan();
+
+  // Health changes and subscribers coming and going have no callback, so poll for them
+  impl_->UpdateActivity();
+  impl_->activity_timer_ = impl_->ros_node_->create_wall_timer(
+    std::chrono::milliseconds(500),
+    std::bind(&AriacRayPluginPrivate::UpdateActivity, impl_.get()));
 }
 
 void AriacRayPluginPrivate::SubscribeGazeboLaserScan()
@@ -146,6 +236,13 @@ void AriacRayPluginPrivate::SubscribeGazeboLaserScan()
 
 void AriacRayPluginPrivate::ReadLaserScan(ConstLaserScanStampedPtr & _msg)
 {
+  ariac_common::ScopedTimer timer(scan_timing_);
+
+  // Scans produced before the sensor was deactivated are dropped before any conversion
+  if (!IsHealthy()) {
+    return;
+  }
+
   if (sensor_type_ == "break_beam") {
     PublishBreakBeamStatus(_msg);
   } else if (sensor_type_ == "proximity") {
@@ -153,49 +250,49 @@ void AriacRayPluginPrivate::ReadLaserScan(ConstLaserScanStampedPtr & _msg)
   } else if (sensor_type_ == "laser_profiler") {
     PublishLaserScan(_msg);
   } else if (sensor_type_ == "lidar") {
-    PublishPointCloud(_msg);
+    if (point_cloud2_pub_) {
+      PublishPointCloud2(_msg);
+    } else {
+      PublishPointCloud(_msg);
+    }
   }
 }
 
 void AriacRayPluginPrivate::PublishBreakBeamStatus(ConstLaserScanStampedPtr & _msg)
 {
-  if (!sensor_health_.break_beam) {
+  // Only the ranges are needed, read them from the gazebo message instead of converting to a LaserScan
+  const auto & ranges = _msg->scan().ranges();
+  bool object_detected = std::any_of(
+    ranges.begin(), ranges.end(), [](double distance) {return distance > 0.0 && distance < 1.0;});
+
+  bool changed = status_msg_.object_detected != object_detected;
+  double scan_time = _msg->time().sec() + _msg->time().nsec() * 1e-9;
+  // A sim time going backwards after a world reset makes the status due right away
+  bool status_due = status_period_ <= 0.0 || scan_time >= next_status_time_ ||
+    next_status_time_ - scan_time > status_period_;
+
+  if (!changed && !status_due) {
     return;
   }
 
-  auto ls = gazebo_ros::Convert<sensor_msgs::msg::LaserScan>(*_msg, 0.0);
   status_msg_.header.frame_id = frame_name_;
-  status_msg_.header.stamp = ls.header.stamp;
-
-  bool object_detected = false;
-  bool publish_change = false;
-
-  for(float distance : ls.ranges) {
-    if (distance > 0.0 && distance < 1.0) {
-        object_detected = true;
-        break;
-    }
-  }
-
-  if (status_msg_.object_detected != object_detected) {
-    publish_change = true;
-  }
-
+  status_msg_.header.stamp = gazebo_ros::Convert<builtin_interfaces::msg::Time>(_msg->time());
   status_msg_.object_detected = object_detected;
 
-  // Publish output
-  if (publish_change) {
+  // The change carries the stamp of the first scan seen in the new state
+  if (changed) {
     change_pub_->publish(status_msg_);
   }
+
+  // A change is also published on the status topic so it never lags behind the change topic
   status_pub_->publish(status_msg_);
+  if (status_period_ > 0.0) {
+    next_status_time_ = scan_time + status_period_;
+  }
 }
 
 void AriacRayPluginPrivate::PublishRange(ConstLaserScanStampedPtr & _msg)
 {
-  if (!sensor_health_.proximity) {
-    return;
-  }
-
   // Convert Laser scan to range
   auto range_msg = gazebo_ros::Convert<sensor_msgs::msg::Range>(*_msg);
   range_msg.header.frame_id = frame_name_;
@@ -205,10 +302,6 @@ void AriacRayPluginPrivate::PublishRange(ConstLaserScanStampedPtr & _msg)
 
 void AriacRayPluginPrivate::PublishLaserScan(ConstLaserScanStampedPtr & _msg)
 {
-  if (!sensor_health_.laser_profiler) {
-    return;
-  }
-
   // Convert Laser scan to ROS LaserScan
   auto ls = gazebo_ros::Convert<sensor_msgs::msg::LaserScan>(*_msg, 0.0);
   ls.header.frame_id = frame_name_;
@@ -217,18 +310,102 @@ void AriacRayPluginPrivate::PublishLaserScan(ConstLaserScanStampedPtr & _msg)
 
 void AriacRayPluginPrivate::PublishPointCloud(ConstLaserScanStampedPtr & _msg)
 {
-  if (!sensor_health_.lidar) {
-    return;
-  }
-
   // Convert Laser scan to PointCloud
   auto pc = gazebo_ros::Convert<sensor_msgs::msg::PointCloud>(*_msg, 0.0);
   pc.header.frame_id = frame_name_;
   point_cloud_pub_->publish(pc);
 }
 
-void AriacRayPlugin::SensorHealthCallback(const ariac_msgs::msg::Sensors::SharedPtr msg){
-  impl_->sensor_health_ = *msg;
+void AriacRayPluginPrivate::PublishPointCloud2(ConstLaserScanStampedPtr & _msg)
+{
+  const auto & scan = _msg->scan();
+
+  // The geometry read at Load normally matches, only rebuild if the scan says otherwise
+  if (scan.count() != beams_.horizontal_count || scan.vertical_count() != beams_.vertical_count) {
+    InitPointCloud2(
+      scan.angle_min(), scan.angle_max(), scan.count(),
+      scan.vertical_angle_min(), scan.vertical_angle_max(), scan.vertical_count(),
+      scan.range_min(), scan.range_max());
+  }
+
+  if (static_cast<std::size_t>(scan.ranges_size()) != beams_.Size()) {
+    RCLCPP_WARN_ONCE(ros_node_->get_logger(), "Laser scan size does not match its beam count");
+    return;
+  }
+
+  const double * intensities =
+    scan.intensities_size() == scan.ranges_size() ? scan.intensities().data() : nullptr;
+
+  point_cloud2_msg_.header.stamp = gazebo_ros::Convert<builtin_interfaces::msg::Time>(_msg->time());
+  ProjectRanges(
+    beams_, scan.ranges().data(), intensities,
+    reinterpret_cast<float *>(point_cloud2_msg_.data.data()), min_range_, max_range_);
+
+  point_cloud2_pub_->publish(point_cloud2_msg_);
+}
+
+void AriacRayPluginPrivate::InitPointCloud2(
+  double _angle_min, double _angle_max, uint32_t _count,
+  double _vertical_angle_min, double _vertical_angle_max, uint32_t _vertical_count,
+  double _range_min, double _range_max)
+{
+  beams_ = ComputeBeamDirections(
+    _angle_min, _angle_max, _count, _vertical_angle_min, _vertical_angle_max, _vertical_count);
+  min_range_ = static_cast<float>(_range_min);
+  max_range_ = static_cast<float>(_range_max);
+
+  auto & msg = point_cloud2_msg_;
+  msg.header.frame_id = frame_name_;
+
+  // Packed float32 x, y, z and intensity, one row per vertical beam
+  msg.fields.clear();
+  const char * names[] = {"x", "y", "z", "intensity"};
+  for (uint32_t i = 0; i < 4; i++) {
+    sensor_msgs::msg::PointField field;
+    field.name = names[i];
+    field.offset = i * sizeof(float);
+    field.datatype = sensor_msgs::msg::PointField::FLOAT32;
+    field.count = 1;
+    msg.fields.push_back(field);
+  }
+
+  msg.height = beams_.vertical_count;
+  msg.width = beams_.horizontal_count;
+  msg.is_bigendian = false;
+  msg.point_step = 4 * sizeof(float);
+  msg.row_step = msg.point_step * msg.width;
+  msg.is_dense = false;
+  msg.data.resize(static_cast<std::size_t>(msg.row_step) * msg.height);
+}
+
+bool AriacRayPluginPrivate::IsHealthy() const
+{
+  return ariac_common::SensorHealthRegistry::Instance().IsHealthy(health_bit_);
+}
+
+bool AriacRayPluginPrivate::HasSubscribers() const
+{
+  if (sensor_type_ == "break_beam") {
+    return status_pub_->get_subscription_count() > 0 || change_pub_->get_subscription_count() > 0;
+  } else if (sensor_type_ == "proximity") {
+    return range_pub_->get_subscription_count() > 0;
+  } else if (sensor_type_ == "laser_profiler") {
+    return laser_scan_pub_->get_subscription_count() > 0;
+  } else if (sensor_type_ == "lidar") {
+    if (point_cloud2_pub_) {
+      return point_cloud2_pub_->get_subscription_count() > 0;
+    }
+    return point_cloud_pub_->get_subscription_count() > 0;
+  }
+  return false;
+}
+
+void AriacRayPluginPrivate::UpdateActivity()
+{
+  bool active = IsHealthy() && HasSubscribers();
+  if (sensor_->IsActive() != active) {
+    sensor_->SetActive(active);
+  }
 }
 
 // Register this plugin with the simulator
@@ -12,6 +12,9 @@
 #include <ariac_msgs/msg/part_pose.hpp>
 #include <ariac_msgs/msg/trial.hpp>
 
+#include <ariac_plugins/model_name_classifier.hpp>
+#include <ariac_plugins/timing_registry.hpp>
+
 #include <memory>
 
 namespace ariac_sensors
@@ -28,13 +31,6 @@ public:
   
   /// Event triggered when sensor updates
   gazebo::event::ConnectionPtr sensor_update_event_;
-  
-  /// List of models that the logical camera will publish
-  std::vector<std::string> parts_to_publish_;
-  std::vector<std::string> colors_;
-
-  std::map<std::string, int> part_types_;
-  std::map<std::string, int> part_colors_;
 
   std::vector<ariac_msgs::msg::Order> orders_;
 
@@ -46,6 +42,9 @@ public:
   // Task Scoring Service
   rclcpp::Service<ariac_msgs::srv::ScoreTask>::SharedPtr score_task_service_;
 
+  /// Latency of OnUpdate, shared by all the station sensors
+  ariac_common::LatencyHistogram * update_timing_{nullptr};
+
   /// Publish latest logical camera data to ROS
   void OnUpdate();
 
@@ -77,21 +76,6 @@ void AssemblyStationSensorPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::
     impl_->sensor_num_ = _sdf->Get<std::string>("sensor_num");
   }
 
-  impl_->part_types_ = {
-    {"battery", ariac_msgs::msg::Part::BATTERY},
-    {"pump", ariac_msgs::msg::Part::PUMP},
-    {"regulator", ariac_msgs::msg::Part::REGULATOR},
-    {"sensor", ariac_msgs::msg::Part::SENSOR},
-  };
-
-  impl_->part_colors_ = {
-    {"red", ariac_msgs::msg::Part::RED},
-    {"green", ariac_msgs::msg::Part::GREEN},
-    {"blue", ariac_msgs::msg::Part::BLUE},
-    {"purple", ariac_msgs::msg::Part::PURPLE},
-    {"orange", ariac_msgs::msg::Part::ORANGE},
-  };
-
   // Subscribe to trial topic
   impl_->trial_sub_ = impl_->ros_node_->create_subscription<ariac_msgs::msg::Trial>("/ariac/trial_config", 10, 
     std::bind(&AssemblyStationSensorPluginPrivate::TrialConfigCallback, this->impl_.get(), std::placeholders::_1));
@@ -103,12 +87,16 @@ void AssemblyStationSensorPlugin::Load(gazebo::sensors::SensorPtr _sensor, sdf::
     &AssemblyStationSensorPluginPrivate::ScoreTask, this->impl_.get(),
     std::placeholders::_1, std::placeholders::_2));
 
+  impl_->update_timing_ = ariac_common::TimingRegistry::Instance().Histogram(
+    "AssemblyStationSensorPlugin", "OnUpdate");
   impl_->sensor_update_event_ = impl_->sensor_->ConnectUpdated(
     std::bind(&AssemblyStationSensorPluginPrivate::OnUpdate, impl_.get()));
 }
 
 void AssemblyStationSensorPluginPrivate::OnUpdate()
 {
+  ariac_common::ScopedTimer timer(update_timing_);
+
   const auto & image = this->sensor_->Image();
 
   geometry_msgs::msg::Pose sensor_pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(
@@ -119,26 +107,16 @@ void AssemblyStationSensorPluginPrivate::OnUpdate()
   for (int i = 0; i < image.model_size(); i++) {
 
     const auto & lc_model = image.model(i);
-    std::string name = lc_model.name();
-
-    for(const auto &type : part_types_) {
-      if (name.find(type.first) != std::string::npos) {
-        ariac_msgs::msg::PartPose part;
-
-        part.part.type = type.second;
-        
-        for(const auto &color : part_colors_) {
-          if (name.find(color.first) != std::string::npos) {
-            part.part.color = color.second;
-          }
-        }
+    const auto info = ariac_common::ClassifyModelName(lc_model.name());
 
-        part.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
+    if (info.IsPart()) {
+      ariac_msgs::msg::PartPose part;
 
-        parts.push_back(part);
+      part.part.type = info.type;
+      part.part.color = info.color;
+      part.pose = gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(lc_model.pose()));
 
-        break;
-      }
+      parts.push_back(part);
     }
   }
 }
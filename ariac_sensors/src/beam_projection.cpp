@@ -0,0 +1,222 @@
+#include <ariac_sensors/beam_projection.hpp>
+
+#include <cmath>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ARIAC_BEAM_PROJECTION_X86
+#include <immintrin.h>
+#endif
+
+namespace ariac_sensors
+{
+
+namespace
+{
+
+using ProjectFunction = void (*)(
+  const float *, const float *, const float *, const double *, const double *,
+  float *, std::size_t, float, float);
+
+void ProjectScalar(
+  const float * _x, const float * _y, const float * _z,
+  const double * _ranges, const double * _intensities,
+  float * _points, std::size_t _count, float _min_range, float _max_range)
+{
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+
+  for (std::size_t i = 0; i < _count; i++) {
+    float range = static_cast<float>(_ranges[i]);
+    float * point = _points + 4 * i;
+    if (_min_range < range && range < _max_range) {
+      point[0] = range * _x[i];
+      point[1] = range * _y[i];
+      point[2] = range * _z[i];
+    } else {
+      point[0] = nan;
+      point[1] = nan;
+      point[2] = nan;
+    }
+    point[3] = _intensities ? static_cast<float>(_intensities[i]) : 0.0f;
+  }
+}
+
+#ifdef ARIAC_BEAM_PROJECTION_X86
+__attribute__((target("sse2")))
+inline __m128 LoadDoublesSSE2(const double * _values)
+{
+  return _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(_values)), _mm_cvtpd_ps(_mm_loadu_pd(_values + 2)));
+}
+
+__attribute__((target("sse2")))
+void ProjectSSE2(
+  const float * _x, const float * _y, const float * _z,
+  const double * _ranges, const double * _intensities,
+  float * _points, std::size_t _count, float _min_range, float _max_range)
+{
+  const __m128 min_range = _mm_set1_ps(_min_range);
+  const __m128 max_range = _mm_set1_ps(_max_range);
+  const __m128 nan = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+
+  std::size_t i = 0;
+  for (; i + 4 <= _count; i += 4) {
+    __m128 range = LoadDoublesSSE2(_ranges + i);
+    // Comparisons are ordered, so NaN ranges are not valid
+    __m128 valid = _mm_and_ps(_mm_cmpgt_ps(range, min_range), _mm_cmplt_ps(range, max_range));
+
+    __m128 x = _mm_mul_ps(range, _mm_loadu_ps(_x + i));
+    __m128 y = _mm_mul_ps(range, _mm_loadu_ps(_y + i));
+    __m128 z = _mm_mul_ps(range, _mm_loadu_ps(_z + i));
+    x = _mm_or_ps(_mm_and_ps(valid, x), _mm_andnot_ps(valid, nan));
+    y = _mm_or_ps(_mm_and_ps(valid, y), _mm_andnot_ps(valid, nan));
+    z = _mm_or_ps(_mm_and_ps(valid, z), _mm_andnot_ps(valid, nan));
+    __m128 intensity = _intensities ? LoadDoublesSSE2(_intensities + i) : _mm_setzero_ps();
+
+    // Four beams of x, y, z and intensity become four packed points
+    _MM_TRANSPOSE4_PS(x, y, z, intensity);
+    _mm_storeu_ps(_points + 4 * i, x);
+    _mm_storeu_ps(_points + 4 * i + 4, y);
+    _mm_storeu_ps(_points + 4 * i + 8, z);
+    _mm_storeu_ps(_points + 4 * i + 12, intensity);
+  }
+
+  ProjectScalar(
+    _x + i, _y + i, _z + i, _ranges + i, _intensities ? _intensities + i : nullptr,
+    _points + 4 * i, _count - i, _min_range, _max_range);
+}
+
+__attribute__((target("avx2")))
+inline __m256 LoadDoublesAVX2(const double * _values)
+{
+  return _mm256_insertf128_ps(
+    _mm256_castps128_ps256(_mm256_cvtpd_ps(_mm256_loadu_pd(_values))),
+    _mm256_cvtpd_ps(_mm256_loadu_pd(_values + 4)), 1);
+}
+
+__attribute__((target("avx2")))
+void ProjectAVX2(
+  const float * _x, const float * _y, const float * _z,
+  const double * _ranges, const double * _intensities,
+  float * _points, std::size_t _count, float _min_range, float _max_range)
+{
+  const __m256 min_range = _mm256_set1_ps(_min_range);
+  const __m256 max_range = _mm256_set1_ps(_max_range);
+  const __m256 nan = _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN());
+
+  std::size_t i = 0;
+  for (; i + 8 <= _count; i += 8) {
+    __m256 range = LoadDoublesAVX2(_ranges + i);
+    __m256 valid = _mm256_and_ps(
+      _mm256_cmp_ps(range, min_range, _CMP_GT_OQ), _mm256_cmp_ps(range, max_range, _CMP_LT_OQ));
+
+    __m256 x = _mm256_blendv_ps(nan, _mm256_mul_ps(range, _mm256_loadu_ps(_x + i)), valid);
+    __m256 y = _mm256_blendv_ps(nan, _mm256_mul_ps(range, _mm256_loadu_ps(_y + i)), valid);
+    __m256 z = _mm256_blendv_ps(nan, _mm256_mul_ps(range, _mm256_loadu_ps(_z + i)), valid);
+    __m256 intensity = _intensities ? LoadDoublesAVX2(_intensities + i) : _mm256_setzero_ps();
+
+    // Transpose within each 128 bit lane, lane 0 holds beams 0-3 and lane 1 beams 4-7
+    __m256 xy_low = _mm256_unpacklo_ps(x, y);
+    __m256 xy_high = _mm256_unpackhi_ps(x, y);
+    __m256 zi_low = _mm256_unpacklo_ps(z, intensity);
+    __m256 zi_high = _mm256_unpackhi_ps(z, intensity);
+    __m256 p04 = _mm256_shuffle_ps(xy_low, zi_low, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 p15 = _mm256_shuffle_ps(xy_low, zi_low, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 p26 = _mm256_shuffle_ps(xy_high, zi_high, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 p37 = _mm256_shuffle_ps(xy_high, zi_high, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(_points + 4 * i, _mm256_permute2f128_ps(p04, p15, 0x20));
+    _mm256_storeu_ps(_points + 4 * i + 8, _mm256_permute2f128_ps(p26, p37, 0x20));
+    _mm256_storeu_ps(_points + 4 * i + 16, _mm256_permute2f128_ps(p04, p15, 0x31));
+    _mm256_storeu_ps(_points + 4 * i + 24, _mm256_permute2f128_ps(p26, p37, 0x31));
+  }
+
+  ProjectSSE2(
+    _x + i, _y + i, _z + i, _ranges + i, _intensities ? _intensities + i : nullptr,
+    _points + 4 * i, _count - i, _min_range, _max_range);
+}
+#endif
+
+struct ProjectDispatch
+{
+  ProjectFunction function;
+  const char * name;
+};
+
+ProjectDispatch SelectProject()
+{
+#ifdef ARIAC_BEAM_PROJECTION_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {ProjectAVX2, "avx2"};
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return {ProjectSSE2, "sse2"};
+  }
+#endif
+  return {ProjectScalar, "scalar"};
+}
+
+const ProjectDispatch & GetProject()
+{
+  static const ProjectDispatch dispatch = SelectProject();
+  return dispatch;
+}
+
+}  // namespace
+
+BeamDirections ComputeBeamDirections(
+  double _angle_min, double _angle_max, uint32_t _horizontal_count,
+  double _vertical_angle_min, double _vertical_angle_max, uint32_t _vertical_count)
+{
+  BeamDirections beams;
+  beams.horizontal_count = _horizontal_count;
+  beams.vertical_count = _vertical_count;
+
+  std::size_t count = static_cast<std::size_t>(_horizontal_count) * _vertical_count;
+  beams.x.resize(count);
+  beams.y.resize(count);
+  beams.z.resize(count);
+
+  double yaw_step = _horizontal_count > 1 ?
+    (_angle_max - _angle_min) / (_horizontal_count - 1) : 0.0;
+  double pitch_step = _vertical_count > 1 ?
+    (_vertical_angle_max - _vertical_angle_min) / (_vertical_count - 1) : 0.0;
+
+  for (uint32_t j = 0; j < _vertical_count; j++) {
+    double pitch = _vertical_angle_min + j * pitch_step;
+    for (uint32_t i = 0; i < _horizontal_count; i++) {
+      double yaw = _angle_min + i * yaw_step;
+      std::size_t index = i + static_cast<std::size_t>(j) * _horizontal_count;
+      beams.x[index] = static_cast<float>(std::cos(pitch) * std::cos(yaw));
+      beams.y[index] = static_cast<float>(std::cos(pitch) * std::sin(yaw));
+      beams.z[index] = static_cast<float>(std::sin(pitch));
+    }
+  }
+
+  return beams;
+}
+
+void ProjectRangesScalar(
+  const BeamDirections & _beams, const double * _ranges, const double * _intensities,
+  float * _points, float _min_range, float _max_range)
+{
+  ProjectScalar(
+    _beams.x.data(), _beams.y.data(), _beams.z.data(), _ranges, _intensities,
+    _points, _beams.Size(), _min_range, _max_range);
+}
+
+void ProjectRanges(
+  const BeamDirections & _beams, const double * _ranges, const double * _intensities,
+  float * _points, float _min_range, float _max_range)
+{
+  GetProject().function(
+    _beams.x.data(), _beams.y.data(), _beams.z.data(), _ranges, _intensities,
+    _points, _beams.Size(), _min_range, _max_range);
+}
+
+const char * ProjectRangesImplementation()
+{
+  return GetProject().name;
+}
+
+}  // namespace ariac_sensors
@@ -0,0 +1,128 @@
+#include <ariac_sensors/depth_clamp.hpp>
+
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ARIAC_DEPTH_CLAMP_X86
+#include <immintrin.h>
+#endif
+
+namespace ariac_sensors
+{
+
+namespace
+{
+
+using ClampDepthFunction = void (*)(const float *, float *, std::size_t, float, float);
+
+#ifdef ARIAC_DEPTH_CLAMP_X86
+__attribute__((target("sse2")))
+void ClampDepthSSE2(
+  const float * _src, float * _dst, std::size_t _count,
+  float _min_depth, float _max_depth)
+{
+  const __m128 min_depth = _mm_set1_ps(_min_depth);
+  const __m128 max_depth = _mm_set1_ps(_max_depth);
+  const __m128 pos_inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+  const __m128 neg_inf = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+
+  std::size_t i = 0;
+  for (; i + 4 <= _count; i += 4) {
+    __m128 depth = _mm_loadu_ps(_src + i);
+    // Comparisons are ordered, so NaN is neither in range nor below the minimum
+    __m128 in_range = _mm_and_ps(_mm_cmpgt_ps(depth, min_depth), _mm_cmplt_ps(depth, max_depth));
+    __m128 too_close = _mm_cmple_ps(depth, min_depth);
+    __m128 out_of_range = _mm_or_ps(
+      _mm_and_ps(too_close, neg_inf), _mm_andnot_ps(too_close, pos_inf));
+    __m128 result = _mm_or_ps(
+      _mm_and_ps(in_range, depth), _mm_andnot_ps(in_range, out_of_range));
+    _mm_storeu_ps(_dst + i, result);
+  }
+
+  ClampDepthScalar(_src + i, _dst + i, _count - i, _min_depth, _max_depth);
+}
+
+__attribute__((target("avx2")))
+void ClampDepthAVX2(
+  const float * _src, float * _dst, std::size_t _count,
+  float _min_depth, float _max_depth)
+{
+  const __m256 min_depth = _mm256_set1_ps(_min_depth);
+  const __m256 max_depth = _mm256_set1_ps(_max_depth);
+  const __m256 pos_inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+  const __m256 neg_inf = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+
+  std::size_t i = 0;
+  for (; i + 8 <= _count; i += 8) {
+    __m256 depth = _mm256_loadu_ps(_src + i);
+    __m256 in_range = _mm256_and_ps(
+      _mm256_cmp_ps(depth, min_depth, _CMP_GT_OQ), _mm256_cmp_ps(depth, max_depth, _CMP_LT_OQ));
+    __m256 too_close = _mm256_cmp_ps(depth, min_depth, _CMP_LE_OQ);
+    __m256 out_of_range = _mm256_blendv_ps(pos_inf, neg_inf, too_close);
+    _mm256_storeu_ps(_dst + i, _mm256_blendv_ps(out_of_range, depth, in_range));
+  }
+
+  ClampDepthSSE2(_src + i, _dst + i, _count - i, _min_depth, _max_depth);
+}
+#endif
+
+struct ClampDepthDispatch
+{
+  ClampDepthFunction function;
+  const char * name;
+};
+
+ClampDepthDispatch SelectClampDepth()
+{
+#ifdef ARIAC_DEPTH_CLAMP_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {ClampDepthAVX2, "avx2"};
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return {ClampDepthSSE2, "sse2"};
+  }
+#endif
+  return {ClampDepthScalar, "scalar"};
+}
+
+const ClampDepthDispatch & GetClampDepth()
+{
+  static const ClampDepthDispatch dispatch = SelectClampDepth();
+  return dispatch;
+}
+
+}  // namespace
+
+void ClampDepthScalar(
+  const float * _src, float * _dst, std::size_t _count,
+  float _min_depth, float _max_depth)
+{
+  const float pos_inf = std::numeric_limits<float>::infinity();
+  const float neg_inf = -pos_inf;
+
+  for (std::size_t i = 0; i < _count; i++) {
+    float depth = _src[i];
+    if (_min_depth < depth && depth < _max_depth) {
+      _dst[i] = depth;
+    } else if (depth <= _min_depth) {
+      _dst[i] = neg_inf;
+    } else {
+      _dst[i] = pos_inf;
+    }
+  }
+}
+
+void ClampDepth(
+  const float * _src, float * _dst, std::size_t _count,
+  float _min_depth, float _max_depth)
+{
+  GetClampDepth().function(_src, _dst, _count, _min_depth, _max_depth);
+}
+
+const char * ClampDepthImplementation()
+{
+  return GetClampDepth().name;
+}
+
+}  // namespace ariac_sensors
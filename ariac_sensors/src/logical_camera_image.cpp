@@ -0,0 +1,70 @@
+#include <ariac_sensors/logical_camera_image.hpp>
+
+#include <gazebo/msgs/msgs.hh>
+
+#include <gazebo_ros/conversions/geometry_msgs.hpp>
+
+#include <ariac_plugins/model_name_classifier.hpp>
+
+namespace ariac_sensors
+{
+
+namespace
+{
+
+geometry_msgs::msg::Pose ConvertPose(const gazebo::msgs::Pose & _pose)
+{
+  return gazebo_ros::Convert<geometry_msgs::msg::Pose>(gazebo::msgs::ConvertIgn(_pose));
+}
+
+}  // namespace
+
+void FillAdvancedImage(
+  const gazebo::msgs::LogicalCameraImage & _image,
+  ariac_msgs::msg::AdvancedLogicalCameraImage & _msg)
+{
+  _msg.sensor_pose = ConvertPose(_image.pose());
+
+  // clear() keeps the capacity, elements are then built in place
+  _msg.part_poses.clear();
+  _msg.tray_poses.clear();
+
+  for (int i = 0; i < _image.model_size(); i++) {
+    const auto & lc_model = _image.model(i);
+    const auto info = ariac_common::ClassifyModelName(lc_model.name());
+
+    if (info.IsKitTray()) {
+      auto & kit_tray = _msg.tray_poses.emplace_back();
+      kit_tray.id = info.tray_id;
+      kit_tray.pose = ConvertPose(lc_model.pose());
+    } else if (info.IsPart()) {
+      auto & part = _msg.part_poses.emplace_back();
+      part.part.type = info.type;
+      part.part.color = info.color;
+      part.pose = ConvertPose(lc_model.pose());
+    }
+  }
+}
+
+void FillBasicImage(
+  const gazebo::msgs::LogicalCameraImage & _image,
+  ariac_msgs::msg::BasicLogicalCameraImage & _msg)
+{
+  _msg.sensor_pose = ConvertPose(_image.pose());
+
+  _msg.part_poses.clear();
+  _msg.tray_poses.clear();
+
+  for (int i = 0; i < _image.model_size(); i++) {
+    const auto & lc_model = _image.model(i);
+    const auto info = ariac_common::ClassifyModelName(lc_model.name());
+
+    if (info.IsKitTray()) {
+      _msg.tray_poses.push_back(ConvertPose(lc_model.pose()));
+    } else if (info.IsPart()) {
+      _msg.part_poses.push_back(ConvertPose(lc_model.pose()));
+    }
+  }
+}
+
+}  // namespace ariac_sensors
@@ -5,6 +5,8 @@
 #include <unistd.h>
 
 #include <cmath>
+#include <condition_variable>
+#include <mutex>
 
 #include <ament_index_cpp/get_package_share_directory.hpp>
 
@@ -34,6 +36,7 @@
 #include <ariac_msgs/msg/vacuum_gripper_state.hpp>
 #include <ariac_msgs/msg/assembly_state.hpp>
 #include <ariac_msgs/msg/agv_status.hpp>
+#include <ariac_msgs/msg/agv_move_status.hpp>
 
 #include <ariac_msgs/srv/change_gripper.hpp>
 #include <ariac_msgs/srv/vacuum_gripper_control.hpp>
@@ -106,6 +109,18 @@ private:
 
   // AGV location
   std::map<int, int> agv_locations_ = {{1, -1}, {2, -1}, {3, -1}, {4, -1}};
+
+  // AGV moves, written by the move status callbacks and waited on by MoveAGV
+  struct AGVMove
+  {
+    int goal_location = -1;
+    bool started = false;
+    bool finished = false;
+    bool succeeded = false;
+  };
+  std::map<int, AGVMove> agv_moves_;
+  std::mutex agv_moves_mutex_;
+  std::condition_variable agv_moves_cv_;
   
 
   // Callback Groups
@@ -130,6 +145,7 @@ private:
   rclcpp::Subscription<ariac_msgs::msg::AGVStatus>::SharedPtr agv2_status_sub_;
   rclcpp::Subscription<ariac_msgs::msg::AGVStatus>::SharedPtr agv3_status_sub_;
   rclcpp::Subscription<ariac_msgs::msg::AGVStatus>::SharedPtr agv4_status_sub_;
+  std::map<int, rclcpp::Subscription<ariac_msgs::msg::AGVMoveStatus>::SharedPtr> agv_move_status_subs_;
   rclcpp::Subscription<ariac_msgs::msg::CompetitionState>::SharedPtr competition_state_sub_;
   rclcpp::Subscription<ariac_msgs::msg::AdvancedLogicalCameraImage>::SharedPtr kts1_camera_sub_;
   rclcpp::Subscription<ariac_msgs::msg::AdvancedLogicalCameraImage>::SharedPtr kts2_camera_sub_;
@@ -199,6 +215,9 @@ private:
   void agv3_status_cb(const ariac_msgs::msg::AGVStatus::ConstSharedPtr msg);
   void agv4_status_cb(const ariac_msgs::msg::AGVStatus::ConstSharedPtr msg);
 
+  // AGV Move Status Callback
+  void agv_move_status_cb(int agv_num, const ariac_msgs::msg::AGVMoveStatus::ConstSharedPtr msg);
+
   // Orders Callback
   void orders_cb(const ariac_msgs::msg::Order::ConstSharedPtr msg);
 
@@ -82,6 +82,13 @@ TestCompetitor::TestCompetitor()
       "/ariac/agv4_status", 10,
       std::bind(&TestCompetitor::agv4_status_cb, this, std::placeholders::_1), options);
 
+  for (int agv_num = 1; agv_num <= 4; agv_num++)
+  {
+    agv_move_status_subs_[agv_num] = this->create_subscription<ariac_msgs::msg::AGVMoveStatus>(
+        "/ariac/agv" + std::to_string(agv_num) + "_move_status", rclcpp::QoS(1).transient_local(),
+        std::bind(&TestCompetitor::agv_move_status_cb, this, agv_num, std::placeholders::_1), options);
+  }
+
   // Initialize service clients
   quality_checker_ = this->create_client<ariac_msgs::srv::PerformQualityCheck>("/ariac/perform_quality_check");
   pre_assembly_poses_getter_ = this->create_client<ariac_msgs::srv::GetPreAssemblyPoses>("/ariac/get_pre_assembly_poses");
@@ -224,6 +231,29 @@ void TestCompetitor::agv4_status_cb(
   agv_locations_[4] = msg->location;
 }
 
+void TestCompetitor::agv_move_status_cb(
+    int agv_num, const ariac_msgs::msg::AGVMoveStatus::ConstSharedPtr msg)
+{
+  std::lock_guard<std::mutex> lock(agv_moves_mutex_);
+
+  // Ignore the latched status of an earlier move and moves to other locations
+  auto &move = agv_moves_[agv_num];
+  if (move.finished || msg->goal_location != move.goal_location)
+    return;
+
+  if (msg->state == ariac_msgs::msg::AGVMoveStatus::MOVING)
+  {
+    move.started = true;
+  }
+  else if (move.started && (msg->state == ariac_msgs::msg::AGVMoveStatus::SUCCEEDED ||
+                            msg->state == ariac_msgs::msg::AGVMoveStatus::PREEMPTED))
+  {
+    move.finished = true;
+    move.succeeded = msg->state == ariac_msgs::msg::AGVMoveStatus::SUCCEEDED;
+    agv_moves_cv_.notify_all();
+  }
+}
+
 geometry_msgs::msg::Pose TestCompetitor::MultiplyPose(
     geometry_msgs::msg::Pose p1, geometry_msgs::msg::Pose p2)
 {
@@ -1561,8 +1591,38 @@ bool TestCompetitor::MoveAGV(int agv_num, int destination)
   auto request = std::make_shared<ariac_msgs::srv::MoveAGV::Request>();
   request->location = destination;
 
+  // Reset before sending, the move status reports MOVING before the service returns
+  {
+    std::lock_guard<std::mutex> lock(agv_moves_mutex_);
+    agv_moves_[agv_num] = AGVMove();
+    agv_moves_[agv_num].goal_location = destination;
+  }
+
   auto result = client->async_send_request(request);
   result.wait();
 
-  return result.get()->success;
+  if (!result.get()->success)
+    return false;
+
+  // The service returns once the move has started, wait for the AGV to stop at its destination
+  std::unique_lock<std::mutex> lock(agv_moves_mutex_);
+  rclcpp::Time start = now();
+  while (!agv_moves_[agv_num].finished)
+  {
+    agv_moves_cv_.wait_for(lock, std::chrono::milliseconds(100));
+
+    if (now() - start > rclcpp::Duration::from_seconds(30.0))
+    {
+      RCLCPP_ERROR_STREAM(get_logger(), "AGV " << agv_num << " did not reach its destination");
+      return false;
+    }
+  }
+
+  if (!agv_moves_[agv_num].succeeded)
+  {
+    RCLCPP_ERROR_STREAM(get_logger(), "Move of AGV " << agv_num << " was preempted");
+    return false;
+  }
+
+  return true;
 }
\ No newline at end of file